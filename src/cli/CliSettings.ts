@@ -0,0 +1,116 @@
+// CLI Settings - RunnerSettings backed by command line options
+import * as os from 'os';
+import * as path from 'path';
+import { ExtensionConfiguration, RunnerSettings } from '../types';
+import { FileUtils } from '../utils/fileUtils';
+
+export interface CliOptions {
+  root: string;
+  clangTidyPath: string;
+  compileCommandsPath?: string;
+  checks: string;
+  headerFilter: string;
+  extraArgs: string[];
+  jobs?: number;
+  cacheDirectory?: string;
+  remoteCache?: string;
+  remoteCacheUpload?: boolean;
+  remoteCacheToken?: string;
+  compileDbPolicy?: ExtensionConfiguration['compileDatabase']['policy'];
+  extraCompileCommands?: string[];
+  keepCompileFlags?: boolean;
+  rewriteRules?: string[];
+  precompiledHeaders?: boolean;
+  unityBatchSize?: number;
+  generatedHeaders?: 'off' | 'delay' | 'generate';
+  noCheckDelta?: boolean;
+  tiers?: boolean;
+  slowChecks?: string[];
+  checkProfiles?: string;
+  maxPerTranslationUnit?: number;
+  maxPerFileCheck?: number;
+}
+
+export class CliSettings implements RunnerSettings {
+  private compileCommandsPath: string | null = null;
+
+  constructor(private options: CliOptions) {}
+
+  getClangTidyPath(): string {
+    return this.options.clangTidyPath;
+  }
+
+  getCompileCommandsPath(): string {
+    if (this.compileCommandsPath === null) {
+      this.compileCommandsPath = this.options.compileCommandsPath
+        ? path.resolve(this.options.root, this.options.compileCommandsPath)
+        : FileUtils.findCompileCommands(this.options.root) || path.join(this.options.root, 'compile_commands.json');
+    }
+    return this.compileCommandsPath;
+  }
+
+  getChecks(): string {
+    return this.options.checks;
+  }
+
+  getHeaderFilter(): string {
+    return this.options.headerFilter;
+  }
+
+  getExtraArgs(): string[] {
+    return this.options.extraArgs;
+  }
+
+  /**
+   * Unlike the extension, the CLI does not cap the job count: CI machines may have many cores
+   */
+  getParallelJobs(): number {
+    return Math.max(1, this.options.jobs || os.cpus().length);
+  }
+
+  getCacheConfig(): ExtensionConfiguration['cache'] {
+    return {
+      enabled: !!this.options.cacheDirectory || !!this.options.remoteCache,
+      directory: this.options.cacheDirectory ? path.resolve(this.options.root, this.options.cacheDirectory) : '',
+      remote: this.options.remoteCache || '',
+      remoteUpload: !!this.options.remoteCacheUpload,
+      remoteToken: this.options.remoteCacheToken || '',
+      checkDelta: !this.options.noCheckDelta
+    };
+  }
+
+  getCompileDatabaseConfig(): ExtensionConfiguration['compileDatabase'] {
+    return {
+      policy: this.options.compileDbPolicy || 'canonical',
+      additionalPaths: (this.options.extraCompileCommands || []).map(file => path.resolve(this.options.root, file)),
+      rewrite: !this.options.keepCompileFlags,
+      rewriteRules: this.options.rewriteRules || [],
+      precompiledHeaders: !!this.options.precompiledHeaders,
+      unityBatchSize: this.options.unityBatchSize || 0,
+      generatedHeaders: this.options.generatedHeaders || 'off'
+    };
+  }
+
+  getTierConfig(): ExtensionConfiguration['tiers'] {
+    return {
+      enabled: !!this.options.tiers,
+      slowChecks: this.options.slowChecks || [],
+      profileDirectory: this.options.checkProfiles ? path.resolve(this.options.root, this.options.checkProfiles) : ''
+    };
+  }
+
+  getDiagnosticLimits(): ExtensionConfiguration['limits'] {
+    return {
+      maxDiagnosticsPerTranslationUnit: this.options.maxPerTranslationUnit ?? 10000,
+      maxDiagnosticsPerFileCheck: this.options.maxPerFileCheck ?? 1000
+    };
+  }
+
+  getWorkspaceRoot(): string | null {
+    return this.options.root;
+  }
+
+  resolvePath(filePath: string): string {
+    return path.resolve(this.options.root, filePath.replace(/\${workspaceFolder}/g, this.options.root));
+  }
+}
@@ -0,0 +1,85 @@
+// Command Line Arguments - Minimal parser for the ctv CLI
+export interface ParsedArgs {
+  command: string;
+  positionals: string[];
+  options: Map<string, string[]>;
+}
+
+/**
+ * Parse "ctv <command> [--name value | --name=value | --flag] [positionals...]"
+ * @param booleanFlags Options that never take a value
+ * @param aliases Short option names mapped to long names (e.g. p -> compile-commands)
+ */
+export function parseArgs(argv: string[], booleanFlags: string[] = [], aliases: Record<string, string> = {}): ParsedArgs {
+  const options = new Map<string, string[]>();
+  const positionals: string[] = [];
+  let command = '';
+
+  const add = (name: string, value: string) => {
+    const values = options.get(name);
+    if (values) {
+      values.push(value);
+    } else {
+      options.set(name, [value]);
+    }
+  };
+
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+
+    if (arg === '--') {
+      positionals.push(...argv.slice(i + 1));
+      break;
+    }
+
+    const match = /^--?([^=]+)(?:=(.*))?$/.exec(arg);
+    if (match && arg !== '-') {
+      const name = aliases[match[1]] || match[1];
+      if (match[2] !== undefined) {
+        add(name, match[2]);
+      } else if (booleanFlags.includes(name)) {
+        add(name, 'true');
+      } else if (i + 1 < argv.length) {
+        add(name, argv[++i]);
+      } else {
+        throw new Error(`Missing value for option ${arg}`);
+      }
+    } else if (!command) {
+      command = arg;
+    } else {
+      positionals.push(arg);
+    }
+  }
+
+  return { command, positionals, options };
+}
+
+/**
+ * Get the last value of an option
+ */
+export function getOption(args: ParsedArgs, name: string): string | undefined {
+  const values = args.options.get(name);
+  return values ? values[values.length - 1] : undefined;
+}
+
+/**
+ * Get all values of a repeatable option
+ */
+export function getOptions(args: ParsedArgs, name: string): string[] {
+  return args.options.get(name) || [];
+}
+
+/**
+ * Get a numeric option
+ */
+export function getNumberOption(args: ParsedArgs, name: string): number | undefined {
+  const value = getOption(args, name);
+  if (value === undefined) {
+    return undefined;
+  }
+  const parsed = Number(value);
+  if (!Number.isFinite(parsed)) {
+    throw new Error(`Option --${name} expects a number, got '${value}'`);
+  }
+  return parsed;
+}
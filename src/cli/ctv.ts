@@ -0,0 +1,629 @@
+// ctv - Headless command line entry point (bundled as dist/cli.js)
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import { ClangTidyRunner } from '../core/runner/ClangTidyRunner';
+import { AnalysisEngine } from '../core/engine/AnalysisEngine';
+import { FileDiscovery } from '../core/engine/FileDiscovery';
+import { ReportExporter, ExportFormat } from '../core/reporter/ReportExporter';
+import { RunOptions, ReportData, ClangTidyDiagnostic } from '../types';
+import { logger, LogLevel } from '../utils/logger';
+import { FileUtils } from '../utils/fileUtils';
+import { ProcessUtils } from '../utils/processUtils';
+import { CostHistory } from '../core/history/CostHistory';
+import { Sharding } from '../core/engine/Sharding';
+import { Sampling } from '../core/engine/Sampling';
+import { Snapshot, AnalysisSnapshot } from '../core/engine/Snapshot';
+import { RemoteWorker } from '../remote/RemoteWorker';
+import { WorkerAgent } from '../remote/WorkerAgent';
+import { CacheServer } from '../remote/CacheServer';
+import { parseAddress } from '../remote/protocol';
+import { RunJournal } from '../core/journal/RunJournal';
+import { NinjaGraph } from '../core/compiledb/NinjaGraph';
+import { CheckTiers } from '../core/engine/CheckTiers';
+import { FailureGate, FailOn } from '../core/engine/FailureGate';
+import { TextParser } from '../core/parser/TextParser';
+import { Scheduler } from '../core/runner/Scheduler';
+import { ReplayTiming, TraceRecorder, TraceReplayer } from '../core/runner/RunTrace';
+import { CliOptions, CliSettings } from './CliSettings';
+import { ParsedArgs, parseArgs, getOption, getOptions, getNumberOption } from './args';
+
+const USAGE = `Usage: ctv <command> [options]
+
+Commands:
+  run [paths...]             Analyze files (default: every file in the compile database)
+  merge <snapshots...>       Combine partial snapshots from sharded runs into one report
+  worker                     Serve analysis jobs for coordinators on other machines
+  cache-server               Serve a shared result cache over HTTP (GET/PUT by key)
+
+Options for run:
+  -p, --compile-commands <file>  compile_commands.json (default: searched below --root)
+  --compile-db-policy <policy>   canonical, distinct or union: which compile commands of a file to analyze (default: canonical)
+  --compile-commands-extra <file> Further compile database for the union policy, e.g. a Release build (repeatable)
+  --keep-compile-flags           Pass compile commands unchanged (default: strip flags irrelevant to analysis)
+  --rewrite-rule <rule>          Compile command rewrite: "regex" removes, "regex => replacement" rewrites (repeatable)
+  --pch                          Precompile third-party headers shared by TUs with identical flags (needs clang next to clang-tidy)
+  --generated-headers <mode>     off, delay or generate: handling of TUs whose ninja-generated headers are missing (default: off)
+  --tiers                        Run cheap checks first and expensive ones (clang-analyzer-*, dataflow) at background priority
+  --slow-check <glob>            Put further checks in the slow tier (repeatable)
+  --check-profiles <dir>         Derive slow checks from clang-tidy --store-check-profile output
+  --unity <n>                    Merge up to n small TUs with identical flags into one analysis (default: off)
+  --root <dir>                   Project root and working directory (default: current directory)
+  --clang-tidy <path>            clang-tidy executable (default: clang-tidy)
+  -j, --jobs <n>                 Parallel clang-tidy processes (default: CPU count)
+  --cache <dir>                  Persistent result cache directory
+  --remote-cache <url|dir>       Team-shared cache: http(s) store or shared directory
+  --remote-cache-upload          Upload new results to the shared cache
+  --no-check-delta               Rerun all checks of changed configurations instead of only added or changed ones
+  --remote-cache-token <secret>  Bearer token for the shared HTTP cache
+  --out <dir>                    Write the report into this directory
+  --format <html,json>           Report formats (default: html,json)
+  --checks <globs>               Checks when the project has no .clang-tidy
+  --header-filter <regex>        Header filter
+  --extra-arg <arg>              Extra clang-tidy argument (repeatable)
+  --cap-per-tu <n>               Keep at most n diagnostics per translation unit and only count the rest (default: 10000, 0: no cap)
+  --cap-per-check <n>            Keep at most n diagnostics per file and check (default: 1000, 0: no cap)
+  --fail-on <none|error|warning> Exit with 1 if diagnostics of this severity exist (default: none)
+  --fatal-check <glob>           Also exit with 1 on diagnostics of these checks, whatever their severity (repeatable)
+  --fail-fast                    Stop at the first failing diagnostic, running likely offenders first (default --fail-on: error)
+  --shard <i/N>                  Analyze only shard i (1-based) of N, balanced by historical cost
+  --sample <size>                Analyze a stratified sample (e.g. 2%) and estimate totals per check and directory
+  --sample-seed <n>              Seed of the sample (default: 1)
+  --snapshot <file>              Write a mergeable snapshot (default with --out: <out>/snapshot.json)
+  --history <file>               Cost history used for balancing (default: <cache>/history.json)
+  --journal <file>               Record progress; an interrupted run with the same files resumes from it
+  --worker <host:port>           Also run jobs on this worker agent (repeatable)
+  --worker-token <secret>        Token expected by the workers
+  --remote-min-cost <ms>         Keep TUs estimated below this cost local (default: 200)
+  --record <file>                Record every clang-tidy execution (command, timing, exit status, output) into a gzip trace
+  --replay <file>                Replay a recorded trace through scheduling, parsing and reporting instead of running clang-tidy
+  --replay-timing <mode>         recorded or none: replay executions with their recorded durations or at once (default: recorded)
+  --log-level <level>            error, warn, info or debug (default: warn)
+  --quiet                        Do not print progress
+
+Options for merge:
+  --root, --out, --format, --snapshot, --history, --fail-on, --fatal-check as for run
+
+Options for worker:
+  --listen <host:port>           Address to listen on (default: 127.0.0.1:7878)
+  -j, --jobs <n>                 Slots offered to coordinators (default: CPU count)
+  --clang-tidy <path>            clang-tidy executable (default: clang-tidy)
+  --path-map <from=to>           Map coordinator path prefixes onto this machine (repeatable)
+  --token <secret>               Require coordinators to present this token
+
+Options for cache-server:
+  --listen <host:port>           Address to listen on (default: 127.0.0.1:8787)
+  --dir <dir>                    Storage directory (required)
+  --token <secret>               Require this bearer token for uploads
+  --read-token                   Also require the token for lookups
+
+Sharded CI example (every runner needs the same file list and history file):
+  ctv run --shard 3/16 --cache .ctv-cache --snapshot shard-3.json
+  ctv merge shard-*.json --history .ctv-cache/history.json --out report/
+`;
+
+const BOOLEAN_FLAGS = ['quiet', 'help', 'remote-cache-upload', 'read-token', 'keep-compile-flags', 'pch', 'tiers', 'no-check-delta', 'fail-fast'];
+const ALIASES: Record<string, string> = { p: 'compile-commands', j: 'jobs', h: 'help' };
+
+/**
+ * ctv run
+ */
+async function runCommand(args: ParsedArgs): Promise<number> {
+  const root = path.resolve(getOption(args, 'root') || process.cwd());
+  const policy = getOption(args, 'compile-db-policy') || 'canonical';
+  if (!['canonical', 'distinct', 'union'].includes(policy)) {
+    process.stderr.write(`ctv: unknown compile database policy: ${policy}\n`);
+    return 2;
+  }
+  const generatedHeaders = getOption(args, 'generated-headers') || 'off';
+  if (!['off', 'delay', 'generate'].includes(generatedHeaders)) {
+    process.stderr.write(`ctv: unknown generated headers mode: ${generatedHeaders}\n`);
+    return 2;
+  }
+  const failFast = getOption(args, 'fail-fast') === 'true';
+  const failOn = getOption(args, 'fail-on') || (failFast ? 'error' : 'none');
+  if (!['none', 'error', 'warning'].includes(failOn)) {
+    process.stderr.write(`ctv: unknown --fail-on severity: ${failOn}\n`);
+    return 2;
+  }
+  const gate = new FailureGate(failOn as FailOn, getOptions(args, 'fatal-check'), failFast);
+  const cliOptions: CliOptions = {
+    root,
+    clangTidyPath: getOption(args, 'clang-tidy') || 'clang-tidy',
+    compileCommandsPath: getOption(args, 'compile-commands'),
+    checks: getOption(args, 'checks') || '*',
+    headerFilter: getOption(args, 'header-filter') || '',
+    extraArgs: getOptions(args, 'extra-arg'),
+    jobs: getNumberOption(args, 'jobs'),
+    cacheDirectory: getOption(args, 'cache'),
+    remoteCache: getOption(args, 'remote-cache'),
+    remoteCacheUpload: getOption(args, 'remote-cache-upload') === 'true',
+    remoteCacheToken: getOption(args, 'remote-cache-token'),
+    noCheckDelta: getOption(args, 'no-check-delta') === 'true',
+    compileDbPolicy: policy as CliOptions['compileDbPolicy'],
+    extraCompileCommands: getOptions(args, 'compile-commands-extra'),
+    keepCompileFlags: getOption(args, 'keep-compile-flags') === 'true',
+    rewriteRules: getOptions(args, 'rewrite-rule'),
+    precompiledHeaders: getOption(args, 'pch') === 'true',
+    unityBatchSize: getNumberOption(args, 'unity'),
+    generatedHeaders: generatedHeaders as CliOptions['generatedHeaders'],
+    tiers: getOption(args, 'tiers') === 'true',
+    slowChecks: getOptions(args, 'slow-check'),
+    checkProfiles: getOption(args, 'check-profiles'),
+    maxPerTranslationUnit: getNumberOption(args, 'cap-per-tu'),
+    maxPerFileCheck: getNumberOption(args, 'cap-per-check')
+  };
+  const settings = new CliSettings(cliOptions);
+
+  const runner = new ClangTidyRunner(settings);
+  const recordPath = getOption(args, 'record');
+  const replayPath = getOption(args, 'replay');
+  const replayTiming = getOption(args, 'replay-timing') || 'recorded';
+  if (!['recorded', 'none'].includes(replayTiming)) {
+    process.stderr.write(`ctv: unknown replay timing: ${replayTiming}\n`);
+    return 2;
+  }
+  if (recordPath && replayPath) {
+    process.stderr.write('ctv: --record and --replay cannot be combined\n');
+    return 2;
+  }
+  let replayer: TraceReplayer | null = null;
+  if (replayPath) {
+    try {
+      replayer = TraceReplayer.load(path.resolve(root, replayPath), Scheduler.getInstance(), replayTiming as ReplayTiming);
+    } catch (error) {
+      process.stderr.write(`ctv: cannot read trace ${replayPath}: ${error instanceof Error ? error.message : String(error)}\n`);
+      return 2;
+    }
+    runner.setExecutor(replayer);
+  } else if (!(await runner.checkClangTidyAvailable())) {
+    process.stderr.write(`ctv: clang-tidy not found: ${settings.getClangTidyPath()}\n`);
+    return 2;
+  }
+
+  // A replay analyzes the recorded files unless told otherwise
+  const allFiles = replayer && args.positionals.length === 0 ? replayer.getHeader().files : discoverFiles(args.positionals, settings);
+  if (allFiles.length === 0) {
+    process.stderr.write('ctv: no C/C++ files to analyze\n');
+    return 2;
+  }
+
+  // Build times from .ninja_log stand in for files without recorded analysis costs
+  const buildGraph = NinjaGraph.find(settings.getCompileCommandsPath());
+  const history = openHistory(args, root);
+  const estimator = history ? history.getEstimator(buildGraph ? file => buildGraph.getBuildTime(file) : undefined) : null;
+  if (estimator) {
+    runner.setCostEstimator(estimator);
+  }
+
+  const workerAddresses = replayer ? [] : getOptions(args, 'worker');
+  if (workerAddresses.length > 0) {
+    const token = getOption(args, 'worker-token');
+    const workers: RemoteWorker[] = [];
+    for (const address of workerAddresses) {
+      try {
+        workers.push(await RemoteWorker.connect(address, token));
+      } catch (error) {
+        process.stderr.write(`ctv: warning: worker ${address} unavailable: ${error instanceof Error ? error.message : String(error)}\n`);
+      }
+    }
+    runner.useRemoteWorkers(workers, { minRemoteCostMs: getNumberOption(args, 'remote-min-cost') ?? 200 });
+  }
+  const recorder = recordPath ? runner.wrapExecutor(executor => new TraceRecorder(executor)) : null;
+  const shardSpec = getOption(args, 'shard');
+  const shard = shardSpec ? Sharding.parse(shardSpec) : undefined;
+  const sampleSpec = getOption(args, 'sample');
+  if (shard && sampleSpec) {
+    process.stderr.write('ctv: --sample and --shard cannot be combined\n');
+    return 2;
+  }
+  // Without history, source size stands in for the cost of a file
+  const samplePlan = sampleSpec
+    ? Sampling.select(allFiles, root, Sampling.parseFraction(sampleSpec), estimator || fileSize, getNumberOption(args, 'sample-seed') ?? 1)
+    : null;
+  let files = shard
+    ? Sharding.select(allFiles, shard, estimator || (() => 1))
+    : samplePlan ? Sampling.files(samplePlan) : allFiles;
+  // Files that failed last time run first, cheap ones before expensive ones
+  if (failFast) {
+    files = gate.orderByLikelyFailure(files, file => history?.getFindings(file), estimator || (() => 1));
+  }
+  if (shard) {
+    process.stderr.write(`ctv: shard ${shard.index}/${shard.count}: ${files.length} of ${allFiles.length} files\n`);
+  } else if (samplePlan) {
+    process.stderr.write(`ctv: sample of ${files.length} of ${allFiles.length} files in ${samplePlan.strata.length} directories\n`);
+  }
+
+  const quiet = getOption(args, 'quiet') === 'true' || !process.stderr.isTTY;
+  const options: RunOptions = {
+    checks: settings.getChecks(),
+    headerFilter: settings.getHeaderFilter(),
+    parallel: true,
+    outputFormat: 'text',
+    extraArgs: settings.getExtraArgs()
+  };
+
+  // The journal records results per file, which a run in two tiers does not map onto
+  const tiered = settings.getTierConfig().enabled;
+  const journal = tiered ? undefined : openJournal(args, root, files, options, journalSettings(cliOptions));
+
+  const engine = new AnalysisEngine(runner);
+  const onProgress = (completed: number, total: number) => {
+    if (!quiet) {
+      process.stderr.write(`\r[${completed}/${total}] analyzing...`);
+    }
+  };
+  const outcome = tiered
+    ? await CheckTiers.run((tierOptions, tierProgress) => engine.analyze(files, tierOptions, tierProgress, undefined, gate), options, onProgress, fast => {
+      if (!quiet) {
+        process.stderr.write(`\nctv: fast checks done (${fast.reportData.totalWarnings} diagnostics), slow checks still running\n`);
+      }
+    })
+    : await engine.analyze(files, options, onProgress, journal, gate);
+  if (!quiet) {
+    process.stderr.write('\n');
+  }
+  if (journal) {
+    journal.finish();
+  }
+  if (recorder) {
+    recorder.save(path.resolve(root, recordPath!), {
+      clangTidyVersion: runner.getClangTidyVersion(),
+      root,
+      compileCommands: settings.getCompileCommandsPath(),
+      jobs: settings.getParallelJobs(),
+      files,
+      options,
+      // Everything but the token, so a replay can rebuild the same translation units
+      settings: { ...cliOptions, remoteCacheToken: undefined }
+    });
+    process.stderr.write(`ctv: recorded ${recorder.getRecords().length} clang-tidy executions to ${recordPath}\n`);
+  }
+  if (replayer) {
+    process.stderr.write(`ctv: replayed trace of a run that took ${(replayer.getRecordedMakespan() / 1000).toFixed(1)}s\n`);
+    replayer.dispose();
+  }
+
+  if (samplePlan) {
+    outcome.reportData.sampling = Sampling.estimate(samplePlan, outcome.diagnostics);
+  }
+  const snapshot = Snapshot.fromOutcome(root, files, outcome, shard);
+  if (history) {
+    const textParser = new TextParser();
+    for (const result of outcome.results) {
+      const findings = textParser.parseClangTidyText(result.rawOutput);
+      result.files.forEach(file => {
+        // Cached results carry the time of the run that produced them; a unit's time is shared by its files
+        if (!result.cached) {
+          history.recordCost(file, result.duration / result.files.length);
+        }
+        history.recordFindings(file, findings);
+      });
+    }
+    // A stopped run says nothing about the time of a full one
+    if (!shard && !samplePlan && !outcome.failure) {
+      history.recordRun(summarize(snapshot));
+    }
+    history.save();
+  }
+
+  const outputDir = getOption(args, 'out');
+  await writeOutputs(args, outcome.reportData, snapshot,
+    getOption(args, 'snapshot') || (shard && !outputDir ? `snapshot-${shard.index}-of-${shard.count}.json` : undefined));
+
+  await runner.flushCache();
+  const cacheStats = runner.getCacheStats();
+  const report = outcome.reportData;
+  process.stdout.write(
+    `Analyzed ${files.length} files in ${(outcome.duration / 1000).toFixed(1)}s: ` +
+    `${report.totalWarnings} diagnostics in ${report.filesWithWarnings} files` +
+    (cacheStats ? ` (cache: ${cacheStats.hits} hits, ${cacheStats.misses} misses, ${cacheStats.remoteHits} fetched from shared cache)` : '') + '\n'
+  );
+  const suppressed = Object.values(report.suppressed || {}).reduce((sum, checks) => sum + Object.values(checks).reduce((a, b) => a + b, 0), 0);
+  if (suppressed > 0) {
+    process.stdout.write(`${suppressed} further diagnostics over the caps were counted but not kept (--cap-per-tu, --cap-per-check)\n`);
+  }
+  if (report.sampling) {
+    const total = report.sampling.total;
+    process.stdout.write(`Sampled ${report.sampling.sampledFiles} of ${report.sampling.totalFiles} files, ` +
+      `about ${(report.sampling.costShare * 100).toFixed(1)}% of the full run's cost (requested ${(report.sampling.fraction * 100).toFixed(1)}%)\n`);
+    process.stdout.write(`Estimated ${total.estimate} diagnostics in all ${report.sampling.totalFiles} files (95% CI ${total.low}-${total.high})` +
+      (report.sampling.headerDiagnostics > 0 ? `, plus ${report.sampling.headerDiagnostics} found in headers` : '') + '\n');
+  }
+
+  if (outcome.failure) {
+    const failure = outcome.failure;
+    process.stdout.write(`Stopped after ${outcome.results.length} translation units at ` +
+      `${failure.filePath}:${failure.line}:${failure.column}: ${failure.severity}: ${failure.message} [${failure.checkName}]\n`);
+    return 1;
+  }
+
+  if (outcome.exitCode !== 0 && !outcome.rawOutput.trim()) {
+    process.stderr.write(`ctv: clang-tidy failed:\n${outcome.errorOutput}\n`);
+    return 2;
+  }
+  // Units that failed without output (crashed, or skipped for missing generated headers) were never analyzed
+  const unanswered = outcome.results.filter(result => result.exitCode !== 0 && !result.rawOutput.trim());
+  if (unanswered.length > 0) {
+    process.stderr.write(`ctv: ${unanswered.length} translation units were not analyzed:\n` +
+      unanswered.map(result => result.errorOutput.trim() || result.files.join(', ')).join('\n') + '\n');
+    return 2;
+  }
+
+  return gate.fails(outcome.diagnostics) ? 1 : 0;
+}
+
+/**
+ * ctv merge
+ */
+async function mergeCommand(args: ParsedArgs): Promise<number> {
+  if (args.positionals.length === 0) {
+    process.stderr.write('ctv: merge needs at least one snapshot file\n');
+    return 2;
+  }
+
+  const root = path.resolve(getOption(args, 'root') || process.cwd());
+  const partials = args.positionals.map(file => Snapshot.read(path.resolve(file)));
+  const merged = Snapshot.merge(partials, root);
+
+  const shardIndexes = partials.filter(partial => partial.shard).map(partial => partial.shard!.index);
+  const expected = partials.find(partial => partial.shard)?.shard?.count;
+  if (expected && new Set(shardIndexes).size !== expected) {
+    process.stderr.write(`ctv: warning: merging ${new Set(shardIndexes).size} of ${expected} shards\n`);
+  }
+
+  const diagnostics = Snapshot.absoluteDiagnostics(merged, root);
+  const reportData = AnalysisEngine.buildReportData(diagnostics, merged.files.length);
+  if (merged.suppressed) {
+    reportData.suppressed = Object.fromEntries(Object.entries(merged.suppressed).map(([file, checks]) => [Snapshot.absolutize(root, file), checks]));
+  }
+
+  const history = openHistory(args, root);
+  if (history) {
+    for (const [file, duration] of Object.entries(merged.durations)) {
+      history.recordCost(Snapshot.absolutize(root, file), duration);
+    }
+    history.recordRun({ ...summarize(merged), shards: partials.length });
+    history.save();
+  }
+
+  await writeOutputs(args, reportData, merged, getOption(args, 'snapshot'));
+
+  process.stdout.write(
+    `Merged ${partials.length} snapshots: ${merged.files.length} files, ` +
+    `${reportData.totalWarnings} diagnostics in ${reportData.filesWithWarnings} files\n`
+  );
+  return exitCodeFor(args, diagnostics);
+}
+
+/**
+ * ctv worker
+ */
+async function workerCommand(args: ParsedArgs): Promise<number> {
+  const clangTidyPath = getOption(args, 'clang-tidy') || 'clang-tidy';
+  const version = await ProcessUtils.executeCommand(clangTidyPath, ['--version']).catch(() => null);
+  if (!version || version.exitCode !== 0) {
+    process.stderr.write(`ctv: clang-tidy not found: ${clangTidyPath}\n`);
+    return 2;
+  }
+
+  const listen = parseAddress(getOption(args, 'listen') || '127.0.0.1');
+  const agent = new WorkerAgent({
+    host: listen.host,
+    port: listen.port,
+    slots: getNumberOption(args, 'jobs') || os.cpus().length,
+    clangTidyPath,
+    toolVersion: version.stdout.trim(),
+    pathMappings: getOptions(args, 'path-map'),
+    token: getOption(args, 'token')
+  });
+  const port = await agent.start();
+  process.stderr.write(`ctv: worker listening on ${listen.host}:${port}\n`);
+
+  // Serve until interrupted
+  return new Promise(resolve => {
+    const stop = () => {
+      agent.stop();
+      resolve(0);
+    };
+    process.once('SIGINT', stop);
+    process.once('SIGTERM', stop);
+  });
+}
+
+/**
+ * ctv cache-server
+ */
+async function cacheServerCommand(args: ParsedArgs): Promise<number> {
+  const directory = getOption(args, 'dir');
+  if (!directory) {
+    process.stderr.write('ctv: cache-server needs --dir\n');
+    return 2;
+  }
+
+  const listen = parseAddress(getOption(args, 'listen') || '127.0.0.1:8787');
+  const server = new CacheServer({
+    host: listen.host,
+    port: listen.port,
+    directory: path.resolve(directory),
+    token: getOption(args, 'token'),
+    readToken: getOption(args, 'read-token') === 'true'
+  });
+  const port = await server.start();
+  process.stderr.write(`ctv: cache server listening on http://${listen.host}:${port}/\n`);
+
+  return new Promise(resolve => {
+    const stop = () => {
+      server.stop();
+      resolve(0);
+    };
+    process.once('SIGINT', stop);
+    process.once('SIGTERM', stop);
+  });
+}
+
+/**
+ * Resume the journal named by --journal if it belongs to the same file list and settings, or start a new one
+ */
+function openJournal(args: ParsedArgs, root: string, files: string[], options: RunOptions, settings: Record<string, unknown>): RunJournal | undefined {
+  const journalPath = getOption(args, 'journal');
+  if (!journalPath) {
+    return undefined;
+  }
+  const resolved = path.resolve(root, journalPath);
+  const previous = RunJournal.open(resolved);
+  if (previous) {
+    const header = previous.getHeader();
+    const sameFiles = header.files.length === files.length && header.files.every((file, index) => file === files[index]);
+    // Results of other checks, flags or configuration cannot be merged with this run's
+    const sameSettings = JSON.stringify(header.options) === JSON.stringify(options) &&
+      JSON.stringify(header.settings) === JSON.stringify(settings);
+    if (sameFiles && sameSettings) {
+      process.stderr.write(`ctv: resuming interrupted run (${files.length - previous.getRemaining().length} of ${files.length} files done)\n`);
+      return previous;
+    }
+    if (sameFiles) {
+      process.stderr.write('ctv: discarding interrupted run recorded with different options\n');
+    }
+    previous.close();
+  }
+  return RunJournal.create(resolved, 'cli', files, options, settings);
+}
+
+/**
+ * Settings besides the run options that change what clang-tidy reports, and the project's .clang-tidy
+ */
+function journalSettings(options: CliOptions): Record<string, unknown> {
+  let config: string | null = null;
+  try {
+    config = fs.readFileSync(path.join(options.root, '.clang-tidy'), 'utf8');
+  } catch (error) {
+    // No project configuration
+  }
+  return {
+    clangTidyPath: options.clangTidyPath,
+    compileCommandsPath: options.compileCommandsPath,
+    compileDbPolicy: options.compileDbPolicy,
+    extraCompileCommands: options.extraCompileCommands,
+    keepCompileFlags: options.keepCompileFlags,
+    rewriteRules: options.rewriteRules,
+    precompiledHeaders: options.precompiledHeaders,
+    unityBatchSize: options.unityBatchSize,
+    generatedHeaders: options.generatedHeaders,
+    maxPerTranslationUnit: options.maxPerTranslationUnit,
+    maxPerFileCheck: options.maxPerFileCheck,
+    config
+  };
+}
+
+/**
+ * Open the cost history named by --history, or the one inside --cache
+ */
+function openHistory(args: ParsedArgs, root: string): CostHistory | null {
+  const historyPath = getOption(args, 'history') || (getOption(args, 'cache') ? path.join(getOption(args, 'cache')!, 'history.json') : undefined);
+  return historyPath ? new CostHistory(path.resolve(root, historyPath), root) : null;
+}
+
+/**
+ * Run summary for the history
+ */
+function summarize(snapshot: AnalysisSnapshot) {
+  return {
+    timestamp: snapshot.createdAt,
+    files: snapshot.files.length,
+    diagnostics: snapshot.diagnostics.length,
+    wallTimeMs: snapshot.wallTimeMs,
+    cpuTimeMs: Object.values(snapshot.durations).reduce((sum, value) => sum + value, 0)
+  };
+}
+
+/**
+ * Write the report (--out) and the snapshot
+ */
+async function writeOutputs(args: ParsedArgs, reportData: ReportData, snapshot: AnalysisSnapshot, snapshotPath?: string): Promise<void> {
+  const outputDir = getOption(args, 'out');
+  if (outputDir) {
+    const formats = (getOption(args, 'format') || 'html,json').split(',').map(format => format.trim()) as ExportFormat[];
+    await ReportExporter.exportTo(path.resolve(outputDir), reportData, { style: 'modern', includeCharts: true }, formats);
+  }
+
+  const target = snapshotPath || (outputDir ? path.join(outputDir, 'snapshot.json') : undefined);
+  if (target) {
+    Snapshot.write(path.resolve(target), snapshot);
+  }
+}
+
+function fileSize(file: string): number {
+  try {
+    return fs.statSync(file).size;
+  } catch (error) {
+    return 1;
+  }
+}
+
+/**
+ * Exit code according to --fail-on and --fatal-check
+ */
+function exitCodeFor(args: ParsedArgs, diagnostics: ClangTidyDiagnostic[]): number {
+  const gate = new FailureGate((getOption(args, 'fail-on') || 'none') as FailOn, getOptions(args, 'fatal-check'), false);
+  return gate.fails(diagnostics) ? 1 : 0;
+}
+
+/**
+ * Expand positional files and directories, or fall back to the compile database
+ */
+function discoverFiles(positionals: string[], settings: CliSettings): string[] {
+  if (positionals.length === 0) {
+    const compileCommandsPath = settings.getCompileCommandsPath();
+    if (!FileUtils.exists(compileCommandsPath)) {
+      process.stderr.write(`ctv: compile database not found: ${compileCommandsPath}\n`);
+      return [];
+    }
+    return FileDiscovery.fromCompileDatabase(compileCommandsPath);
+  }
+
+  const files: string[] = [];
+  for (const positional of positionals) {
+    const resolved = path.resolve(settings.getWorkspaceRoot() || process.cwd(), positional);
+    if (fs.existsSync(resolved) && fs.statSync(resolved).isDirectory()) {
+      files.push(...FileDiscovery.fromDirectory(resolved));
+    } else {
+      files.push(resolved);
+    }
+  }
+  return files;
+}
+
+const COMMANDS: Record<string, (args: ParsedArgs) => Promise<number>> = {
+  run: runCommand,
+  merge: mergeCommand,
+  worker: workerCommand,
+  'cache-server': cacheServerCommand
+};
+
+async function main(argv: string[]): Promise<number> {
+  let args: ParsedArgs;
+  try {
+    args = parseArgs(argv, BOOLEAN_FLAGS, ALIASES);
+  } catch (error) {
+    process.stderr.write(`ctv: ${error instanceof Error ? error.message : String(error)}\n${USAGE}`);
+    return 2;
+  }
+
+  const handler = COMMANDS[args.command];
+  if (!handler || getOption(args, 'help') === 'true') {
+    process.stdout.write(USAGE);
+    return handler || args.command === 'help' || !args.command ? 0 : 2;
+  }
+
+  logger.setLogLevel((getOption(args, 'log-level') || 'warn') as LogLevel);
+  return handler(args);
+}
+
+main(process.argv.slice(2)).then(
+  code => process.exit(code),
+  error => {
+    process.stderr.write(`ctv: ${error instanceof Error ? error.stack || error.message : String(error)}\n`);
+    process.exit(2);
+  }
+);
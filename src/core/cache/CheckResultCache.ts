@@ -0,0 +1,224 @@
+// Check Result Cache - Per-check results of translation units, so configuration changes only rerun the affected checks
+import * as crypto from 'crypto';
+import * as fs from 'fs';
+import * as path from 'path';
+import { ProcessResult } from '../../utils/processUtils';
+import { logger } from '../../utils/logger';
+import { ResultCache } from './ResultCache';
+
+// Bump when the stored entry format changes
+const CHECK_CACHE_FORMAT_VERSION = 2;
+// Compiler diagnostics come with every run, whatever checks it had
+const COMPILER_KEY = 'clang-diagnostic';
+
+// Enabled checks of a configuration with a fingerprint of each check's options
+export interface CheckSet {
+  checks: Record<string, string>;
+  // Fingerprint of the options affecting every check (header filter, global options, ...)
+  global: string;
+}
+
+interface CheckEntry {
+  version: number;
+  checks: Record<string, string>;
+  // Output blocks (diagnostic with its notes and source lines) per check
+  blocks: Record<string, string[]>;
+  compiler: string[];
+  exitCode: number;
+}
+
+export class CheckResultCache {
+  private memory = new Map<string, CheckEntry>();
+
+  /**
+   * @param directory Optional directory for persistent entries; memory only when omitted
+   */
+  constructor(private directory: string | null = null, private maxMemoryEntries: number = 5000) {}
+
+  /**
+   * Fingerprint every enabled check from the output of `clang-tidy --dump-config`.
+   * Options are "<check>.<name>: value" (or key/value pairs in older versions); options without
+   * a check prefix and the other top-level settings apply to all checks.
+   */
+  static checkSet(enabled: string[], dumpedConfig: string): CheckSet {
+    const options: Array<[string, string]> = [];
+    const global: string[] = [];
+    let inOptions = false;
+    let pendingKey: string | null = null;
+    for (const line of dumpedConfig.split('\n')) {
+      if (/^\S/.test(line)) {
+        inOptions = line.startsWith('CheckOptions:');
+        if (!inOptions && !line.startsWith('Checks:') && !line.startsWith('---') && !line.startsWith('...')) {
+          global.push(line.trim());
+        }
+        continue;
+      }
+      if (!inOptions) {
+        continue;
+      }
+      const keyValue = /^\s*-?\s*key:\s*(.+)$/.exec(line);
+      const value = /^\s*value:\s*(.*)$/.exec(line);
+      const mapping = /^\s+([\w.-]+):\s*(.*)$/.exec(line);
+      if (keyValue) {
+        pendingKey = keyValue[1].trim();
+      } else if (value && pendingKey) {
+        options.push([pendingKey, value[1].trim()]);
+        pendingKey = null;
+      } else if (mapping) {
+        options.push([mapping[1], mapping[2].trim()]);
+      }
+    }
+
+    const hash = (parts: string[]) => crypto.createHash('sha256').update(parts.join('\n')).digest('hex').substring(0, 16);
+    const globalOptions = options.filter(([key]) => !key.includes('.')).map(pair => pair.join(': '));
+    const checks: Record<string, string> = {};
+    for (const check of enabled) {
+      checks[check] = hash(options.filter(([key]) => key.startsWith(check + '.')).map(pair => pair.join(': ')).sort());
+    }
+    return { checks, global: hash([...global, ...globalOptions.sort()]) };
+  }
+
+  /**
+   * Split clang-tidy output into blocks by check. A block is a warning or error with the notes and
+   * source lines following it; blocks naming several checks (aliases) are listed under each.
+   */
+  static splitOutput(stdout: string): Map<string, string[]> {
+    const blocks = new Map<string, string[]>();
+    let current: string[] | null = null;
+    let owners: string[] = [COMPILER_KEY];
+    const flush = () => {
+      if (current && current.length > 0) {
+        const text = current.join('\n');
+        owners.forEach(owner => blocks.set(owner, [...(blocks.get(owner) || []), text]));
+      }
+    };
+
+    for (const line of stdout.split('\n')) {
+      const header = /^.+?:\d+:\d+: (warning|error|fatal error): .*?(?: \[([^\]]+)\])?\s*$/.exec(line);
+      if (header) {
+        flush();
+        const names = (header[2] || '').split(',').filter(name => name && !name.startsWith('-'));
+        owners = names.length > 0 && !names[0].startsWith('clang-diagnostic-') ? names : [COMPILER_KEY];
+        current = [line];
+      } else if (current) {
+        current.push(line);
+      } else if (line.trim()) {
+        current = [line];
+      }
+    }
+    flush();
+    return blocks;
+  }
+
+  /**
+   * Look up a translation unit. Returns the assembled result if every enabled check is cached with
+   * its current options, otherwise the checks that have to run (all of them without an entry).
+   * Output is stored with paths relative to the workspace root and resolved against root.
+   */
+  lookup(key: string, set: CheckSet, root?: string): { result?: ProcessResult; missing: string[] } {
+    const entry = this.load(key);
+    const enabled = Object.keys(set.checks);
+    if (!entry) {
+      return { missing: enabled };
+    }
+    const missing = enabled.filter(check => entry.checks[check] !== set.checks[check]);
+    return missing.length > 0 ? { missing } : { result: { ...this.assemble(entry, set, 0, root), cached: true }, missing };
+  }
+
+  /**
+   * Store the results of a run of some checks and return the result for all enabled checks.
+   * Results of checks no longer enabled are dropped. A crashed run is not stored: checks it did not
+   * get to would otherwise count as clean.
+   */
+  record(key: string, set: CheckSet, ranChecks: string[], result: ProcessResult, root?: string): ProcessResult {
+    const previous = this.load(key);
+    const entry: CheckEntry = { version: CHECK_CACHE_FORMAT_VERSION, checks: {}, blocks: {}, compiler: [], exitCode: result.exitCode };
+    for (const check of Object.keys(set.checks)) {
+      if (previous && !ranChecks.includes(check) && previous.checks[check] === set.checks[check]) {
+        entry.checks[check] = previous.checks[check];
+        entry.blocks[check] = previous.blocks[check] || [];
+      }
+    }
+
+    const blocks = CheckResultCache.splitOutput(ResultCache.relativize(result.stdout, root));
+    for (const check of ranChecks) {
+      entry.checks[check] = set.checks[check];
+      entry.blocks[check] = blocks.get(check) || [];
+    }
+    // A run of only some checks does not measure the cost of the whole set, and may have been
+    // narrowed without the compiler warnings; the same source and flags give the same ones
+    const partial = Object.keys(set.checks).some(check => !ranChecks.includes(check));
+    if (partial && previous) {
+      entry.compiler = previous.compiler;
+      entry.exitCode = previous.exitCode || result.exitCode;
+    } else {
+      entry.compiler = blocks.get(COMPILER_KEY) || [];
+    }
+
+    if (ResultCache.isCacheable(result)) {
+      this.store(key, entry);
+    }
+    return { ...this.assemble(entry, set, result.duration, root), stderr: result.stderr, cached: partial || result.cached };
+  }
+
+  private assemble(entry: CheckEntry, set: CheckSet, duration: number, root?: string): ProcessResult {
+    const seen = new Set<string>();
+    const output: string[] = [];
+    for (const block of [...entry.compiler, ...Object.keys(set.checks).flatMap(check => entry.blocks[check] || [])]) {
+      if (!seen.has(block)) {
+        seen.add(block);
+        output.push(block);
+      }
+    }
+    const stdout = output.length > 0 ? output.join('\n') + '\n' : '';
+    return { stdout: ResultCache.absolutize(stdout, root), stderr: '', exitCode: entry.exitCode, duration };
+  }
+
+  private load(key: string): CheckEntry | undefined {
+    const inMemory = this.memory.get(key);
+    if (inMemory || !this.directory) {
+      return inMemory;
+    }
+    try {
+      const entry: CheckEntry = JSON.parse(fs.readFileSync(this.entryPath(key), 'utf8'));
+      if (entry.version === CHECK_CACHE_FORMAT_VERSION) {
+        this.remember(key, entry);
+        return entry;
+      }
+    } catch (error) {
+      // Missing or unreadable entry is a miss
+    }
+    return undefined;
+  }
+
+  private store(key: string, entry: CheckEntry): void {
+    this.remember(key, entry);
+    if (!this.directory) {
+      return;
+    }
+    const entryPath = this.entryPath(key);
+    const tempPath = `${entryPath}.${process.pid}.tmp`;
+    try {
+      fs.mkdirSync(path.dirname(entryPath), { recursive: true });
+      fs.writeFileSync(tempPath, JSON.stringify(entry), 'utf8');
+      fs.renameSync(tempPath, entryPath);
+    } catch (error) {
+      logger.warn(`Failed to write check cache entry ${key}: ${error instanceof Error ? error.message : String(error)}`);
+    }
+  }
+
+  private remember(key: string, entry: CheckEntry): void {
+    this.memory.delete(key);
+    this.memory.set(key, entry);
+    if (this.memory.size > this.maxMemoryEntries) {
+      const oldest = this.memory.keys().next().value;
+      if (oldest !== undefined) {
+        this.memory.delete(oldest);
+      }
+    }
+  }
+
+  private entryPath(key: string): string {
+    return path.join(this.directory!, key.substring(0, 2), key + '.json');
+  }
+}
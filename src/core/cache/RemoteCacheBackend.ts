@@ -0,0 +1,171 @@
+// Remote Cache Backends - Team-shared storage for result cache entries
+import * as fs from 'fs';
+import * as http from 'http';
+import * as https from 'https';
+import * as path from 'path';
+import { ProcessResult } from '../../utils/processUtils';
+import { CACHE_FORMAT_VERSION } from './ResultCache';
+
+// Entries are stored as {version, result}, the same layout as the local cache directory
+interface StoredEntry {
+  version: number;
+  result: ProcessResult;
+}
+
+const KEY_PATTERN = /^[0-9a-f]{64}$/;
+
+export interface RemoteCacheBackend {
+  /**
+   * Look up several keys at once; missing keys are absent from the result
+   */
+  getMany(keys: string[]): Promise<Map<string, ProcessResult>>;
+
+  /**
+   * Store one entry
+   */
+  put(key: string, result: ProcessResult): Promise<void>;
+
+  /**
+   * Human readable location, for logs
+   */
+  describe(): string;
+}
+
+/**
+ * Shared directory (e.g. an NFS mount) using the local cache layout dir/ab/<key>.json
+ */
+export class DirectoryCacheBackend implements RemoteCacheBackend {
+  constructor(private directory: string) {}
+
+  async getMany(keys: string[]): Promise<Map<string, ProcessResult>> {
+    const found = new Map<string, ProcessResult>();
+    await Promise.all(keys.map(async key => {
+      try {
+        const entry = JSON.parse(await fs.promises.readFile(this.entryPath(key), 'utf8')) as StoredEntry;
+        if (entry.version === CACHE_FORMAT_VERSION) {
+          found.set(key, entry.result);
+        }
+      } catch (error) {
+        // Missing or unreadable entry is a miss
+      }
+    }));
+    return found;
+  }
+
+  async put(key: string, result: ProcessResult): Promise<void> {
+    const entryPath = this.entryPath(key);
+    // Unique temp name: several machines may write the same key at once
+    const tempPath = `${entryPath}.${process.pid}.${Date.now()}.tmp`;
+    await fs.promises.mkdir(path.dirname(entryPath), { recursive: true });
+    await fs.promises.writeFile(tempPath, JSON.stringify({ version: CACHE_FORMAT_VERSION, result }), 'utf8');
+    await fs.promises.rename(tempPath, entryPath);
+  }
+
+  describe(): string {
+    return this.directory;
+  }
+
+  private entryPath(key: string): string {
+    return path.join(this.directory, key.substring(0, 2), key + '.json');
+  }
+}
+
+/**
+ * Content-addressed HTTP store: GET/PUT <base>/<key>.
+ * Lookups use POST <base>/batch ({keys} -> {entries}) when the server supports it,
+ * and fall back to one GET per key for plain stores.
+ */
+export class HttpCacheBackend implements RemoteCacheBackend {
+  private batchSupported = true;
+  private agent: http.Agent;
+
+  constructor(private baseUrl: string, private token?: string, private maxParallelRequests: number = 16) {
+    this.baseUrl = baseUrl.replace(/\/+$/, '');
+    this.agent = baseUrl.startsWith('https:')
+      ? new https.Agent({ keepAlive: true, maxSockets: maxParallelRequests })
+      : new http.Agent({ keepAlive: true, maxSockets: maxParallelRequests });
+  }
+
+  async getMany(keys: string[]): Promise<Map<string, ProcessResult>> {
+    const found = new Map<string, ProcessResult>();
+    const valid = keys.filter(key => KEY_PATTERN.test(key));
+
+    if (this.batchSupported) {
+      const response = await this.request('POST', '/batch', JSON.stringify({ keys: valid }));
+      if (response.status === 200) {
+        const entries = (JSON.parse(response.body).entries || {}) as Record<string, StoredEntry>;
+        for (const [key, entry] of Object.entries(entries)) {
+          if (entry && entry.version === CACHE_FORMAT_VERSION) {
+            found.set(key, entry.result);
+          }
+        }
+        return found;
+      }
+      if (response.status !== 404 && response.status !== 405) {
+        throw new Error(`Batch lookup failed with HTTP ${response.status}`);
+      }
+      this.batchSupported = false;
+    }
+
+    // The agent limits concurrent connections
+    await Promise.all(valid.map(async key => {
+      const response = await this.request('GET', '/' + key);
+      if (response.status === 200) {
+        const entry = JSON.parse(response.body) as StoredEntry;
+        if (entry.version === CACHE_FORMAT_VERSION) {
+          found.set(key, entry.result);
+        }
+      }
+    }));
+    return found;
+  }
+
+  async put(key: string, result: ProcessResult): Promise<void> {
+    const response = await this.request('PUT', '/' + key, JSON.stringify({ version: CACHE_FORMAT_VERSION, result }));
+    if (response.status < 200 || response.status >= 300) {
+      throw new Error(`HTTP ${response.status}`);
+    }
+  }
+
+  describe(): string {
+    return this.baseUrl;
+  }
+
+  private request(method: string, urlPath: string, body?: string): Promise<{ status: number; body: string }> {
+    const url = new URL(this.baseUrl + urlPath);
+    const transport = url.protocol === 'https:' ? https : http;
+    const headers: http.OutgoingHttpHeaders = {};
+    if (body !== undefined) {
+      headers['Content-Type'] = 'application/json';
+      headers['Content-Length'] = Buffer.byteLength(body);
+    }
+    if (this.token) {
+      headers['Authorization'] = `Bearer ${this.token}`;
+    }
+
+    return new Promise((resolve, reject) => {
+      const req = transport.request(url, { method, headers, agent: this.agent, timeout: 30000 }, res => {
+        let data = '';
+        res.setEncoding('utf8');
+        res.on('data', chunk => data += chunk);
+        res.on('end', () => resolve({ status: res.statusCode || 0, body: data }));
+      });
+      req.on('timeout', () => req.destroy(new Error(`Request to ${url.host} timed out`)));
+      req.on('error', reject);
+      if (body !== undefined) {
+        req.write(body);
+      }
+      req.end();
+    });
+  }
+}
+
+/**
+ * Create a backend from a URL (http/https) or a directory path
+ */
+export function createRemoteBackend(location: string, token?: string): RemoteCacheBackend {
+  if (/^https?:\/\//.test(location)) {
+    return new HttpCacheBackend(location, token);
+  }
+  return new DirectoryCacheBackend(location.replace(/^file:\/\//, ''));
+}
@@ -0,0 +1,237 @@
+// Result Cache - Content-addressed store of per-TU clang-tidy results
+import * as crypto from 'crypto';
+import * as fs from 'fs';
+import * as path from 'path';
+import { ProcessResult } from '../../utils/processUtils';
+import { logger } from '../../utils/logger';
+import type { RemoteCacheBackend } from './RemoteCacheBackend';
+
+// Bump when the stored entry format changes
+export const CACHE_FORMAT_VERSION = 2;
+// Stands for the workspace root in keys and stored output, so clones at other paths share entries
+const ROOT_PLACEHOLDER = '${workspaceRoot}';
+
+export class ResultCache {
+  private memory = new Map<string, ProcessResult>();
+  private hits = 0;
+  private misses = 0;
+  private remote: RemoteCacheBackend | null = null;
+  private uploadToRemote = false;
+  // Keys already looked up remotely, and lookups still in flight
+  private remoteChecked = new Set<string>();
+  private prefetching = new Map<string, Promise<void>>();
+  private uploads = new Set<Promise<void>>();
+  private remoteHits = 0;
+
+  /**
+   * @param directory Optional directory for persistent entries; memory only when omitted
+   * @param maxMemoryEntries Upper bound of entries kept in memory (least recently used are evicted)
+   */
+  constructor(private directory: string | null = null, private maxMemoryEntries: number = 20000) {
+    if (directory && !fs.existsSync(directory)) {
+      fs.mkdirSync(directory, { recursive: true });
+    }
+  }
+
+  /**
+   * Compute a cache key from everything that influences a result
+   */
+  static computeKey(parts: string[]): string {
+    const hash = crypto.createHash('sha256');
+    hash.update(String(CACHE_FORMAT_VERSION));
+    for (const part of parts) {
+      hash.update('\0' + part);
+    }
+    return hash.digest('hex');
+  }
+
+  /**
+   * Text with paths below the workspace root written relative to a placeholder
+   */
+  static relativize(text: string, root: string | undefined): string {
+    return root ? text.replace(ResultCache.rootPattern(root), ROOT_PLACEHOLDER) : text;
+  }
+
+  /**
+   * Inverse of relativize for a (possibly different) workspace root
+   */
+  static absolutize(text: string, root: string | undefined): string {
+    return root ? text.split(ROOT_PLACEHOLDER).join(root.replace(/[\\/]+$/, '')) : text;
+  }
+
+  private static rootPattern(root: string): RegExp {
+    const escaped = root.replace(/[\\/]+$/, '').replace(/[.*+?^${}()|[\]\\]/g, '\\$&');
+    // Only whole path components: the root of /src/app is not a prefix of /src/app2
+    return new RegExp(escaped + '(?![\\w.+~-])', 'g');
+  }
+
+  /**
+   * Whether a result is worth caching. Crashes (ended by a signal, or exit codes from 128 up, which is
+   * also how Windows reports exceptions) are retried next time even if they printed partial output,
+   * as are failures without any output (missing executables, broken compile commands).
+   */
+  static isCacheable(result: ProcessResult): boolean {
+    const crashed = result.signal !== undefined || result.exitCode >= 128 || result.exitCode < 0;
+    return !crashed && (result.exitCode === 0 || result.stdout.length > 0);
+  }
+
+  /**
+   * Share results through a remote backend. With upload disabled the remote is only read,
+   * e.g. developers reusing results produced by CI.
+   */
+  setRemote(backend: RemoteCacheBackend, upload: boolean): void {
+    this.remote = backend;
+    this.uploadToRemote = upload;
+  }
+
+  /**
+   * Fetch entries missing locally from the remote backend in one batch.
+   * Fetched entries are kept in memory and in the local directory.
+   */
+  prefetch(keys: string[]): Promise<void> {
+    if (!this.remote) {
+      return Promise.resolve();
+    }
+
+    const missing = keys.filter(key => !this.remoteChecked.has(key) && !this.memory.has(key) &&
+      !(this.directory && fs.existsSync(this.entryPath(key))));
+    if (missing.length === 0) {
+      return Promise.resolve();
+    }
+    missing.forEach(key => this.remoteChecked.add(key));
+
+    const request = this.remote.getMany(missing)
+      .then(found => {
+        for (const [key, result] of found) {
+          this.remoteHits++;
+          this.remember(key, result);
+          this.writeEntry(key, result);
+        }
+      })
+      .catch(error => logger.warn(`Remote cache lookup failed: ${error instanceof Error ? error.message : String(error)}`))
+      .finally(() => missing.forEach(key => this.prefetching.delete(key)));
+
+    missing.forEach(key => this.prefetching.set(key, request));
+    return request;
+  }
+
+  /**
+   * Look up a result, waiting for an in-flight prefetch of the key or asking the remote backend
+   */
+  async lookup(key: string, root?: string): Promise<ProcessResult | undefined> {
+    const pending = this.prefetching.get(key);
+    if (pending) {
+      await pending;
+    } else if (this.remote && !this.remoteChecked.has(key)) {
+      await this.prefetch([key]);
+    }
+    return this.get(key, root);
+  }
+
+  /**
+   * Wait for outstanding remote uploads
+   */
+  async flush(): Promise<void> {
+    await Promise.all(Array.from(this.uploads));
+  }
+
+  /**
+   * Look up a result; paths stored relative to the workspace root are resolved against root
+   */
+  get(key: string, root?: string): ProcessResult | undefined {
+    const entry = this.getStored(key);
+    return entry && { ...entry, stdout: ResultCache.absolutize(entry.stdout, root), stderr: ResultCache.absolutize(entry.stderr, root), cached: true };
+  }
+
+  private getStored(key: string): ProcessResult | undefined {
+    const inMemory = this.memory.get(key);
+    if (inMemory) {
+      // Refresh LRU position
+      this.memory.delete(key);
+      this.memory.set(key, inMemory);
+      this.hits++;
+      return inMemory;
+    }
+
+    if (this.directory) {
+      try {
+        const entry = JSON.parse(fs.readFileSync(this.entryPath(key), 'utf8'));
+        if (entry.version === CACHE_FORMAT_VERSION) {
+          this.remember(key, entry.result);
+          this.hits++;
+          return entry.result;
+        }
+      } catch (error) {
+        // Missing or unreadable entry is a miss
+      }
+    }
+
+    this.misses++;
+    return undefined;
+  }
+
+  /**
+   * Store a result, with paths below root stored relative to it
+   */
+  set(key: string, result: ProcessResult, root?: string): void {
+    if (!ResultCache.isCacheable(result)) {
+      return;
+    }
+    result = { ...result, stdout: ResultCache.relativize(result.stdout, root), stderr: ResultCache.relativize(result.stderr, root), cached: undefined };
+
+    this.remember(key, result);
+    this.writeEntry(key, result);
+
+    if (this.remote && this.uploadToRemote) {
+      const upload: Promise<void> = this.remote.put(key, result)
+        .catch(error => logger.warn(`Failed to upload cache entry ${key}: ${error instanceof Error ? error.message : String(error)}`))
+        .finally(() => this.uploads.delete(upload));
+      this.uploads.add(upload);
+    }
+  }
+
+  /**
+   * Get hit/miss counters; remoteHits counts entries fetched from the remote backend
+   */
+  getStats(): { hits: number; misses: number; memoryEntries: number; remoteHits: number } {
+    return { hits: this.hits, misses: this.misses, memoryEntries: this.memory.size, remoteHits: this.remoteHits };
+  }
+
+  /**
+   * Drop all in-memory entries
+   */
+  clear(): void {
+    this.memory.clear();
+    this.remoteChecked.clear();
+  }
+
+  private writeEntry(key: string, result: ProcessResult): void {
+    if (!this.directory) {
+      return;
+    }
+    const entryPath = this.entryPath(key);
+    const tempPath = `${entryPath}.${process.pid}.tmp`;
+    try {
+      fs.mkdirSync(path.dirname(entryPath), { recursive: true });
+      // Write-then-rename keeps concurrent readers from seeing partial entries
+      fs.writeFileSync(tempPath, JSON.stringify({ version: CACHE_FORMAT_VERSION, result }), 'utf8');
+      fs.renameSync(tempPath, entryPath);
+    } catch (error) {
+      logger.warn(`Failed to write cache entry ${key}: ${error instanceof Error ? error.message : String(error)}`);
+    }
+  }
+
+  private remember(key: string, result: ProcessResult): void {
+    this.memory.set(key, result);
+    if (this.memory.size > this.maxMemoryEntries) {
+      const oldest = this.memory.keys().next().value;
+      if (oldest !== undefined) {
+        this.memory.delete(oldest);
+      }
+    }
+  }
+
+  private entryPath(key: string): string {
+    return path.join(this.directory!, key.substring(0, 2), key + '.json');
+  }
+}
@@ -0,0 +1,132 @@
+// Command Rewriter - Strips compile flags that only cost time (or break) in clang-tidy's frontend
+import * as path from 'path';
+import { CompileCommand } from './CompileDatabase';
+import { logger } from '../../utils/logger';
+
+export type CompilerDriver = 'gcc' | 'clang' | 'cl';
+
+interface RewriteRule {
+  pattern: RegExp;
+  // Flags taking their value as the following argument, which goes too
+  separateValue?: string[];
+  replacement?: string;
+}
+
+// Flags without effect on preprocessing or semantic analysis: debug info, code layout, LTO, coverage,
+// dependency files and precompiled headers. Optimization (__OPTIMIZE__, _FORTIFY_SOURCE), sanitizer
+// (__SANITIZE_ADDRESS__, __has_feature) and stack protector (__SSP__) flags define macros and stay.
+const GNU_RULES: RewriteRule[] = [
+  { pattern: /^-g(\d|gdb|dwarf.*|split-dwarf|line-tables-only|column-info)?$/ },
+  { pattern: /^-f(no-)?(lto|whole-program-vtables|function-sections|data-sections|debug-.*|split-lto-unit)(=.*)?$/ },
+  { pattern: /^(-fprofile-.*|-fcoverage-.*|--coverage|-ftest-coverage|-fcs-profile-generate.*)$/ },
+  { pattern: /^-M(D|MD|F|T|Q)$/, separateValue: ['-MF', '-MT', '-MQ'] },
+  { pattern: /^-M[FTQ].+$/ },
+  { pattern: /^-flto-jobs=.*$/ },
+  { pattern: /^-Winvalid-pch$/ }
+];
+
+const CLANG_RULES: RewriteRule[] = [
+  ...GNU_RULES,
+  { pattern: /^-include-pch$/, separateValue: ['-include-pch'] },
+  { pattern: /^-fpch-.*$/ }
+];
+
+// clang-cl defines __OPTIMIZE__ for /O flags and __MSVC_RUNTIME_CHECKS for /RTC, so those stay too
+const CL_RULES: RewriteRule[] = [
+  { pattern: /^[/-](Z[i7I]|FS|Gy|GL|Gw|JMC|MP\d*|guard:.*|errorReport:.*|diagnostics:.*)$/ },
+  { pattern: /^[/-]F[dpaAmeoRS].*$/ },
+  { pattern: /^[/-]Y[cuX-].*$/ }
+];
+
+const BUILTIN_RULES: Record<CompilerDriver, RewriteRule[]> = { gcc: GNU_RULES, clang: CLANG_RULES, cl: CL_RULES };
+
+const COMPILER_WRAPPERS = ['ccache', 'sccache', 'distcc', 'icecc'];
+
+export class CommandRewriter {
+  private userRules: RewriteRule[];
+  private rewritten = new WeakMap<CompileCommand, CompileCommand>();
+
+  /**
+   * @param userRules "regex" removes matching arguments, "regex => replacement" rewrites them
+   * @param builtin Apply the built-in rule set of the entry's driver
+   */
+  constructor(userRules: string[] = [], private builtin: boolean = true) {
+    this.userRules = userRules.flatMap(rule => {
+      const [pattern, replacement] = rule.split(/\s*=>\s*/, 2);
+      try {
+        return [{ pattern: new RegExp(pattern), replacement }];
+      } catch (error) {
+        logger.warn(`Ignoring invalid compile command rewrite rule "${rule}": ${error instanceof Error ? error.message : String(error)}`);
+        return [];
+      }
+    });
+  }
+
+  /**
+   * Driver family of a command, looking through compiler launchers such as ccache
+   */
+  static detectDriver(args: string[]): CompilerDriver {
+    let index = 0;
+    while (index < args.length - 1 && COMPILER_WRAPPERS.includes(CommandRewriter.toolName(args[index]))) {
+      index++;
+    }
+    const tool = CommandRewriter.toolName(args[index] || '');
+    if (tool === 'cl' || tool === 'clang-cl' || args.includes('--driver-mode=cl')) {
+      return 'cl';
+    }
+    return tool.includes('clang') ? 'clang' : 'gcc';
+  }
+
+  /**
+   * Rewrite an entry; the same entry object is rewritten once
+   */
+  rewrite(entry: CompileCommand): CompileCommand {
+    const cached = this.rewritten.get(entry);
+    if (cached) {
+      return cached;
+    }
+
+    const rules = [...(this.builtin ? BUILTIN_RULES[CommandRewriter.detectDriver(entry.arguments)] : []), ...this.userRules];
+    const args: string[] = [entry.arguments[0]];
+    let changed = false;
+    for (let i = 1; i < entry.arguments.length; i++) {
+      const arg = entry.arguments[i];
+      // Never touch the source file itself
+      if (arg === entry.file || path.normalize(path.isAbsolute(arg) ? arg : path.join(entry.directory, arg)) === entry.file) {
+        args.push(arg);
+        continue;
+      }
+      // -Xclang forwards the next argument to cc1; the pair goes when that argument would be removed
+      const forwarded = arg === '-Xclang' && i + 1 < entry.arguments.length;
+      const target = forwarded ? entry.arguments[i + 1] : arg;
+      const rule = rules.find(candidate => candidate.pattern.test(target));
+      if (!rule || (forwarded && rule.replacement !== undefined)) {
+        args.push(arg);
+        continue;
+      }
+      changed = true;
+      if (forwarded) {
+        i++;
+        // -Xclang -include-pch -Xclang <file>
+        if (rule.separateValue && rule.separateValue.includes(target) && entry.arguments[i + 1] === '-Xclang') {
+          i += 2;
+        }
+      } else if (rule.replacement !== undefined) {
+        const replaced = arg.replace(rule.pattern, rule.replacement);
+        if (replaced) {
+          args.push(replaced);
+        }
+      } else if (rule.separateValue && rule.separateValue.includes(arg)) {
+        i++;
+      }
+    }
+
+    const result = changed ? { ...entry, arguments: args } : entry;
+    this.rewritten.set(entry, result);
+    return result;
+  }
+
+  private static toolName(arg: string): string {
+    return path.basename(arg.replace(/\\/g, '/')).toLowerCase().replace(/\.exe$/, '').replace(/-\d+(\.\d+)*$/, '');
+  }
+}
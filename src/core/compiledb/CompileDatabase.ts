@@ -0,0 +1,173 @@
+// Compile Database - Loads and indexes compile_commands.json
+import * as fs from 'fs';
+import * as path from 'path';
+import { logger } from '../../utils/logger';
+
+// A single compile database entry with normalized paths and tokenized arguments
+export interface CompileCommand {
+  directory: string;
+  file: string;
+  arguments: string[];
+  output?: string;
+}
+
+export class CompileDatabase {
+  private static loaded = new Map<string, { stamp: string; database: CompileDatabase }>();
+
+  private entries: CompileCommand[];
+  private byFile = new Map<string, CompileCommand[]>();
+
+  constructor(entries: CompileCommand[], public readonly sourcePath: string = '') {
+    this.entries = entries;
+    for (const entry of entries) {
+      const key = CompileDatabase.normalizeKey(entry.file);
+      const list = this.byFile.get(key);
+      if (list) {
+        list.push(entry);
+      } else {
+        this.byFile.set(key, [entry]);
+      }
+    }
+  }
+
+  /**
+   * Load a compile database, reusing the parsed copy while the file is unchanged
+   */
+  static load(filePath: string): CompileDatabase {
+    const stat = fs.statSync(filePath);
+    const stamp = `${stat.mtimeMs}:${stat.size}`;
+    const cached = this.loaded.get(filePath);
+    if (cached && cached.stamp === stamp) {
+      return cached.database;
+    }
+
+    const raw = JSON.parse(fs.readFileSync(filePath, 'utf8'));
+    if (!Array.isArray(raw)) {
+      throw new Error(`Invalid compile database (expected array): ${filePath}`);
+    }
+
+    const entries: CompileCommand[] = [];
+    for (const item of raw) {
+      if (!item || typeof item.file !== 'string' || typeof item.directory !== 'string') {
+        continue;
+      }
+      const args: string[] = Array.isArray(item.arguments)
+        ? item.arguments.map(String)
+        : this.splitCommand(String(item.command || ''));
+      const file = path.normalize(path.isAbsolute(item.file) ? item.file : path.join(item.directory, item.file));
+      entries.push({
+        directory: item.directory,
+        file,
+        arguments: args,
+        output: typeof item.output === 'string' ? item.output : undefined
+      });
+    }
+
+    logger.debug(`Loaded ${entries.length} compile commands from ${filePath}`);
+    const database = new CompileDatabase(entries, filePath);
+    this.loaded.set(filePath, { stamp, database });
+    return database;
+  }
+
+  /**
+   * Get all entries in file order
+   */
+  getEntries(): CompileCommand[] {
+    return this.entries;
+  }
+
+  /**
+   * Get every entry compiling the given file
+   */
+  getEntriesForFile(file: string): CompileCommand[] {
+    return this.byFile.get(CompileDatabase.normalizeKey(file)) || [];
+  }
+
+  /**
+   * Get the first entry compiling the given file
+   */
+  getEntry(file: string): CompileCommand | undefined {
+    return this.getEntriesForFile(file)[0];
+  }
+
+  /**
+   * Get the distinct source files in the database
+   */
+  getFiles(): string[] {
+    return Array.from(this.byFile.values(), list => list[0].file);
+  }
+
+  /**
+   * Resolve include search directories (-I, -iquote, -isystem, /I) of an entry
+   */
+  static getIncludeDirs(entry: CompileCommand): string[] {
+    const dirs: string[] = [];
+    const args = entry.arguments;
+    for (let i = 0; i < args.length; i++) {
+      const arg = args[i];
+      const match = /^(-I|\/I|-iquote|-isystem|-idirafter)(.*)$/.exec(arg);
+      if (!match) {
+        continue;
+      }
+      const value = match[2] || args[++i];
+      if (value) {
+        dirs.push(path.isAbsolute(value) ? value : path.join(entry.directory, value));
+      }
+    }
+    return dirs;
+  }
+
+  /**
+   * Split a shell command line into arguments.
+   * Windows-style commands keep backslashes literal, like the cl.exe entries CMake writes.
+   */
+  static splitCommand(command: string): string[] {
+    const windowsStyle = /^\s*"?[a-zA-Z]:\\/.test(command) || /\bcl(\.exe)?\s/i.test(command);
+    const args: string[] = [];
+    let current = '';
+    let inToken = false;
+    let quote: string | null = null;
+
+    for (let i = 0; i < command.length; i++) {
+      const ch = command[i];
+      if (quote) {
+        if (ch === quote) {
+          quote = null;
+        } else if (ch === '\\' && !windowsStyle && quote === '"' && i + 1 < command.length && '"\\$`'.includes(command[i + 1])) {
+          current += command[++i];
+        } else if (ch === '\\' && windowsStyle && command[i + 1] === '"') {
+          current += command[++i];
+        } else {
+          current += ch;
+        }
+      } else if (ch === '"' || (ch === '\'' && !windowsStyle)) {
+        quote = ch;
+        inToken = true;
+      } else if (ch === '\\' && !windowsStyle && i + 1 < command.length) {
+        current += command[++i];
+        inToken = true;
+      } else if (/\s/.test(ch)) {
+        if (inToken) {
+          args.push(current);
+          current = '';
+          inToken = false;
+        }
+      } else {
+        current += ch;
+        inToken = true;
+      }
+    }
+    if (inToken) {
+      args.push(current);
+    }
+    return args;
+  }
+
+  /**
+   * Lookup key for a file path (case-insensitive on Windows)
+   */
+  private static normalizeKey(file: string): string {
+    const normalized = path.normalize(file);
+    return process.platform === 'win32' ? normalized.toLowerCase() : normalized;
+  }
+}
@@ -0,0 +1,180 @@
+// Compile Unit Resolver - Decides which compile commands of a file are analyzed
+import * as path from 'path';
+import { CompileCommand, CompileDatabase } from './CompileDatabase';
+
+// canonical: one representative command per file
+// distinct: every distinct flag set of a file
+// union: one command per database (e.g. Debug and Release), identical flag sets merged
+export type CompileDbPolicy = 'canonical' | 'distinct' | 'union';
+
+export interface NamedDatabase {
+  name: string;
+  database: CompileDatabase;
+}
+
+// One clang-tidy run: a file compiled with one specific command
+export interface AnalysisUnit {
+  file: string;
+  entry?: CompileCommand;
+  // Configuration label for results; only set when a file may be analyzed more than once
+  configuration?: string;
+  // The entry must be passed on its own, because the database clang-tidy would read
+  // lists other commands for the file (clang-tidy runs all of them) or does not contain it
+  needsMinimalDatabase: boolean;
+  // Headers analyzed through this translation unit; only their diagnostics are kept
+  headers?: string[];
+  // Units merged into this generated unity source, and the line of the unity source each one starts at
+  members?: AnalysisUnit[];
+  memberLines?: number[];
+}
+
+export class CompileUnitResolver {
+  /**
+   * @param databases The primary database first, then additional ones for the union policy
+   */
+  constructor(private policy: CompileDbPolicy, private databases: NamedDatabase[]) {}
+
+  /**
+   * Label for a database: the name of the build directory containing it
+   */
+  static nameFor(compileCommandsPath: string): string {
+    return path.basename(path.dirname(compileCommandsPath)) || compileCommandsPath;
+  }
+
+  /**
+   * Identity of an entry's flag set: the arguments without output file, input file and -c
+   */
+  static flagSetKey(entry: CompileCommand): string {
+    return JSON.stringify([entry.directory, CompileUnitResolver.stripInputOutput(entry)]);
+  }
+
+  /**
+   * Arguments of an entry without output file, input file and -c
+   */
+  static stripInputOutput(entry: CompileCommand): string[] {
+    const args: string[] = [];
+    const source = path.normalize(entry.file);
+    for (let i = 0; i < entry.arguments.length; i++) {
+      const arg = entry.arguments[i];
+      if (arg === '-o' || arg === '/Fo') {
+        i++;
+      } else if (arg === '-c' || arg === '/c' || /^(-o|\/Fo)./.test(arg)) {
+        continue;
+      } else if (path.normalize(path.isAbsolute(arg) ? arg : path.join(entry.directory, arg)) !== source) {
+        args.push(arg);
+      }
+    }
+    return args;
+  }
+
+  /**
+   * Whether a file can yield more than one unit
+   */
+  isMultiConfiguration(): boolean {
+    return this.policy !== 'canonical';
+  }
+
+  /**
+   * Units to analyze for a file
+   */
+  resolve(file: string): AnalysisUnit[] {
+    const primary = this.databases[0];
+    if (!primary) {
+      return [{ file, needsMinimalDatabase: false }];
+    }
+
+    if (this.policy === 'union') {
+      const byFlags = new Map<string, { entry: CompileCommand; names: string[]; minimal: boolean }>();
+      this.databases.forEach((named, index) => {
+        const entries = named.database.getEntriesForFile(file);
+        if (entries.length === 0) {
+          return;
+        }
+        const entry = this.pickCanonical(entries);
+        const key = CompileUnitResolver.flagSetKey(entry);
+        const existing = byFlags.get(key);
+        if (existing) {
+          existing.names.push(named.name);
+        } else {
+          byFlags.set(key, { entry, names: [named.name], minimal: index > 0 || entries.length > 1 });
+        }
+      });
+      if (byFlags.size === 0) {
+        return [{ file, needsMinimalDatabase: false }];
+      }
+      return Array.from(byFlags.values(), variant => ({
+        file,
+        entry: variant.entry,
+        configuration: variant.names.join('+'),
+        needsMinimalDatabase: variant.minimal
+      }));
+    }
+
+    const entries = primary.database.getEntriesForFile(file);
+    if (entries.length === 0) {
+      return [{ file, needsMinimalDatabase: false }];
+    }
+    if (entries.length === 1) {
+      return [{ file, entry: entries[0], configuration: this.isMultiConfiguration() ? primary.name : undefined, needsMinimalDatabase: false }];
+    }
+
+    if (this.policy === 'canonical') {
+      return [{ file, entry: this.pickCanonical(entries), needsMinimalDatabase: true }];
+    }
+
+    // distinct
+    const variants = new Map<string, CompileCommand>();
+    for (const entry of entries) {
+      const key = CompileUnitResolver.flagSetKey(entry);
+      if (!variants.has(key)) {
+        variants.set(key, entry);
+      }
+    }
+    const distinct = Array.from(variants.values());
+    if (distinct.length === 1) {
+      return [{ file, entry: distinct[0], configuration: primary.name, needsMinimalDatabase: true }];
+    }
+    return distinct.map((entry, index) => ({
+      file,
+      entry,
+      configuration: `${primary.name} ${this.describeVariant(entry, distinct) || '#' + (index + 1)}`,
+      needsMinimalDatabase: true
+    }));
+  }
+
+  /**
+   * The entry whose flag set occurs most often (first on ties)
+   */
+  private pickCanonical(entries: CompileCommand[]): CompileCommand {
+    if (entries.length === 1) {
+      return entries[0];
+    }
+    const counts = new Map<string, number>();
+    entries.forEach(entry => {
+      const key = CompileUnitResolver.flagSetKey(entry);
+      counts.set(key, (counts.get(key) || 0) + 1);
+    });
+    let best = entries[0];
+    let bestCount = 0;
+    for (const entry of entries) {
+      const count = counts.get(CompileUnitResolver.flagSetKey(entry))!;
+      if (count > bestCount) {
+        best = entry;
+        bestCount = count;
+      }
+    }
+    return best;
+  }
+
+  /**
+   * Short label from the defines and language/optimization flags only this variant has
+   */
+  private describeVariant(entry: CompileCommand, variants: CompileCommand[]): string {
+    const shared = variants
+      .filter(other => other !== entry)
+      .map(other => new Set(other.arguments));
+    const own = entry.arguments.filter(arg =>
+      /^(-D|\/D|-std=|\/std:|-O|\/O|-m)/.test(arg) && shared.some(set => !set.has(arg)));
+    return own.length > 0 ? `[${own.slice(0, 3).join(' ')}]` : '';
+  }
+}
@@ -0,0 +1,126 @@
+// Header Mapper - Finds the translation units through which headers are analyzed
+import * as path from 'path';
+import { CompileCommand, CompileDatabase } from './CompileDatabase';
+import { IncludeGraph } from './IncludeGraph';
+
+export const HEADER_EXTENSIONS = ['.h', '.hh', '.hpp', '.hxx'];
+
+// A translation unit analyzed on behalf of one or more headers
+export interface HeaderAssignment {
+  entry: CompileCommand;
+  headers: string[];
+}
+
+export class HeaderMapper {
+  // Header -> translation units including it (transitively)
+  private includers = new Map<string, string[]>();
+  private indexed: CompileDatabase | null = null;
+
+  constructor(private includeGraph: IncludeGraph) {}
+
+  static isHeader(file: string): boolean {
+    return HEADER_EXTENSIONS.includes(path.extname(file).toLowerCase());
+  }
+
+  /**
+   * Assign each header to an including translation unit. Headers sharing a candidate are
+   * grouped onto one unit, otherwise the cheapest includer is chosen.
+   * Headers no translation unit includes are returned as unassigned.
+   */
+  assign(
+    headers: string[],
+    database: CompileDatabase,
+    costOf?: (file: string) => number
+  ): { assignments: HeaderAssignment[]; unassigned: string[] } {
+    const candidates = new Map<string, string[]>();
+    const unassigned: string[] = [];
+    // A stale index is rebuilt at most once per call, not once per header without includers
+    const state = { rebuilt: false };
+    for (const header of headers) {
+      const includers = this.findIncluders(header, database, state);
+      if (includers.length > 0) {
+        candidates.set(header, includers);
+      } else {
+        unassigned.push(header);
+      }
+    }
+
+    const cost = new Map<string, number>();
+    const costFor = (file: string) => {
+      if (!cost.has(file)) {
+        cost.set(file, costOf ? costOf(file) : this.estimateCost(file, database));
+      }
+      return cost.get(file)!;
+    };
+
+    // Most constrained headers first, so shared includers are picked before cheap but exclusive ones
+    const assignments = new Map<string, HeaderAssignment>();
+    const ordered = Array.from(candidates.keys()).sort((a, b) => candidates.get(a)!.length - candidates.get(b)!.length);
+    for (const header of ordered) {
+      const includers = candidates.get(header)!;
+      const shared = includers.filter(file => assignments.has(file));
+      const pool = shared.length > 0 ? shared : includers;
+      const chosen = pool.reduce((best, file) => costFor(file) < costFor(best) ? file : best);
+      const assignment = assignments.get(chosen);
+      if (assignment) {
+        assignment.headers.push(header);
+      } else {
+        assignments.set(chosen, { entry: database.getEntry(chosen)!, headers: [header] });
+      }
+    }
+
+    return { assignments: Array.from(assignments.values()), unassigned };
+  }
+
+  /**
+   * Translation units of the database including a header. `state` shares the rebuild of a stale
+   * index between lookups, so headers nothing includes do not rescan the whole database each.
+   */
+  findIncluders(header: string, database: CompileDatabase, state = { rebuilt: false }): string[] {
+    const normalized = path.normalize(header);
+    if (this.indexed !== database) {
+      this.buildIndex(database);
+      state.rebuilt = true;
+    }
+    // The index may predate edits; drop units that no longer include the header and rebuild once if none remain
+    const verify = () => (this.includers.get(normalized) || []).filter(file => {
+      const entry = database.getEntry(file);
+      return !!entry && this.includeGraph.getTransitiveIncludes(file, CompileDatabase.getIncludeDirs(entry)).includes(normalized);
+    });
+    let includers = verify();
+    if (includers.length === 0 && !state.rebuilt) {
+      this.buildIndex(database);
+      state.rebuilt = true;
+      includers = verify();
+    }
+    return includers;
+  }
+
+  /**
+   * Cost estimate without history: bytes the frontend reads for the unit
+   */
+  private estimateCost(file: string, database: CompileDatabase): number {
+    const entry = database.getEntry(file);
+    const includes = entry ? this.includeGraph.getTransitiveIncludes(file, CompileDatabase.getIncludeDirs(entry)) : [];
+    return [file, ...includes].reduce((total, include) => total + this.includeGraph.getSize(include), 0);
+  }
+
+  private buildIndex(database: CompileDatabase): void {
+    this.includers.clear();
+    for (const file of database.getFiles()) {
+      const entry = database.getEntry(file);
+      if (!entry) {
+        continue;
+      }
+      for (const include of this.includeGraph.getTransitiveIncludes(entry.file, CompileDatabase.getIncludeDirs(entry))) {
+        const list = this.includers.get(include);
+        if (list) {
+          list.push(entry.file);
+        } else {
+          this.includers.set(include, [entry.file]);
+        }
+      }
+    }
+    this.indexed = database;
+  }
+}
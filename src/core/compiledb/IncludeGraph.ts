@@ -0,0 +1,227 @@
+// Include Graph - Lightweight #include scanner used for dependency fingerprints
+import * as crypto from 'crypto';
+import * as fs from 'fs';
+import * as path from 'path';
+
+interface ScannedFile {
+  stamp: string;
+  size: number;
+  hash: string;
+  includes: Array<{ name: string; quoted: boolean }>;
+  // Number of includes forming the file's leading block (before any other code)
+  leadingIncludes: number;
+}
+
+export class IncludeGraph {
+  private scanned = new Map<string, ScannedFile | null>();
+  private resolved = new Map<string, string[]>();
+
+  /**
+   * Get the directly included project files of a file.
+   * Headers that cannot be found in the search path (system headers) are skipped.
+   */
+  getIncludes(file: string, includeDirs: string[]): string[] {
+    const scanned = this.scan(file);
+    if (!scanned) {
+      return [];
+    }
+
+    const cacheKey = file + '\0' + scanned.stamp + '\0' + includeDirs.join('\0');
+    const cached = this.resolved.get(cacheKey);
+    if (cached) {
+      return cached;
+    }
+
+    const result: string[] = [];
+    const fileDir = path.dirname(file);
+    for (const include of scanned.includes) {
+      const searchDirs = include.quoted ? [fileDir, ...includeDirs] : includeDirs;
+      for (const dir of searchDirs) {
+        const candidate = path.normalize(path.join(dir, include.name));
+        if (this.scan(candidate)) {
+          result.push(candidate);
+          break;
+        }
+      }
+    }
+
+    this.resolved.set(cacheKey, result);
+    return result;
+  }
+
+  /**
+   * Get the includes at the top of a file, before any declaration, macro or other directive.
+   * Resolved is the absolute path, or null for headers outside the search path (system headers).
+   */
+  getLeadingIncludes(file: string, includeDirs: string[]): Array<{ name: string; quoted: boolean; resolved: string | null }> {
+    const scanned = this.scan(file);
+    if (!scanned) {
+      return [];
+    }
+    const fileDir = path.dirname(file);
+    return scanned.includes.slice(0, scanned.leadingIncludes).map(include => {
+      const searchDirs = include.quoted ? [fileDir, ...includeDirs] : includeDirs;
+      const resolved = searchDirs
+        .map(dir => path.normalize(path.join(dir, include.name)))
+        .find(candidate => this.scan(candidate) !== null);
+      return { ...include, resolved: resolved || null };
+    });
+  }
+
+  /**
+   * Get all project files reachable through #include, excluding the file itself
+   */
+  getTransitiveIncludes(file: string, includeDirs: string[]): string[] {
+    const visited = new Set<string>([file]);
+    const order: string[] = [];
+    const stack = [file];
+
+    while (stack.length > 0) {
+      const current = stack.pop()!;
+      for (const include of this.getIncludes(current, includeDirs)) {
+        if (!visited.has(include)) {
+          visited.add(include);
+          order.push(include);
+          stack.push(include);
+        }
+      }
+    }
+
+    return order;
+  }
+
+  /**
+   * Get the include names of a file and its project headers that cannot be found in the search path:
+   * system headers, and headers that do not exist yet (e.g. generated by the build)
+   */
+  getUnresolvedIncludes(file: string, includeDirs: string[]): string[] {
+    const names = new Set<string>();
+    for (const current of [file, ...this.getTransitiveIncludes(file, includeDirs)]) {
+      const scanned = this.scan(current);
+      if (!scanned) {
+        continue;
+      }
+      const currentDir = path.dirname(current);
+      for (const include of scanned.includes) {
+        const searchDirs = include.quoted ? [currentDir, ...includeDirs] : includeDirs;
+        if (!searchDirs.some(dir => this.scan(path.normalize(path.join(dir, include.name))) !== null)) {
+          names.add(include.name);
+        }
+      }
+    }
+    return Array.from(names);
+  }
+
+  /**
+   * Content fingerprint of a file and every project header it includes.
+   * Headers are named relative to root, so the fingerprint does not depend on where the workspace is.
+   */
+  fingerprint(file: string, includeDirs: string[], root?: string): string {
+    const hash = crypto.createHash('sha256');
+    hash.update(this.hashFile(file));
+    const name = (include: string) => root ? path.relative(root, include).replace(/\\/g, '/') : include;
+    for (const include of this.getTransitiveIncludes(file, includeDirs).map(include => ({ include, name: name(include) }))
+      .sort((a, b) => a.name < b.name ? -1 : a.name > b.name ? 1 : 0)) {
+      hash.update('\0' + include.name + '\0' + this.hashFile(include.include));
+    }
+    return hash.digest('hex');
+  }
+
+  /**
+   * Content hash of a single file ('' if unreadable)
+   */
+  hashFile(file: string): string {
+    const scanned = this.scan(file);
+    return scanned ? scanned.hash : '';
+  }
+
+  /**
+   * Size of a file in bytes (0 if unreadable)
+   */
+  getSize(file: string): number {
+    const scanned = this.scan(file);
+    return scanned ? scanned.size : 0;
+  }
+
+  /**
+   * Read and scan a file, reusing the previous scan while mtime and size are unchanged
+   */
+  private scan(file: string): ScannedFile | null {
+    let stat: fs.Stats;
+    try {
+      stat = fs.statSync(file);
+    } catch (error) {
+      return null;
+    }
+    if (!stat.isFile()) {
+      return null;
+    }
+
+    const stamp = `${stat.mtimeMs}:${stat.size}`;
+    const cached = this.scanned.get(file);
+    if (cached && cached.stamp === stamp) {
+      return cached;
+    }
+
+    let content: Buffer;
+    try {
+      content = fs.readFileSync(file);
+    } catch (error) {
+      return null;
+    }
+
+    const includes: ScannedFile['includes'] = [];
+    const includeRegex = /^\s*#\s*include\s*([<"])([^>"]+)[>"]/gm;
+    const text = content.toString('utf8');
+    let match: RegExpExecArray | null;
+    while ((match = includeRegex.exec(text)) !== null) {
+      includes.push({ name: match[2], quoted: match[1] === '"' });
+    }
+
+    const result: ScannedFile = {
+      stamp,
+      leadingIncludes: this.countLeadingIncludes(text),
+      size: stat.size,
+      hash: crypto.createHash('sha256').update(content).digest('hex'),
+      includes
+    };
+    this.scanned.set(file, result);
+    return result;
+  }
+
+  /**
+   * Count the #include lines preceding the first line that is neither blank, a comment nor an include
+   */
+  private countLeadingIncludes(text: string): number {
+    let count = 0;
+    let inComment = false;
+    for (const rawLine of text.split('\n')) {
+      let line = rawLine.trim();
+      if (inComment) {
+        const end = line.indexOf('*/');
+        if (end < 0) {
+          continue;
+        }
+        inComment = false;
+        line = line.substring(end + 2).trim();
+      }
+      while (line.startsWith('/*')) {
+        const end = line.indexOf('*/', 2);
+        if (end < 0) {
+          inComment = true;
+          line = '';
+          break;
+        }
+        line = line.substring(end + 2).trim();
+      }
+      if (!line || line.startsWith('//')) {
+        continue;
+      }
+      if (!/^#\s*include\s*[<"]/.test(line)) {
+        break;
+      }
+      count++;
+    }
+    return count;
+  }
+}
@@ -0,0 +1,32 @@
+// Minimal Database - Single-entry compile databases handed to clang-tidy with -p
+import * as crypto from 'crypto';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import { CompileCommand } from './CompileDatabase';
+
+export class MinimalDatabase {
+  private static written = new Set<string>();
+
+  /**
+   * Write a compile database holding only the given entry and return its directory.
+   * Directories are content-addressed, so the same entry is written once and reused across runs.
+   */
+  static write(entry: CompileCommand, baseDir: string = path.join(os.tmpdir(), 'clang-tidy-visualizer', 'compiledb')): string {
+    const content = JSON.stringify([{ directory: entry.directory, file: entry.file, arguments: entry.arguments }]);
+    const hash = crypto.createHash('sha256').update(content).digest('hex').substring(0, 24);
+    const dir = path.join(baseDir, hash);
+
+    if (!this.written.has(dir)) {
+      const target = path.join(dir, 'compile_commands.json');
+      if (!fs.existsSync(target)) {
+        fs.mkdirSync(dir, { recursive: true });
+        const tempPath = `${target}.${process.pid}.tmp`;
+        fs.writeFileSync(tempPath, content, 'utf8');
+        fs.renameSync(tempPath, target);
+      }
+      this.written.add(dir);
+    }
+    return dir;
+  }
+}
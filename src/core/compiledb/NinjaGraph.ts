@@ -0,0 +1,242 @@
+// Ninja Graph - Generated headers and build timings of the ninja build a compile database comes from
+import * as fs from 'fs';
+import * as path from 'path';
+import { ProcessUtils } from '../../utils/processUtils';
+import { logger } from '../../utils/logger';
+import { CompileCommand, CompileDatabase } from './CompileDatabase';
+import { AnalysisUnit } from './CompileUnitResolver';
+import { HEADER_EXTENSIONS } from './HeaderMapper';
+import { IncludeGraph } from './IncludeGraph';
+
+export type GeneratedHeaderMode = 'off' | 'delay' | 'generate';
+
+// Outputs of build rules that translation units may include
+const GENERATED_EXTENSIONS = [...HEADER_EXTENSIONS, '.inc', '.def'];
+// Delayed units are given up on once no missing input has appeared for this long
+const DELAY_IDLE_TIMEOUT_MS = 60000;
+const DELAY_POLL_INTERVAL_MS = 1000;
+
+export class NinjaGraph {
+  private static graphs = new Map<string, { stamp: string; graph: NinjaGraph }>();
+
+  // Generated file (absolute) -> ninja target name
+  private generated: Promise<Map<string, string>> | null = null;
+  // Source file -> duration of its last compile in milliseconds
+  private buildTimes: Map<string, number> | null = null;
+
+  private constructor(private buildDir: string, private compileCommandsPath: string, private ninjaPath: string) {}
+
+  /**
+   * Graph of the ninja build directory containing a compile database, or null if it is not a ninja build.
+   * The graph is reused while build.ninja is unchanged.
+   */
+  static find(compileCommandsPath: string, ninjaPath: string = 'ninja'): NinjaGraph | null {
+    const buildDir = path.dirname(compileCommandsPath);
+    let stat: fs.Stats;
+    try {
+      stat = fs.statSync(path.join(buildDir, 'build.ninja'));
+    } catch (error) {
+      return null;
+    }
+    const stamp = `${stat.mtimeMs}:${stat.size}`;
+    const cached = this.graphs.get(buildDir);
+    if (cached && cached.stamp === stamp) {
+      return cached.graph;
+    }
+    const graph = new NinjaGraph(buildDir, compileCommandsPath, ninjaPath);
+    this.graphs.set(buildDir, { stamp, graph });
+    return graph;
+  }
+
+  /**
+   * Duration of the last compile of a source file according to .ninja_log, if known.
+   * Compile time is a good prior for analysis time: both are dominated by parsing the same headers.
+   */
+  getBuildTime(file: string): number | undefined {
+    if (!this.buildTimes) {
+      this.buildTimes = this.loadBuildTimes();
+    }
+    return this.buildTimes.get(path.normalize(file));
+  }
+
+  /**
+   * Split units into those whose generated inputs exist and those still waiting for the build.
+   * In generate mode the missing headers are built first with one ninja invocation limited to them.
+   */
+  async partition(units: AnalysisUnit[], includeGraph: IncludeGraph, mode: GeneratedHeaderMode): Promise<{ ready: AnalysisUnit[]; blocked: AnalysisUnit[] }> {
+    if (mode === 'off') {
+      return { ready: units, blocked: [] };
+    }
+    const generated = await this.getGeneratedFiles();
+    if (generated.size === 0) {
+      return { ready: units, blocked: [] };
+    }
+
+    const missing = new Map<AnalysisUnit, string[]>();
+    for (const unit of units) {
+      const inputs = this.missingInputs(unit, includeGraph, generated);
+      if (inputs.length > 0) {
+        missing.set(unit, inputs);
+      }
+    }
+    if (missing.size === 0) {
+      return { ready: units, blocked: [] };
+    }
+
+    if (mode === 'generate') {
+      const targets = Array.from(new Set(Array.from(missing.values()).flat())).map(file => generated.get(file)!);
+      logger.info(`Generating ${targets.length} headers needed by ${missing.size} translation units`);
+      try {
+        const result = await ProcessUtils.executeCommand(this.ninjaPath, ['-C', this.buildDir, ...targets]);
+        if (result.exitCode !== 0) {
+          logger.warn(`ninja failed to generate headers: ${result.stdout.split('\n').filter(line => line.startsWith('FAILED')).join('; ')}`);
+        }
+      } catch (error) {
+        logger.warn(`Failed to run ${this.ninjaPath}: ${error instanceof Error ? error.message : String(error)}`);
+      }
+      for (const [unit, inputs] of missing) {
+        if (inputs.every(file => fs.existsSync(file))) {
+          missing.delete(unit);
+        }
+      }
+    }
+
+    const blocked = units.filter(unit => missing.has(unit));
+    if (blocked.length > 0) {
+      logger.info(`Delaying ${blocked.length} translation units until their generated headers exist`);
+    }
+    return { ready: units.filter(unit => !missing.has(unit)), blocked };
+  }
+
+  /**
+   * Wait for the generated inputs of blocked units to appear (e.g. from a build running alongside).
+   * Gives up once nothing has appeared for a while, or when the signal aborts; those units are returned as missing.
+   */
+  async waitForInputs(units: AnalysisUnit[], includeGraph: IncludeGraph, signal?: AbortSignal): Promise<{ ready: AnalysisUnit[]; missing: AnalysisUnit[] }> {
+    const generated = await this.getGeneratedFiles();
+    const ready: AnalysisUnit[] = [];
+    let waiting = units;
+    let lastProgress = Date.now();
+
+    while (waiting.length > 0) {
+      const stillWaiting = waiting.filter(unit => this.missingInputs(unit, includeGraph, generated).length > 0);
+      ready.push(...waiting.filter(unit => !stillWaiting.includes(unit)));
+      if (stillWaiting.length < waiting.length) {
+        lastProgress = Date.now();
+      }
+      waiting = stillWaiting;
+      if (waiting.length === 0 || Date.now() - lastProgress > DELAY_IDLE_TIMEOUT_MS || signal?.aborted) {
+        break;
+      }
+      await new Promise<void>(resolve => {
+        const timer = setTimeout(done, DELAY_POLL_INTERVAL_MS);
+        function done() {
+          clearTimeout(timer);
+          signal?.removeEventListener('abort', done);
+          resolve();
+        }
+        signal?.addEventListener('abort', done);
+      });
+    }
+
+    if (waiting.length > 0 && !signal?.aborted) {
+      logger.warn(`Skipping ${waiting.length} translation units whose generated headers were not built: ` +
+        waiting.slice(0, 5).map(unit => unit.file).join(', ') + (waiting.length > 5 ? ', ...' : ''));
+    }
+    return { ready, missing: waiting };
+  }
+
+  /**
+   * Generated files of a unit's translation unit that do not exist yet
+   */
+  private missingInputs(unit: AnalysisUnit, includeGraph: IncludeGraph, generated: Map<string, string>): string[] {
+    if (!unit.entry) {
+      return [];
+    }
+    const names = includeGraph.getUnresolvedIncludes(unit.file, CompileDatabase.getIncludeDirs(unit.entry));
+    const missing: string[] = [];
+    for (const name of names) {
+      const suffix = path.sep + path.normalize(name);
+      for (const file of generated.keys()) {
+        if (file.endsWith(suffix) && !fs.existsSync(file)) {
+          missing.push(file);
+        }
+      }
+    }
+    return missing;
+  }
+
+  /**
+   * Outputs of non-phony build edges that look like headers, from `ninja -t targets all`
+   */
+  private getGeneratedFiles(): Promise<Map<string, string>> {
+    if (!this.generated) {
+      this.generated = (async () => {
+        const generated = new Map<string, string>();
+        try {
+          const result = await ProcessUtils.executeCommand(this.ninjaPath, ['-C', this.buildDir, '-t', 'targets', 'all']);
+          for (const line of result.stdout.split('\n')) {
+            const separator = line.lastIndexOf(': ');
+            if (separator < 0 || line.substring(separator + 2).trim() === 'phony') {
+              continue;
+            }
+            const target = line.substring(0, separator);
+            if (GENERATED_EXTENSIONS.includes(path.extname(target).toLowerCase())) {
+              generated.set(path.normalize(path.resolve(this.buildDir, target)), target);
+            }
+          }
+        } catch (error) {
+          logger.warn(`Failed to read the ninja build graph: ${error instanceof Error ? error.message : String(error)}`);
+        }
+        logger.debug(`ninja build graph: ${generated.size} generated headers`);
+        return generated;
+      })();
+    }
+    return this.generated;
+  }
+
+  /**
+   * Map .ninja_log entries (start, end, mtime, output, hash) to sources through the objects of the compile database
+   */
+  private loadBuildTimes(): Map<string, number> {
+    const times = new Map<string, number>();
+    const logPath = path.join(this.buildDir, '.ninja_log');
+    let database: CompileDatabase;
+    let log: string;
+    try {
+      log = fs.readFileSync(logPath, 'utf8');
+      database = CompileDatabase.load(this.compileCommandsPath);
+    } catch (error) {
+      return times;
+    }
+
+    // Later lines supersede earlier ones for the same output
+    const durations = new Map<string, number>();
+    for (const line of log.split('\n')) {
+      const fields = line.split('\t');
+      if (fields.length < 5 || line.startsWith('#')) {
+        continue;
+      }
+      durations.set(path.normalize(path.resolve(this.buildDir, fields[3])), parseInt(fields[1], 10) - parseInt(fields[0], 10));
+    }
+
+    for (const entry of database.getEntries()) {
+      const output = NinjaGraph.outputOf(entry);
+      const duration = output !== undefined ? durations.get(output) : undefined;
+      if (duration !== undefined && duration > 0) {
+        times.set(path.normalize(entry.file), duration);
+      }
+    }
+    logger.debug(`Loaded build times of ${times.size} translation units from ${logPath}`);
+    return times;
+  }
+
+  private static outputOf(entry: CompileCommand): string | undefined {
+    let output = entry.output;
+    if (!output) {
+      const index = entry.arguments.indexOf('-o');
+      output = index >= 0 ? entry.arguments[index + 1] : entry.arguments.find(arg => /^[/-]Fo./.test(arg))?.substring(3);
+    }
+    return output ? path.normalize(path.resolve(entry.directory, output)) : undefined;
+  }
+}
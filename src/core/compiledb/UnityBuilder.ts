@@ -0,0 +1,216 @@
+// Unity Builder - Merges small translation units with identical flags so they share header parsing
+import * as crypto from 'crypto';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import { logger } from '../../utils/logger';
+import { AnalysisUnit, CompileUnitResolver } from './CompileUnitResolver';
+import { CommandRewriter } from './CommandRewriter';
+
+// Larger sources gain little from sharing their headers and make a failing batch expensive to redo
+const MAX_MEMBER_BYTES = 32 * 1024;
+const SOURCE_EXTENSIONS = ['.c', '.cc', '.cpp', '.cxx'];
+
+export class UnityBuilder {
+  /**
+   * @param eligible Additional per-file condition, e.g. that the generated source would pick up the same .clang-tidy
+   */
+  constructor(
+    private batchSize: number,
+    private eligible: (file: string) => boolean = () => true,
+    private baseDir: string = path.join(os.tmpdir(), 'clang-tidy-visualizer', 'unity')
+  ) {}
+
+  /**
+   * Source text that cannot share a translation unit with others: names with internal linkage
+   * would collide, and using-directives or macros would leak into the following sources
+   */
+  static findHazard(content: string): string | null {
+    if (/\bnamespace\s*\{/.test(content)) {
+      return 'anonymous namespace';
+    }
+    if (/^\s*using\s+namespace\b/m.test(content)) {
+      return 'using-directive';
+    }
+    if (/^\s*#\s*(define|undef)\b/m.test(content)) {
+      return 'macro definition';
+    }
+    return null;
+  }
+
+  /**
+   * Names declared static at file scope
+   */
+  static staticNames(content: string): string[] {
+    const names: string[] = [];
+    const staticRegex = /^static\s+[^;={(]*?\b([A-Za-z_]\w*)\s*(?:\(|=|;|\[|\{)/gm;
+    let match: RegExpExecArray | null;
+    while ((match = staticRegex.exec(content)) !== null) {
+      names.push(match[1]);
+    }
+    return names;
+  }
+
+  /**
+   * Comment line preceding a member in a unity source
+   */
+  static memberMarker(file: string): string {
+    return `// unity member "${file.replace(/\\/g, '\\\\').replace(/"/g, '\\"')}"`;
+  }
+
+  /**
+   * Whether a unity run failed to compile, so its sources have to be analyzed one by one
+   */
+  static hasCompileErrors(output: string): boolean {
+    return output.includes('[clang-diagnostic-error]');
+  }
+
+  /**
+   * Rewrite locations in a unity run's output to the member files and lines they belong to.
+   * clang-tidy reports the generated source and its physical lines.
+   */
+  static remapOutput(output: string, unit: AnalysisUnit): string {
+    if (!unit.members || !unit.memberLines) {
+      return output;
+    }
+    const members = unit.members;
+    const starts = unit.memberLines;
+    const location = new RegExp(unit.file.replace(/[.*+?^${}()|[\]\\]/g, '\\$&') + ':(\\d+)', 'g');
+    return output.replace(location, (match, line: string) => {
+      const physical = parseInt(line, 10);
+      let index = starts.length - 1;
+      while (index > 0 && starts[index] > physical) {
+        index--;
+      }
+      return physical < starts[0] ? match : `${members[index].file}:${physical - starts[index] + 1}`;
+    });
+  }
+
+  /**
+   * Merge small units sharing flags and source directory into unity units of up to batchSize sources.
+   * Units with hazards, or whose static names collide with another candidate, stay individual.
+   */
+  apply(units: AnalysisUnit[]): AnalysisUnit[] {
+    const result: AnalysisUnit[] = [];
+    const groups = new Map<string, Array<{ unit: AnalysisUnit; content: string }>>();
+
+    for (const unit of units) {
+      const content = this.readCandidate(unit);
+      if (content === null) {
+        result.push(unit);
+        continue;
+      }
+      const key = [CompileUnitResolver.flagSetKey(unit.entry!), path.dirname(unit.file), unit.configuration || ''].join('\0');
+      const group = groups.get(key);
+      if (group) {
+        group.push({ unit, content });
+      } else {
+        groups.set(key, [{ unit, content }]);
+      }
+    }
+
+    let merged = 0;
+    for (const group of groups.values()) {
+      const owners = new Map<string, number>();
+      group.forEach(candidate => new Set(UnityBuilder.staticNames(candidate.content))
+        .forEach(name => owners.set(name, (owners.get(name) || 0) + 1)));
+
+      const mergeable: typeof group = [];
+      for (const candidate of group) {
+        const hazard = UnityBuilder.findHazard(candidate.content) ||
+          (UnityBuilder.staticNames(candidate.content).some(name => owners.get(name)! > 1) ? 'static name collision' : null);
+        if (hazard) {
+          logger.debug(`Analyzing ${candidate.unit.file} on its own: ${hazard}`);
+          result.push(candidate.unit);
+        } else {
+          mergeable.push(candidate);
+        }
+      }
+
+      for (let i = 0; i < mergeable.length; i += this.batchSize) {
+        const batch = mergeable.slice(i, i + this.batchSize);
+        const unity = batch.length > 1 ? this.build(batch) : null;
+        if (unity) {
+          result.push(unity);
+          merged += batch.length;
+        } else {
+          result.push(...batch.map(candidate => candidate.unit));
+        }
+      }
+    }
+
+    if (merged > 0) {
+      logger.debug(`Unity analysis: merged ${merged} translation units, ${result.length} units to run`);
+    }
+    return result;
+  }
+
+  /**
+   * Content of a unit that may be merged, or null if it must run on its own
+   */
+  private readCandidate(unit: AnalysisUnit): string | null {
+    if (!unit.entry || unit.headers || unit.members || !SOURCE_EXTENSIONS.includes(path.extname(unit.file).toLowerCase()) ||
+      !this.eligible(unit.file)) {
+      return null;
+    }
+    try {
+      if (fs.statSync(unit.file).size > MAX_MEMBER_BYTES) {
+        return null;
+      }
+      return fs.readFileSync(unit.file, 'utf8');
+    } catch (error) {
+      return null;
+    }
+  }
+
+  /**
+   * Write the unity source and derive its compile command from the first member's.
+   * A comment line names each member; the lines each member starts at map findings back to it.
+   */
+  private build(batch: Array<{ unit: AnalysisUnit; content: string }>): AnalysisUnit | null {
+    const first = batch[0].unit;
+    const memberLines: number[] = [];
+    let line = 1;
+    const content = batch.map(({ unit, content }) => {
+      const text = content.endsWith('\n') ? content : content + '\n';
+      // The member's text starts after its marker line
+      memberLines.push(line + 1);
+      line += text.split('\n').length;
+      return `${UnityBuilder.memberMarker(unit.file)}\n${text}`;
+    }).join('');
+    const hash = crypto.createHash('sha256').update(content).digest('hex').substring(0, 24);
+    const unityFile = path.join(this.baseDir, hash, 'unity' + path.extname(first.file));
+
+    try {
+      if (!fs.existsSync(unityFile)) {
+        fs.mkdirSync(path.dirname(unityFile), { recursive: true });
+        fs.writeFileSync(unityFile, content, 'utf8');
+      }
+    } catch (error) {
+      logger.warn(`Failed to write unity source ${unityFile}: ${error instanceof Error ? error.message : String(error)}`);
+      return null;
+    }
+
+    // Quoted includes are searched relative to the including file first; keep finding them in the sources' directory
+    const entry = first.entry!;
+    const source = path.normalize(entry.file);
+    const args = entry.arguments.map(arg =>
+      path.normalize(path.isAbsolute(arg) ? arg : path.join(entry.directory, arg)) === source ? unityFile : arg);
+    if (!args.includes(unityFile)) {
+      args.push(unityFile);
+    }
+    const cl = CommandRewriter.detectDriver(args) === 'cl';
+    const firstFlag = Math.max(1, args.findIndex((arg, i) => i > 0 && (cl ? /^[-/]/ : /^-/).test(arg)));
+    const sourceDir = path.dirname(first.file);
+    args.splice(firstFlag, 0, ...(cl ? ['/I' + sourceDir] : ['-iquote', sourceDir]));
+
+    return {
+      file: unityFile,
+      entry: { ...entry, file: unityFile, arguments: args },
+      configuration: first.configuration,
+      needsMinimalDatabase: true,
+      members: batch.map(candidate => candidate.unit),
+      memberLines
+    };
+  }
+}
@@ -1,14 +1,19 @@
 // Config Manager - Clang-Tidy Visualizer
 import * as vscode from 'vscode';
-import { ExtensionConfiguration } from '../../types';
+import { ExtensionConfiguration, RunnerSettings } from '../../types';
 import { FileUtils } from '../../utils/fileUtils';
 import { logger } from '../../utils/logger';
 
-export class ConfigManager {
+export class ConfigManager implements RunnerSettings {
   private config: ExtensionConfiguration;
   private static instance: ConfigManager | null = null;
+  private static folderInstances = new Map<string, ConfigManager>();
 
-  private constructor() {
+  /**
+   * @param root Workspace folder whose settings (including folder-level overrides) are used;
+   *             null for the first workspace folder
+   */
+  private constructor(private root: string | null = null) {
     this.config = this.loadConfiguration();
     this.setupConfigurationWatcher();
   }
@@ -23,11 +28,28 @@ export class ConfigManager {
     return ConfigManager.instance;
   }
 
+  /**
+   * Get the configuration of one root of a multi-root workspace
+   */
+  static getForRoot(root: string): ConfigManager {
+    if (root === FileUtils.getWorkspaceRoot()) {
+      return this.getInstance();
+    }
+    let manager = this.folderInstances.get(root);
+    if (!manager) {
+      manager = new ConfigManager(root);
+      this.folderInstances.set(root, manager);
+    }
+    return manager;
+  }
+
   /**
    * Load configuration from VSCode settings
    */
   private loadConfiguration(): ExtensionConfiguration {
-    const vscodeConfig = vscode.workspace.getConfiguration('clangTidyVisualizer');
+    const vscodeConfig = this.root
+      ? vscode.workspace.getConfiguration('clangTidyVisualizer', vscode.Uri.file(this.root))
+      : vscode.workspace.getConfiguration('clangTidyVisualizer');
     
     logger.debug('Loading configuration from VSCode settings');
     
@@ -59,6 +81,54 @@ export class ConfigManager {
       ignorePatterns: vscodeConfig.get<string[]>('ignorePatterns', ['third_party', 'node_modules', 'build', 'out']),
       excludeDirectories: vscodeConfig.get<string[]>('excludeDirectories', []),
       
+      // Result cache configuration
+      cache: {
+        enabled: vscodeConfig.get<boolean>('cache.enabled', true),
+        directory: vscodeConfig.get<string>('cache.directory', ''),
+        remote: vscodeConfig.get<string>('cache.remote', ''),
+        remoteUpload: vscodeConfig.get<boolean>('cache.remoteUpload', false),
+        remoteToken: vscodeConfig.get<string>('cache.remoteToken', ''),
+        checkDelta: vscodeConfig.get<boolean>('cache.checkDelta', true)
+      },
+      
+      // Compile database policy configuration
+      compileDatabase: {
+        policy: vscodeConfig.get<'canonical' | 'distinct' | 'union'>('compileDatabase.policy', 'canonical'),
+        additionalPaths: vscodeConfig.get<string[]>('compileDatabase.additionalPaths', []),
+        rewrite: vscodeConfig.get<boolean>('compileDatabase.rewrite', true),
+        rewriteRules: vscodeConfig.get<string[]>('compileDatabase.rewriteRules', []),
+        precompiledHeaders: vscodeConfig.get<boolean>('compileDatabase.precompiledHeaders', false),
+        unityBatchSize: vscodeConfig.get<number>('compileDatabase.unityBatchSize', 0),
+        generatedHeaders: vscodeConfig.get<'off' | 'delay' | 'generate'>('compileDatabase.generatedHeaders', 'off')
+      },
+      
+      // Shared analysis daemon configuration
+      daemon: {
+        enabled: vscodeConfig.get<boolean>('daemon.enabled', false),
+        socketPath: vscodeConfig.get<string>('daemon.socketPath', ''),
+        idleTimeoutMinutes: vscodeConfig.get<number>('daemon.idleTimeoutMinutes', 30)
+      },
+      
+      // Check tier configuration
+      tiers: {
+        enabled: vscodeConfig.get<boolean>('tiers.enabled', false),
+        slowChecks: vscodeConfig.get<string[]>('tiers.slowChecks', []),
+        profileDirectory: vscodeConfig.get<string>('tiers.profileDirectory', '')
+      },
+      
+      // Diagnostic caps configuration
+      limits: {
+        maxDiagnosticsPerTranslationUnit: vscodeConfig.get<number>('limits.maxDiagnosticsPerTranslationUnit', 10000),
+        maxDiagnosticsPerFileCheck: vscodeConfig.get<number>('limits.maxDiagnosticsPerFileCheck', 1000)
+      },
+      
+      // Live analysis configuration
+      live: {
+        engine: vscodeConfig.get<'clang-tidy' | 'clangd'>('live.engine', 'clang-tidy'),
+        clangdPath: vscodeConfig.get<string>('live.clangdPath', 'clangd'),
+        analyzeOnSave: vscodeConfig.get<boolean>('live.analyzeOnSave', false)
+      },
+      
       // Advanced configuration
       extraArgs: vscodeConfig.get<string[]>('extraArgs', []),
       timeout: vscodeConfig.get<number>('timeout', 300000), // 5 minutes
@@ -96,7 +166,7 @@ export class ConfigManager {
     }
     
     // Try to find compile_commands.json in workspace
-    const workspaceRoot = FileUtils.getWorkspaceRoot();
+    const workspaceRoot = this.getWorkspaceRoot();
     if (workspaceRoot) {
       const compileCommandsPath = FileUtils.findCompileCommands(workspaceRoot);
       if (compileCommandsPath) {
@@ -177,6 +247,52 @@ export class ConfigManager {
     return this.config.excludeDirectories;
   }
 
+  /**
+   * Get Result Cache Configuration
+   */
+  getCacheConfig(): ExtensionConfiguration['cache'] {
+    return this.config.cache;
+  }
+
+  /**
+   * Get Compile Database Policy Configuration
+   */
+  getCompileDatabaseConfig(): ExtensionConfiguration['compileDatabase'] {
+    return {
+      ...this.config.compileDatabase,
+      additionalPaths: this.config.compileDatabase.additionalPaths.map(file => this.resolvePath(file))
+    };
+  }
+
+  /**
+   * Get Analysis Daemon Configuration
+   */
+  getDaemonConfig(): ExtensionConfiguration['daemon'] {
+    return this.config.daemon;
+  }
+
+  /**
+   * Get Live Analysis Configuration
+   */
+  getLiveConfig(): ExtensionConfiguration['live'] {
+    return this.config.live;
+  }
+
+  /**
+   * Get Check Tier Configuration
+   */
+  getTierConfig(): ExtensionConfiguration['tiers'] {
+    const profileDirectory = this.config.tiers.profileDirectory;
+    return { ...this.config.tiers, profileDirectory: profileDirectory ? this.resolvePath(profileDirectory) : '' };
+  }
+
+  /**
+   * Get Diagnostic Caps Configuration
+   */
+  getDiagnosticLimits(): ExtensionConfiguration['limits'] {
+    return this.config.limits;
+  }
+
   /**
    * Get Extra Arguments
    */
@@ -199,10 +315,17 @@ export class ConfigManager {
   }
 
   /**
-   * Resolve path with variables
+   * Get the workspace root used as working directory for analysis
+   */
+  getWorkspaceRoot(): string | null {
+    return this.root || FileUtils.getWorkspaceRoot();
+  }
+
+  /**
+   * Resolve path with variables; ${workspaceFolder} is this configuration's root
    */
   resolvePath(path: string): string {
-    return FileUtils.resolvePath(path);
+    return FileUtils.resolvePath(this.root ? path.replace(/\${workspaceFolder}/g, this.root) : path);
   }
 
   /**
@@ -0,0 +1,201 @@
+// Analysis Engine - Runs clang-tidy over a file list and builds report data (no VS Code dependency)
+import * as path from 'path';
+import { ClangTidyDiagnostic, ParallelResult, ReportData, RunOptions } from '../../types';
+import { ClangTidyRunner } from '../runner/ClangTidyRunner';
+import { TextParser } from '../parser/TextParser';
+import { DiagnosticCaps } from '../parser/DiagnosticCaps';
+import { logger } from '../../utils/logger';
+import { RunJournal } from '../journal/RunJournal';
+import { FailureGate } from './FailureGate';
+
+export interface AnalysisOutcome {
+  diagnostics: ClangTidyDiagnostic[];
+  reportData: ReportData;
+  results: ParallelResult[];
+  rawOutput: string;
+  errorOutput: string;
+  exitCode: number;
+  duration: number;
+  // Diagnostic a fail-fast run stopped at
+  failure?: ClangTidyDiagnostic;
+}
+
+export class AnalysisEngine {
+  constructor(private runner: ClangTidyRunner, private textParser: TextParser = new TextParser()) {}
+
+  /**
+   * Analyze files and aggregate the results.
+   * With a journal, files it already holds results for are skipped and new results are recorded in it.
+   * With a fail-fast gate, every result is parsed as it arrives and the run stops at the first failing diagnostic.
+   * Diagnostics over the runner's caps are only counted (reportData.suppressed).
+   */
+  async analyze(
+    files: string[],
+    options: RunOptions,
+    onProgress?: (completed: number, total: number) => void,
+    journal?: RunJournal,
+    gate?: FailureGate
+  ): Promise<AnalysisOutcome> {
+    const startTime = Date.now();
+    const caps = this.runner.createDiagnosticCaps();
+    // Each result is parsed once, as it arrives when a gate needs it, else at the end
+    const parsed = new Map<ParallelResult, ClangTidyDiagnostic[]>();
+    const parseResult = (result: ParallelResult) => {
+      let diagnostics = parsed.get(result);
+      if (!diagnostics) {
+        diagnostics = this.parseResult(result, caps.isEnabled() ? caps : undefined);
+        parsed.set(result, diagnostics);
+      }
+      return diagnostics;
+    };
+
+    const completed = journal ? journal.getCompleted() : new Map<string, ParallelResult[]>();
+    // A file analyzed in several configurations may have some of them left; the runner skips recorded units
+    const multiUnit = completed.size > 0 && this.runner.needsUnitResolution(files);
+    const pending = files.filter(file => !completed.has(file) || multiUnit);
+    const results: ParallelResult[] = Array.from(new Set(files.flatMap(file => completed.get(file) || [])));
+    if (results.length > 0) {
+      logger.info(`Resuming run: ${files.filter(file => completed.has(file)).length} of ${files.length} files already analyzed`);
+    }
+    const record = (result: ParallelResult) => {
+      // Units that failed without output are retried when the run resumes
+      if (journal && (result.exitCode === 0 || result.rawOutput.trim())) {
+        journal.recordResult(result);
+      }
+      if (gate) {
+        gate.inspect(parseResult(result));
+      }
+    };
+    if (gate) {
+      results.forEach(result => gate.inspect(parseResult(result)));
+    }
+
+    // Use parallel processing if multiple files, or if a file needs resolving into translation units
+    if (gate?.getFailure()) {
+      logger.info('Fail-fast: resumed results already fail the run');
+    } else if (pending.length > 1 || (pending.length === 1 && this.runner.needsUnitResolution(pending))) {
+      const offset = files.length - pending.length;
+      results.push(...await this.runner.runParallel(pending, options,
+        onProgress ? (done, total) => onProgress(offset + done, offset + total) : undefined, record, gate?.getSignal(),
+        journal ? (unitFiles, configuration) => journal.isRecorded(unitFiles, configuration) : undefined));
+    } else if (pending.length === 1) {
+      // Use single file processing for better performance with small number of files
+      const result = await this.runner.runAnalysis(pending, options);
+      const parallelResult = { ...result, files: pending };
+      record(parallelResult);
+      results.push(parallelResult);
+    }
+
+    // Combine results from all tasks
+    const rawOutput = results.map(r => r.rawOutput).join('\n');
+    const errorOutput = results.map(r => r.errorOutput).join('\n');
+    const exitCode = results.some(r => r.exitCode !== 0) ? 1 : 0;
+
+    // Parse results - use text format only; caps count per translation unit, so capped runs parse result by result
+    logger.info('Using text format for parsing results');
+    const diagnostics = caps.isEnabled() || gate || results.some(r => r.configuration || r.translationUnit)
+      ? this.mergeResults(results, parseResult)
+      : this.textParser.parseClangTidyText(rawOutput);
+    const reportData = AnalysisEngine.buildReportData(diagnostics, files.length);
+    const suppressed = caps.getSuppressed();
+    if (Object.keys(suppressed).length > 0) {
+      reportData.suppressed = suppressed;
+    }
+
+    return {
+      diagnostics,
+      reportData,
+      results,
+      rawOutput,
+      errorOutput,
+      exitCode,
+      duration: Date.now() - startTime,
+      failure: gate?.getFailure() || undefined
+    };
+  }
+
+  /**
+   * Diagnostics of one result; results of translation units analyzed for headers only own those headers
+   */
+  private parseResult(result: ParallelResult, caps?: DiagnosticCaps): ClangTidyDiagnostic[] {
+    const owned = result.translationUnit ? new Set(result.files.map(file => path.normalize(file))) : null;
+    if (caps) {
+      caps.startUnit(owned);
+    }
+    const diagnostics = this.textParser.parseClangTidyText(result.rawOutput, caps);
+    return owned ? diagnostics.filter(diag => owned.has(path.normalize(diag.filePath))) : diagnostics;
+  }
+
+  /**
+   * Merge the diagnostics of each result, deduplicating those reported by several of them
+   * and tagging every diagnostic with the configurations it occurs in.
+   */
+  private mergeResults(results: ParallelResult[], parseResult: (result: ParallelResult) => ClangTidyDiagnostic[]): ClangTidyDiagnostic[] {
+    const merged = new Map<string, ClangTidyDiagnostic>();
+    for (const result of results) {
+      for (const diag of parseResult(result)) {
+        const key = [diag.filePath, diag.line, diag.column, diag.checkName, diag.message].join('\0');
+        const existing = merged.get(key);
+        const configuration = result.configuration;
+        if (!existing) {
+          merged.set(key, { ...diag, configurations: configuration ? [configuration] : undefined });
+        } else if (configuration) {
+          existing.configurations = existing.configurations || [];
+          if (!existing.configurations.includes(configuration)) {
+            existing.configurations.push(configuration);
+          }
+        }
+      }
+    }
+    return Array.from(merged.values());
+  }
+
+  /**
+   * Add up the counts of diagnostics suppressed by caps in several reports (roots, tiers)
+   */
+  static mergeSuppressed(reports: ReportData[]): ReportData['suppressed'] {
+    let merged: Record<string, Record<string, number>> | undefined;
+    for (const report of reports) {
+      for (const [file, checks] of Object.entries(report.suppressed || {})) {
+        merged = merged || {};
+        const perCheck = merged[file] = merged[file] || {};
+        for (const [check, count] of Object.entries(checks)) {
+          perCheck[check] = (perCheck[check] || 0) + count;
+        }
+      }
+    }
+    return merged;
+  }
+
+  /**
+   * Prepare report data from diagnostics
+   */
+  static buildReportData(diagnostics: ClangTidyDiagnostic[], totalFiles: number): ReportData {
+    // Count warnings by checker
+    const warningsByChecker: Record<string, number> = {};
+    diagnostics.forEach(diag => {
+      // Only count warnings with a valid check name
+      if (diag.checkName) {
+        warningsByChecker[diag.checkName] = (warningsByChecker[diag.checkName] || 0) + 1;
+      }
+    });
+
+    // Group diagnostics by file
+    const files: Record<string, ClangTidyDiagnostic[]> = {};
+    diagnostics.forEach(diag => {
+      if (!files[diag.filePath]) {
+        files[diag.filePath] = [];
+      }
+      files[diag.filePath].push(diag);
+    });
+
+    return {
+      diagnostics,
+      totalFilesChecked: totalFiles,
+      filesWithWarnings: Object.keys(files).length,
+      totalWarnings: diagnostics.length,
+      warningsByChecker,
+      files
+    };
+  }
+}
@@ -0,0 +1,155 @@
+// Check Tiers - Splits enabled checks into a fast tier shown right away and a slow tier run in the background
+import * as fs from 'fs';
+import * as path from 'path';
+import { RootSummary, RunOptions } from '../../types';
+import { logger } from '../../utils/logger';
+import { FileUtils } from '../../utils/fileUtils';
+import { AnalysisEngine, AnalysisOutcome } from './AnalysisEngine';
+
+export type CheckTier = 'fast' | 'slow';
+
+// Path-sensitive and dataflow checks, and checks known to cost far more than a typical AST matcher
+const BUILTIN_SLOW_CHECKS = [
+  'clang-analyzer-*',
+  'bugprone-unchecked-optional-access',
+  'misc-const-correctness',
+  'misc-include-cleaner',
+  'misc-confusable-identifiers'
+];
+// A profiled check taking at least this share of all check time is slow
+const SLOW_SHARE = 0.1;
+
+export class CheckTiers {
+  private patterns: RegExp[];
+
+  /**
+   * @param slowChecks Check names or globs forming the slow tier
+   */
+  constructor(private slowChecks: string[]) {
+    this.patterns = slowChecks.map(glob => new RegExp('^' + glob.replace(/[.+?^${}()|[\]\\]/g, '\\$&').replace(/\*/g, '.*') + '$'));
+  }
+
+  /**
+   * Tiers from the built-in slow checks, configured ones, and checks the stored profiles show to be expensive
+   */
+  static load(slowChecks: string[], profileDirectory: string): CheckTiers {
+    const profiled = profileDirectory ? CheckTiers.profiledSlowChecks(profileDirectory) : [];
+    return new CheckTiers(Array.from(new Set([...BUILTIN_SLOW_CHECKS, ...slowChecks, ...profiled])));
+  }
+
+  /**
+   * Checks taking a large share of check time in the profiles written by
+   * `clang-tidy --enable-check-profile --store-check-profile=<dir>`
+   */
+  static profiledSlowChecks(directory: string): string[] {
+    const totals = new Map<string, number>();
+    let files: string[];
+    try {
+      files = fs.readdirSync(directory).filter(file => file.endsWith('.json'));
+    } catch (error) {
+      logger.warn(`Failed to read check profiles from ${directory}: ${error instanceof Error ? error.message : String(error)}`);
+      return [];
+    }
+    for (const file of files) {
+      try {
+        const profile: Record<string, number> = JSON.parse(fs.readFileSync(path.join(directory, file), 'utf8')).profile || {};
+        for (const [key, seconds] of Object.entries(profile)) {
+          const match = /^time\.clang-tidy\.(.+)\.wall$/.exec(key);
+          if (match) {
+            totals.set(match[1], (totals.get(match[1]) || 0) + seconds);
+          }
+        }
+      } catch (error) {
+        logger.debug(`Skipping unreadable check profile ${file}`);
+      }
+    }
+
+    const total = Array.from(totals.values()).reduce((sum, value) => sum + value, 0);
+    const slow = Array.from(totals.entries()).filter(([, seconds]) => total > 0 && seconds / total >= SLOW_SHARE).map(([check]) => check);
+    logger.debug(`Check profiles of ${files.length} files: ${slow.length} slow checks (${slow.join(', ')})`);
+    return slow;
+  }
+
+  tierOf(check: string): CheckTier {
+    return this.patterns.some(pattern => pattern.test(check)) ? 'slow' : 'fast';
+  }
+
+  /**
+   * -checks value narrowing whatever the configuration enables to one tier.
+   * Only disabling patterns are used, so checks the configuration leaves off stay off.
+   */
+  filterFor(tier: CheckTier, availableChecks: string[]): string {
+    if (tier === 'fast') {
+      return this.slowChecks.map(check => '-' + check).join(',');
+    }
+    // Disable every fast check: whole families where possible, single checks where a family has slow ones too
+    const families = new Map<string, string[]>();
+    for (const check of availableChecks) {
+      const family = check.split('-')[0];
+      families.set(family, [...(families.get(family) || []), check]);
+    }
+    const disabled: string[] = [];
+    for (const [family, checks] of families) {
+      const fast = checks.filter(check => this.tierOf(check) === 'fast');
+      if (fast.length === checks.length) {
+        disabled.push(`-${family}-*`);
+      } else {
+        disabled.push(...fast.map(check => '-' + check));
+      }
+    }
+    return disabled.join(',');
+  }
+
+  /**
+   * Run the fast tier and, concurrently at background priority, the slow tier.
+   * The scheduler serves the fast tier first; its outcome is passed to onFastTier as soon as it is complete.
+   * Diagnostics of the merged outcome are labeled with their tier.
+   */
+  static async run(
+    analyze: (options: RunOptions, onProgress: (completed: number, total: number) => void) => Promise<AnalysisOutcome>,
+    options: RunOptions,
+    onProgress?: (completed: number, total: number) => void,
+    onFastTier?: (outcome: AnalysisOutcome) => void | Promise<void>
+  ): Promise<AnalysisOutcome> {
+    const startTime = Date.now();
+    const progress: Record<CheckTier, [number, number]> = { fast: [0, 0], slow: [0, 0] };
+    const track = (tier: CheckTier) => (completed: number, total: number) => {
+      progress[tier] = [completed, total];
+      if (onProgress) {
+        onProgress(progress.fast[0] + progress.slow[0], progress.fast[1] + progress.slow[1]);
+      }
+    };
+
+    const slowRun = analyze({ ...options, checkTier: 'slow', priority: 'background' }, track('slow'));
+    const fast = await analyze({ ...options, checkTier: 'fast' }, track('fast'));
+    fast.diagnostics.forEach(diag => diag.tier = 'fast');
+    if (onFastTier) {
+      await onFastTier(fast);
+    }
+    const slow = await slowRun;
+
+    // Compiler diagnostics are reported by both tiers
+    const slowDiagnostics = slow.diagnostics.filter(diag => !diag.checkName.startsWith('clang-diagnostic-'));
+    slowDiagnostics.forEach(diag => diag.tier = 'slow');
+    const diagnostics = [...fast.diagnostics, ...slowDiagnostics];
+    const reportData = AnalysisEngine.buildReportData(diagnostics, fast.reportData.totalFilesChecked);
+    reportData.suppressed = AnalysisEngine.mergeSuppressed([fast.reportData, slow.reportData]);
+    if (fast.reportData.roots) {
+      const rootPaths = fast.reportData.roots.map(root => root.path);
+      reportData.roots = fast.reportData.roots.map((root): RootSummary => {
+        const own = diagnostics.filter(diag => FileUtils.findRoot(diag.filePath, rootPaths) === root.path);
+        return { ...root, totalWarnings: own.length, filesWithWarnings: new Set(own.map(diag => diag.filePath)).size };
+      });
+    }
+    return {
+      diagnostics,
+      reportData,
+      results: [...fast.results, ...slow.results],
+      rawOutput: fast.rawOutput + '\n' + slow.rawOutput,
+      errorOutput: fast.errorOutput + '\n' + slow.errorOutput,
+      exitCode: fast.exitCode || slow.exitCode,
+      duration: Date.now() - startTime,
+      failure: fast.failure || slow.failure
+    };
+  }
+}
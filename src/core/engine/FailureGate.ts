@@ -0,0 +1,85 @@
+// Failure Gate - Decides which diagnostics fail a run, and stops fail-fast runs at the first of them
+import { ClangTidyDiagnostic } from '../../types';
+import { logger } from '../../utils/logger';
+
+export type FailOn = 'none' | 'error' | 'warning';
+
+// Chance that a file fails again, by what its last analysis found (unknown: never analyzed)
+const FAILURE_LIKELIHOOD = { failed: 0.9, unknown: 0.1, clean: 0.02 };
+
+export class FailureGate {
+  private severities: string[];
+  private patterns: RegExp[];
+  private controller = new AbortController();
+  private failure: ClangTidyDiagnostic | null = null;
+
+  /**
+   * @param failOn Lowest severity failing the run
+   * @param fatalChecks Checks (globs) failing the run whatever their severity
+   * @param failFast Stop the run at the first failing diagnostic
+   */
+  constructor(failOn: FailOn, fatalChecks: string[], private failFast: boolean) {
+    this.severities = failOn === 'warning' ? ['warning', 'error', 'fatal'] : failOn === 'error' ? ['error', 'fatal'] : [];
+    this.patterns = fatalChecks.map(glob => new RegExp('^' + glob.replace(/[.+?^${}()|[\]\\]/g, '\\$&').replace(/\*/g, '.*') + '$'));
+  }
+
+  matches(diag: Pick<ClangTidyDiagnostic, 'severity' | 'checkName'>): boolean {
+    return this.severities.includes(diag.severity) ||
+      diag.checkName.split(',').some(check => this.patterns.some(pattern => pattern.test(check)));
+  }
+
+  /**
+   * Whether a run with these diagnostics fails (always after a fail-fast stop)
+   */
+  fails(diagnostics: ClangTidyDiagnostic[]): boolean {
+    return this.failure !== null || diagnostics.some(diag => this.matches(diag));
+  }
+
+  /**
+   * Look at the diagnostics of a finished translation unit as soon as it arrives.
+   * In fail-fast mode the first failing one is kept and the run is aborted.
+   */
+  inspect(diagnostics: ClangTidyDiagnostic[]): void {
+    if (!this.failFast || this.failure) {
+      return;
+    }
+    const failing = diagnostics.find(diag => this.matches(diag));
+    if (failing) {
+      this.failure = failing;
+      logger.info(`Fail-fast: ${failing.filePath}:${failing.line}: ${failing.checkName}, stopping the run`);
+      this.controller.abort();
+    }
+  }
+
+  /**
+   * Signal aborted at the first failure of a fail-fast run
+   */
+  getSignal(): AbortSignal | undefined {
+    return this.failFast ? this.controller.signal : undefined;
+  }
+
+  getFailure(): ClangTidyDiagnostic | null {
+    return this.failure;
+  }
+
+  /**
+   * Order files so the likely offenders run first. Files are ranked by failure likelihood per unit of cost,
+   * which minimizes the expected time to the first failure; likelihood comes from what the last analysis
+   * of the file found ("<severity> <check>" entries from the history).
+   */
+  orderByLikelyFailure(files: string[], findingsOf: (file: string) => string[] | undefined, costOf: (file: string) => number): string[] {
+    const likelihood = (file: string) => {
+      const findings = findingsOf(file);
+      if (!findings) {
+        return FAILURE_LIKELIHOOD.unknown;
+      }
+      const failed = findings.some(finding => {
+        const [severity, checkName] = finding.split(' ');
+        return this.matches({ severity: severity as ClangTidyDiagnostic['severity'], checkName: checkName || '' });
+      });
+      return failed ? FAILURE_LIKELIHOOD.failed : FAILURE_LIKELIHOOD.clean;
+    };
+    const rank = new Map(files.map(file => [file, likelihood(file) / Math.max(costOf(file), 1)]));
+    return [...files].sort((a, b) => rank.get(b)! - rank.get(a)!);
+  }
+}
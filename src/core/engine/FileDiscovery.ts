@@ -0,0 +1,70 @@
+// File Discovery - Finds translation units to analyze (no VS Code dependency)
+import * as fs from 'fs';
+import * as path from 'path';
+import { CompileDatabase } from '../compiledb/CompileDatabase';
+import { logger } from '../../utils/logger';
+
+export const SOURCE_EXTENSIONS = ['.cpp', '.c', '.hpp', '.h', '.cxx', '.cc', '.hh', '.hxx'];
+
+// Directories skipped by default during discovery
+export const DEFAULT_IGNORED_DIRECTORIES = ['node_modules', 'build', 'out', 'third_party'];
+
+export class FileDiscovery {
+  /**
+   * Get the distinct files listed in a compile database
+   */
+  static fromCompileDatabase(compileCommandsPath: string, ignoredDirectories: string[] = DEFAULT_IGNORED_DIRECTORIES): string[] {
+    const database = CompileDatabase.load(compileCommandsPath);
+    // Enhanced ignore pattern - similar to other scopes
+    const ignorePatterns = ignoredDirectories.map(dir => new RegExp(dir.replace(/[.*+?^${}()|[\]\\]/g, '\\$&'), 'i'));
+
+    const files: string[] = [];
+    for (const file of database.getFiles()) {
+      // Check if file path matches any ignore pattern
+      if (ignorePatterns.some(pattern => pattern.test(file))) {
+        logger.debug(`Ignoring file from compile database: ${file}`);
+        continue;
+      }
+      files.push(file);
+    }
+
+    logger.debug(`Found ${files.length} files in compile_commands.json after filtering`);
+    return files;
+  }
+
+  /**
+   * Recursively find C/C++ files below a directory
+   */
+  static fromDirectory(directory: string, ignoredDirectories: string[] = DEFAULT_IGNORED_DIRECTORIES): string[] {
+    const files: string[] = [];
+
+    const searchRecursively = (dir: string) => {
+      let entries: fs.Dirent[];
+      try {
+        entries = fs.readdirSync(dir, { withFileTypes: true });
+      } catch (error) {
+        logger.error(`Error reading directory ${dir}: ${error}`);
+        return;
+      }
+
+      for (const entry of entries) {
+        const fullPath = path.join(dir, entry.name);
+
+        if (entry.isDirectory()) {
+          // Skip ignored directories
+          if (ignoredDirectories.includes(entry.name)) {
+            logger.debug(`Skipping ignored directory: ${fullPath}`);
+            continue;
+          }
+          searchRecursively(fullPath);
+        } else if (entry.isFile() && SOURCE_EXTENSIONS.includes(path.extname(entry.name).toLowerCase())) {
+          files.push(fullPath);
+        }
+      }
+    };
+
+    searchRecursively(directory);
+    logger.debug(`Found ${files.length} C/C++ files in ${directory}`);
+    return files;
+  }
+}
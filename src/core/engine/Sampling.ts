@@ -0,0 +1,186 @@
+// Sampling - Stratified, cost-aware samples of translation units and extrapolated warning counts
+import * as path from 'path';
+import { ClangTidyDiagnostic, SampleEstimate, SamplingSummary } from '../../types';
+
+// Directory levels below the root forming a stratum (e.g. src/core)
+const STRATUM_DEPTH = 2;
+// Normal quantile of the 95% confidence intervals
+const Z_95 = 1.96;
+
+interface Stratum {
+  name: string;
+  files: string[];
+  sampled: string[];
+}
+
+export interface SamplePlan {
+  root: string;
+  // Requested share of the full run's cost
+  fraction: number;
+  // Estimated cost of the sampled files and of all files
+  sampledCost: number;
+  totalCost: number;
+  strata: Stratum[];
+}
+
+export class Sampling {
+  /**
+   * Parse a sample size given as a percentage ("2%") or a fraction ("0.02")
+   */
+  static parseFraction(spec: string): number {
+    const value = spec.trim().endsWith('%') ? parseFloat(spec) / 100 : parseFloat(spec);
+    if (!(value > 0 && value <= 1)) {
+      throw new Error(`Invalid sample size '${spec}', expected a percentage such as 2% or a fraction such as 0.02`);
+    }
+    return value;
+  }
+
+  /**
+   * Draw a stratified random sample costing about `fraction` of the full run.
+   * Strata are directories; each gets n_h ∝ N_h / sqrt(mean cost), the allocation minimizing the
+   * variance for a fixed cost budget, and at least two files (where it has them) so its variance
+   * can be estimated. Strata held at that minimum or at all their files are taken out of the
+   * allocation, and the rest of the budget is shared among the others. The same seed and file list
+   * give the same sample.
+   */
+  static select(files: string[], root: string, fraction: number, costOf: (file: string) => number, seed: number = 1): SamplePlan {
+    const groups = new Map<string, string[]>();
+    for (const file of Array.from(new Set(files)).sort()) {
+      const name = Sampling.stratumOf(file, root);
+      groups.set(name, [...(groups.get(name) || []), file]);
+    }
+
+    const cost = (file: string) => Math.max(costOf(file), 1e-6);
+    const strata = Array.from(groups.entries()).map(([name, members]) => {
+      const meanCost = members.reduce((sum, file) => sum + cost(file), 0) / members.length;
+      return { name, files: members, meanCost, weight: members.length / Math.sqrt(meanCost), minimum: Math.min(2, members.length) };
+    });
+    const totalCost = strata.reduce((sum, stratum) => sum + stratum.meanCost * stratum.files.length, 0);
+    const budget = fraction * totalCost;
+
+    // Σ n_h c_h = budget with n_h = k * weight_h over the strata not fixed at their minimum or size
+    const fixed = new Map<typeof strata[number], number>();
+    let k = 0;
+    for (;;) {
+      const free = strata.filter(stratum => !fixed.has(stratum));
+      const remaining = budget - Array.from(fixed.entries()).reduce((sum, [stratum, size]) => sum + size * stratum.meanCost, 0);
+      const scale = free.reduce((sum, stratum) => sum + stratum.weight * stratum.meanCost, 0);
+      k = scale > 0 ? Math.max(remaining, 0) / scale : 0;
+      const bounded = free.filter(stratum => k * stratum.weight < stratum.minimum || k * stratum.weight > stratum.files.length);
+      if (bounded.length === 0) {
+        break;
+      }
+      for (const stratum of bounded) {
+        fixed.set(stratum, k * stratum.weight < stratum.minimum ? stratum.minimum : stratum.files.length);
+      }
+    }
+
+    const random = Sampling.random(seed);
+    let sampledCost = 0;
+    const sampledStrata = strata.map(stratum => {
+      const size = fixed.get(stratum) ?? Math.min(stratum.files.length, Math.max(stratum.minimum, Math.round(k * stratum.weight)));
+      // Partial Fisher-Yates shuffle
+      const pool = [...stratum.files];
+      for (let i = 0; i < size; i++) {
+        const j = i + Math.floor(random() * (pool.length - i));
+        [pool[i], pool[j]] = [pool[j], pool[i]];
+      }
+      const sampled = pool.slice(0, size);
+      sampledCost += sampled.reduce((sum, file) => sum + cost(file), 0);
+      return { name: stratum.name, files: stratum.files, sampled };
+    });
+    return { root, fraction, sampledCost, totalCost, strata: sampledStrata };
+  }
+
+  /**
+   * Files to analyze for a plan
+   */
+  static files(plan: SamplePlan): string[] {
+    return plan.strata.flatMap(stratum => stratum.sampled);
+  }
+
+  /**
+   * Extrapolate the diagnostics found in the sampled sources to all files, per check and per directory,
+   * with the stratified expansion estimator and its 95% confidence interval.
+   * Diagnostics in headers are shared between translation units, so they are reported as observed only.
+   */
+  static estimate(plan: SamplePlan, diagnostics: ClangTidyDiagnostic[]): SamplingSummary {
+    const sampled = new Set(Sampling.files(plan).map(file => path.normalize(file)));
+    // File -> check -> count
+    const counts = new Map<string, Map<string, number>>();
+    let headerDiagnostics = 0;
+    for (const diag of diagnostics) {
+      const file = path.normalize(diag.filePath);
+      if (!sampled.has(file)) {
+        headerDiagnostics++;
+        continue;
+      }
+      const perCheck = counts.get(file) || new Map<string, number>();
+      perCheck.set(diag.checkName, (perCheck.get(diag.checkName) || 0) + 1);
+      counts.set(file, perCheck);
+    }
+
+    const checks = Array.from(new Set(Array.from(counts.values()).flatMap(perCheck => Array.from(perCheck.keys())))).sort();
+    const valuesOf = (stratum: Stratum, check: string | null) => stratum.sampled.map(file => {
+      const perCheck = counts.get(path.normalize(file));
+      if (!perCheck) {
+        return 0;
+      }
+      return check === null ? Array.from(perCheck.values()).reduce((sum, value) => sum + value, 0) : perCheck.get(check) || 0;
+    });
+    const combine = (name: string, strata: Stratum[], check: string | null): SampleEstimate => {
+      let observed = 0;
+      let estimate = 0;
+      let variance = 0;
+      for (const stratum of strata) {
+        const values = valuesOf(stratum, check);
+        const n = values.length;
+        const N = stratum.files.length;
+        if (n === 0) {
+          continue;
+        }
+        const sum = values.reduce((total, value) => total + value, 0);
+        const mean = sum / n;
+        const s2 = n > 1 ? values.reduce((total, value) => total + (value - mean) ** 2, 0) / (n - 1) : 0;
+        observed += sum;
+        estimate += N * mean;
+        variance += N * N * (1 - n / N) * s2 / n;
+      }
+      const margin = Z_95 * Math.sqrt(variance);
+      return { name, observed, estimate: Math.round(estimate), low: Math.round(Math.max(observed, estimate - margin)), high: Math.round(estimate + margin) };
+    };
+
+    return {
+      fraction: plan.fraction,
+      costShare: plan.totalCost > 0 ? plan.sampledCost / plan.totalCost : 1,
+      sampledFiles: sampled.size,
+      totalFiles: plan.strata.reduce((sum, stratum) => sum + stratum.files.length, 0),
+      headerDiagnostics,
+      total: combine('', plan.strata, null),
+      byCheck: checks.map(check => combine(check, plan.strata, check)).sort((a, b) => b.estimate - a.estimate),
+      byDirectory: plan.strata.map(stratum => combine(stratum.name, [stratum], null)).sort((a, b) => b.estimate - a.estimate)
+    };
+  }
+
+  private static stratumOf(file: string, root: string): string {
+    const relative = path.relative(root, path.dirname(file)).replace(/\\/g, '/');
+    if (relative.startsWith('..') || path.isAbsolute(relative)) {
+      return path.dirname(file);
+    }
+    return relative.split('/').filter(Boolean).slice(0, STRATUM_DEPTH).join('/') || '.';
+  }
+
+  /**
+   * Small deterministic PRNG (mulberry32)
+   */
+  private static random(seed: number): () => number {
+    let state = seed >>> 0;
+    return () => {
+      state = (state + 0x6D2B79F5) >>> 0;
+      let t = state;
+      t = Math.imul(t ^ (t >>> 15), t | 1);
+      t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+      return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+    };
+  }
+}
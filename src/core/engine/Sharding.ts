@@ -0,0 +1,58 @@
+// Sharding - Deterministic cost-balanced partitioning of translation units
+export interface ShardSpec {
+  // 1-based shard index
+  index: number;
+  count: number;
+}
+
+export class Sharding {
+  /**
+   * Parse "i/N" (1-based, e.g. "3/16")
+   */
+  static parse(spec: string): ShardSpec {
+    const match = /^(\d+)\/(\d+)$/.exec(spec.trim());
+    if (!match) {
+      throw new Error(`Invalid shard '${spec}', expected i/N such as 1/16`);
+    }
+    const index = parseInt(match[1], 10);
+    const count = parseInt(match[2], 10);
+    if (count < 1 || index < 1 || index > count) {
+      throw new Error(`Invalid shard '${spec}': index must be between 1 and ${count}`);
+    }
+    return { index, count };
+  }
+
+  /**
+   * Split files into `count` shards with balanced total cost.
+   * Longest-processing-time-first greedy assignment; ties are broken by path and shard
+   * index, so every runner computes the same partition from the same file list and history.
+   */
+  static partition(files: string[], count: number, costOf: (file: string) => number): string[][] {
+    const shards: string[][] = Array.from({ length: count }, () => []);
+    const loads = new Array<number>(count).fill(0);
+
+    const ordered = Array.from(new Set(files))
+      .map(file => ({ file, cost: Math.max(0, costOf(file)) }))
+      .sort((a, b) => b.cost - a.cost || (a.file < b.file ? -1 : a.file > b.file ? 1 : 0));
+
+    for (const { file, cost } of ordered) {
+      let target = 0;
+      for (let i = 1; i < count; i++) {
+        if (loads[i] < loads[target]) {
+          target = i;
+        }
+      }
+      shards[target].push(file);
+      loads[target] += cost;
+    }
+
+    return shards;
+  }
+
+  /**
+   * Files of one shard
+   */
+  static select(files: string[], shard: ShardSpec, costOf: (file: string) => number): string[] {
+    return this.partition(files, shard.count, costOf)[shard.index - 1];
+  }
+}
@@ -0,0 +1,134 @@
+// Snapshot - Mergeable, self-contained result of an analysis run or shard
+import * as path from 'path';
+import { ClangTidyDiagnostic } from '../../types';
+import { FileUtils } from '../../utils/fileUtils';
+import { AnalysisOutcome } from './AnalysisEngine';
+import { ShardSpec } from './Sharding';
+
+const SNAPSHOT_FORMAT_VERSION = 1;
+
+export interface AnalysisSnapshot {
+  version: number;
+  createdAt: string;
+  // Root the relative paths below refer to
+  root: string;
+  shard?: ShardSpec;
+  // Analyzed files, relative to root
+  files: string[];
+  // Analysis time per file in milliseconds, relative paths; files served from a cache are left out
+  durations: Record<string, number>;
+  wallTimeMs: number;
+  diagnostics: ClangTidyDiagnostic[];
+  // Diagnostics over the caps per file (relative) and check
+  suppressed?: Record<string, Record<string, number>>;
+}
+
+export class Snapshot {
+  /**
+   * Create a snapshot from an analysis outcome
+   */
+  static fromOutcome(root: string, files: string[], outcome: AnalysisOutcome, shard?: ShardSpec): AnalysisSnapshot {
+    const durations: Record<string, number> = {};
+    for (const result of outcome.results) {
+      if (result.cached) {
+        continue;
+      }
+      for (const file of result.files) {
+        durations[this.relativize(root, file)] = result.duration / result.files.length;
+      }
+    }
+
+    return {
+      version: SNAPSHOT_FORMAT_VERSION,
+      createdAt: new Date().toISOString(),
+      root,
+      shard,
+      files: files.map(file => this.relativize(root, file)),
+      durations,
+      wallTimeMs: outcome.duration,
+      diagnostics: outcome.diagnostics.map(diag => ({ ...diag, filePath: this.relativize(root, diag.filePath) })),
+      suppressed: outcome.reportData.suppressed ? Object.fromEntries(Object.entries(outcome.reportData.suppressed)
+        .map(([file, checks]) => [this.relativize(root, file), checks])) : undefined
+    };
+  }
+
+  /**
+   * Read a snapshot file
+   */
+  static read(filePath: string): AnalysisSnapshot {
+    const snapshot = FileUtils.readJson<AnalysisSnapshot>(filePath);
+    if (snapshot.version !== SNAPSHOT_FORMAT_VERSION) {
+      throw new Error(`Unsupported snapshot version ${snapshot.version} in ${filePath}`);
+    }
+    return snapshot;
+  }
+
+  /**
+   * Write a snapshot file
+   */
+  static write(filePath: string, snapshot: AnalysisSnapshot): void {
+    FileUtils.writeJson(filePath, snapshot, false);
+  }
+
+  /**
+   * Combine partial snapshots. Files and diagnostics reported by several shards
+   * (e.g. the same header seen from two TUs) are kept once.
+   */
+  static merge(snapshots: AnalysisSnapshot[], root: string): AnalysisSnapshot {
+    const files = new Set<string>();
+    const durations: Record<string, number> = {};
+    const seen = new Set<string>();
+    const diagnostics: ClangTidyDiagnostic[] = [];
+    const suppressed: Record<string, Record<string, number>> = {};
+    let wallTimeMs = 0;
+
+    for (const snapshot of snapshots) {
+      snapshot.files.forEach(file => files.add(file));
+      Object.assign(durations, snapshot.durations);
+      wallTimeMs = Math.max(wallTimeMs, snapshot.wallTimeMs);
+      for (const [file, checks] of Object.entries(snapshot.suppressed || {})) {
+        for (const [check, count] of Object.entries(checks)) {
+          suppressed[file] = { ...suppressed[file], [check]: (suppressed[file]?.[check] || 0) + count };
+        }
+      }
+
+      for (const diag of snapshot.diagnostics) {
+        const key = [diag.filePath, diag.line, diag.column, diag.severity, diag.checkName, diag.message].join('\0');
+        if (!seen.has(key)) {
+          seen.add(key);
+          diagnostics.push(diag);
+        }
+      }
+    }
+
+    return {
+      version: SNAPSHOT_FORMAT_VERSION,
+      createdAt: new Date().toISOString(),
+      root,
+      files: Array.from(files).sort(),
+      durations,
+      wallTimeMs,
+      diagnostics,
+      suppressed: Object.keys(suppressed).length > 0 ? suppressed : undefined
+    };
+  }
+
+  /**
+   * Diagnostics with paths resolved against a root (for reports)
+   */
+  static absoluteDiagnostics(snapshot: AnalysisSnapshot, root: string): ClangTidyDiagnostic[] {
+    return snapshot.diagnostics.map(diag => ({ ...diag, filePath: this.absolutize(root, diag.filePath) }));
+  }
+
+  /**
+   * Resolve a snapshot-relative path against a root
+   */
+  static absolutize(root: string, file: string): string {
+    return path.isAbsolute(file) || /^[a-zA-Z]:[\\/]/.test(file) ? file : path.join(root, file);
+  }
+
+  private static relativize(root: string, file: string): string {
+    const relative = path.relative(root, file);
+    return relative.startsWith('..') || path.isAbsolute(relative) ? file : relative.replace(/\\/g, '/');
+  }
+}
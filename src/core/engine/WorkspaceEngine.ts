@@ -0,0 +1,68 @@
+// Workspace Engine - Analyzes several workspace roots through one shared pool and combines the results
+import * as path from 'path';
+import { ParallelResult, RootSummary, RunOptions } from '../../types';
+import { ClangTidyRunner } from '../runner/ClangTidyRunner';
+import { TextParser } from '../parser/TextParser';
+import { RunJournal } from '../journal/RunJournal';
+import { AnalysisEngine, AnalysisOutcome } from './AnalysisEngine';
+
+// Files of one root and the runner configured for it (own compile database, config and cache)
+export interface RootAnalysis {
+  root: string;
+  runner: ClangTidyRunner;
+  files: string[];
+}
+
+export class WorkspaceEngine {
+  constructor(private textParser: TextParser = new TextParser()) {}
+
+  /**
+   * Analyze all roots concurrently. Their tasks are tagged with the root,
+   * so the shared scheduler serves the roots in turn.
+   */
+  async analyze(
+    roots: RootAnalysis[],
+    options: RunOptions,
+    onProgress?: (completed: number, total: number) => void,
+    journal?: RunJournal
+  ): Promise<AnalysisOutcome> {
+    if (roots.length === 1) {
+      return new AnalysisEngine(roots[0].runner, this.textParser).analyze(roots[0].files, options, onProgress, journal);
+    }
+
+    const startTime = Date.now();
+    const total = roots.reduce((sum, root) => sum + root.files.length, 0);
+    const progress = new Map<string, number>();
+
+    const outcomes = await Promise.all(roots.map(root =>
+      new AnalysisEngine(root.runner, this.textParser).analyze(root.files, options, completed => {
+        progress.set(root.root, completed);
+        if (onProgress) {
+          onProgress(Array.from(progress.values()).reduce((sum, value) => sum + value, 0), total);
+        }
+      }, journal)
+    ));
+
+    const diagnostics = outcomes.flatMap(outcome => outcome.diagnostics);
+    const results: ParallelResult[] = outcomes.flatMap(outcome => outcome.results);
+    const reportData = AnalysisEngine.buildReportData(diagnostics, total);
+    reportData.roots = roots.map((root, index): RootSummary => ({
+      name: path.basename(root.root),
+      path: root.root,
+      totalFilesChecked: root.files.length,
+      filesWithWarnings: outcomes[index].reportData.filesWithWarnings,
+      totalWarnings: outcomes[index].reportData.totalWarnings
+    }));
+    reportData.suppressed = AnalysisEngine.mergeSuppressed(outcomes.map(outcome => outcome.reportData));
+
+    return {
+      diagnostics,
+      reportData,
+      results,
+      rawOutput: outcomes.map(outcome => outcome.rawOutput).join('\n'),
+      errorOutput: outcomes.map(outcome => outcome.errorOutput).join('\n'),
+      exitCode: outcomes.some(outcome => outcome.exitCode !== 0) ? 1 : 0,
+      duration: Date.now() - startTime
+    };
+  }
+}
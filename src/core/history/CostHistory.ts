@@ -0,0 +1,146 @@
+// Cost History - Per-TU analysis cost and run history (no VS Code dependency)
+import * as path from 'path';
+import { FileUtils } from '../../utils/fileUtils';
+import { logger } from '../../utils/logger';
+
+const HISTORY_FORMAT_VERSION = 1;
+// Number of run summaries kept
+const MAX_RUNS = 50;
+
+export interface FileCost {
+  // Exponentially smoothed analysis time in milliseconds
+  durationMs: number;
+  samples: number;
+}
+
+export interface RunSummary {
+  timestamp: string;
+  files: number;
+  diagnostics: number;
+  wallTimeMs: number;
+  cpuTimeMs: number;
+  shards?: number;
+}
+
+interface HistoryFile {
+  version: number;
+  files: Record<string, FileCost>;
+  runs: RunSummary[];
+  // Distinct "<severity> <check>" pairs the last analysis of each file reported
+  findings?: Record<string, string[]>;
+}
+
+export class CostHistory {
+  private data: HistoryFile = { version: HISTORY_FORMAT_VERSION, files: {}, runs: [] };
+
+  /**
+   * @param filePath JSON file backing the history
+   * @param root Files are keyed relative to this directory so checkouts at different paths share costs
+   */
+  constructor(private filePath: string, private root: string) {
+    if (FileUtils.exists(filePath)) {
+      try {
+        const loaded = FileUtils.readJson<HistoryFile>(filePath);
+        if (loaded.version === HISTORY_FORMAT_VERSION) {
+          this.data = loaded;
+        }
+      } catch (error) {
+        logger.warn(`Ignoring unreadable cost history ${filePath}: ${error instanceof Error ? error.message : String(error)}`);
+      }
+    }
+  }
+
+  /**
+   * Get the recorded cost of a file, if any
+   */
+  getCost(file: string): number | undefined {
+    return this.data.files[this.key(file)]?.durationMs;
+  }
+
+  /**
+   * Cost estimator for scheduling: recorded cost, else the prior (e.g. build time) scaled to analysis time,
+   * else the mean of known costs
+   */
+  getEstimator(prior?: (file: string) => number | undefined): (file: string) => number {
+    const known = Object.values(this.data.files).map(entry => entry.durationMs);
+    const fallback = known.length > 0 ? known.reduce((sum, value) => sum + value, 0) / known.length : 1;
+    if (!prior) {
+      return (file: string) => this.getCost(file) ?? fallback;
+    }
+
+    // Ratio of analysis to prior over the files where both are known
+    let recorded = 0;
+    let estimated = 0;
+    for (const key of Object.keys(this.data.files)) {
+      const value = prior(path.resolve(this.root, key));
+      if (value !== undefined) {
+        recorded += this.data.files[key].durationMs;
+        estimated += value;
+      }
+    }
+    const scale = recorded > 0 && estimated > 0 ? recorded / estimated : 1;
+    return (file: string) => {
+      const value = prior(file);
+      return this.getCost(file) ?? (value !== undefined ? value * scale : fallback);
+    };
+  }
+
+  /**
+   * Record a measured analysis time
+   */
+  recordCost(file: string, durationMs: number): void {
+    // Units that never ran report zero time; they say nothing about the real cost
+    if (durationMs <= 0) {
+      return;
+    }
+    const key = this.key(file);
+    const previous = this.data.files[key];
+    this.data.files[key] = previous
+      ? { durationMs: previous.durationMs * 0.5 + durationMs * 0.5, samples: previous.samples + 1 }
+      : { durationMs, samples: 1 };
+  }
+
+  /**
+   * Record what the analysis of a file reported, replacing the previous findings
+   */
+  recordFindings(file: string, diagnostics: Array<{ severity: string; checkName: string }>): void {
+    this.data.findings = this.data.findings || {};
+    this.data.findings[this.key(file)] = Array.from(new Set(diagnostics.map(diag => `${diag.severity} ${diag.checkName}`))).sort();
+  }
+
+  /**
+   * Get the findings of the last analysis of a file, if it was recorded
+   */
+  getFindings(file: string): string[] | undefined {
+    return this.data.findings?.[this.key(file)];
+  }
+
+  /**
+   * Append a run summary
+   */
+  recordRun(summary: RunSummary): void {
+    this.data.runs.push(summary);
+    if (this.data.runs.length > MAX_RUNS) {
+      this.data.runs.splice(0, this.data.runs.length - MAX_RUNS);
+    }
+  }
+
+  /**
+   * Get recorded run summaries, oldest first
+   */
+  getRuns(): RunSummary[] {
+    return this.data.runs;
+  }
+
+  /**
+   * Persist the history
+   */
+  save(): void {
+    FileUtils.writeJson(this.filePath, this.data, false);
+  }
+
+  private key(file: string): string {
+    const relative = path.relative(this.root, file);
+    return (relative.startsWith('..') || path.isAbsolute(relative) ? file : relative).replace(/\\/g, '/');
+  }
+}
@@ -0,0 +1,194 @@
+// Run Journal - Append-only, crash-safe record of a running analysis for resume after interruption
+import * as fs from 'fs';
+import * as path from 'path';
+import { ParallelResult, RunOptions } from '../../types';
+import { logger } from '../../utils/logger';
+
+const JOURNAL_FORMAT_VERSION = 2;
+// Upper bound on results that may be lost on a crash: data is flushed to disk at least this often
+const SYNC_INTERVAL_MS = 1000;
+
+export interface JournalHeader {
+  type: 'start';
+  version: number;
+  createdAt: string;
+  // Scope label shown when offering to resume
+  scope: string;
+  files: string[];
+  options: RunOptions;
+  // Other settings the results depend on, compared before resuming
+  settings?: Record<string, unknown>;
+}
+
+type JournalRecord =
+  | JournalHeader
+  | { type: 'result'; result: ParallelResult }
+  | { type: 'end' };
+
+export class RunJournal {
+  private fd: number;
+  private lastSync = 0;
+  // Results by file; a file analyzed in several configurations (distinct and union policies) has one per unit
+  private completed = new Map<string, ParallelResult[]>();
+  private units = new Set<string>();
+
+  private constructor(private filePath: string, private header: JournalHeader, append: boolean) {
+    fs.mkdirSync(path.dirname(filePath), { recursive: true });
+    this.fd = fs.openSync(filePath, append ? 'a' : 'w');
+  }
+
+  /**
+   * Start a new journal, replacing any previous one at the same path
+   */
+  static create(filePath: string, scope: string, files: string[], options: RunOptions, settings?: Record<string, unknown>): RunJournal {
+    const header: JournalHeader = {
+      type: 'start',
+      version: JOURNAL_FORMAT_VERSION,
+      createdAt: new Date().toISOString(),
+      scope,
+      files,
+      options,
+      settings
+    };
+    const journal = new RunJournal(filePath, header, false);
+    journal.append(header, true);
+    return journal;
+  }
+
+  /**
+   * Open an unfinished journal to resume it. Returns null if there is nothing to resume.
+   * A torn last line (crash in the middle of a write) is ignored.
+   */
+  static open(filePath: string): RunJournal | null {
+    let content: string;
+    try {
+      content = fs.readFileSync(filePath, 'utf8');
+    } catch (error) {
+      return null;
+    }
+
+    let header: JournalHeader | null = null;
+    const results: ParallelResult[] = [];
+    for (const line of content.split('\n')) {
+      if (!line.trim()) {
+        continue;
+      }
+      let record: JournalRecord;
+      try {
+        record = JSON.parse(line) as JournalRecord;
+      } catch (error) {
+        logger.debug(`Ignoring incomplete journal record in ${filePath}`);
+        continue;
+      }
+      if (record.type === 'start') {
+        header = record.version === JOURNAL_FORMAT_VERSION ? record : null;
+      } else if (record.type === 'result' && header) {
+        results.push(record.result);
+      } else if (record.type === 'end') {
+        return null;
+      }
+    }
+
+    if (!header) {
+      return null;
+    }
+
+    // Make sure the next record starts on its own line even after a torn write
+    if (content.length > 0 && !content.endsWith('\n')) {
+      fs.appendFileSync(filePath, '\n');
+    }
+    const journal = new RunJournal(filePath, header, true);
+    results.forEach(result => journal.remember(result));
+    return journal;
+  }
+
+  /**
+   * Identity of a file analyzed in a configuration
+   */
+  private static unitKey(file: string, configuration?: string): string {
+    return `${configuration || ''}\0${file}`;
+  }
+
+  getHeader(): JournalHeader {
+    return this.header;
+  }
+
+  /**
+   * Results recorded so far, by file
+   */
+  getCompleted(): Map<string, ParallelResult[]> {
+    return this.completed;
+  }
+
+  /**
+   * Whether every file of a unit has a result in the unit's configuration
+   */
+  isRecorded(files: string[], configuration?: string): boolean {
+    return files.every(file => this.units.has(RunJournal.unitKey(file, configuration)));
+  }
+
+  /**
+   * Files of the run without any recorded result
+   */
+  getRemaining(): string[] {
+    return this.header.files.filter(file => !this.completed.has(file));
+  }
+
+  /**
+   * Record the result of one task
+   */
+  recordResult(result: ParallelResult): void {
+    this.remember(result);
+    this.append({ type: 'result', result }, false);
+  }
+
+  private remember(result: ParallelResult): void {
+    for (const file of result.files) {
+      const key = RunJournal.unitKey(file, result.configuration);
+      if (!this.units.has(key)) {
+        this.units.add(key);
+        this.completed.set(file, [...(this.completed.get(file) || []), result]);
+      }
+    }
+  }
+
+  /**
+   * Mark the run complete and remove the journal
+   */
+  finish(): void {
+    this.append({ type: 'end' }, true);
+    this.close();
+    this.discard();
+  }
+
+  /**
+   * Remove the journal without resuming
+   */
+  discard(): void {
+    this.close();
+    fs.rmSync(this.filePath, { force: true });
+  }
+
+  private append(record: JournalRecord, sync: boolean): void {
+    if (this.fd < 0) {
+      return;
+    }
+    // One write per record keeps records whole unless the process dies mid-write
+    fs.writeSync(this.fd, JSON.stringify(record) + '\n');
+    const now = Date.now();
+    if (sync || now - this.lastSync >= SYNC_INTERVAL_MS) {
+      fs.fdatasyncSync(this.fd);
+      this.lastSync = now;
+    }
+  }
+
+  /**
+   * Stop writing; the journal stays on disk for a later resume
+   */
+  close(): void {
+    if (this.fd >= 0) {
+      fs.closeSync(this.fd);
+      this.fd = -1;
+    }
+  }
+}
@@ -0,0 +1,270 @@
+// Clangd Session - Live analysis through a clangd process that keeps ASTs and preambles warm
+import * as child_process from 'child_process';
+import * as fs from 'fs';
+import * as path from 'path';
+import { fileURLToPath, pathToFileURL } from 'url';
+import { ClangTidyDiagnostic } from '../../types';
+import { logger } from '../../utils/logger';
+
+export interface ClangdOptions {
+  clangdPath: string;
+  // Directory containing compile_commands.json
+  compileCommandsDir: string;
+  workspaceRoot: string;
+}
+
+// clangd publishes diagnostics once the main file is built; the first build of a file includes its preamble
+const DIAGNOSTICS_TIMEOUT_MS = 120000;
+
+interface LspDiagnostic {
+  range: { start: { line: number; character: number } };
+  severity?: number;
+  code?: string | number;
+  source?: string;
+  message: string;
+}
+
+interface DiagnosticsWaiter {
+  version: number;
+  resolve: (diagnostics: ClangTidyDiagnostic[]) => void;
+  reject: (error: Error) => void;
+}
+
+export class ClangdSession {
+  private nextId = 1;
+  private requests = new Map<number, { resolve: (result: any) => void; reject: (error: Error) => void }>();
+  private buffer = Buffer.alloc(0);
+  private documents = new Map<string, { version: number; text: string }>();
+  private published = new Map<string, { version?: number; diagnostics: ClangTidyDiagnostic[] }>();
+  private waiters = new Map<string, DiagnosticsWaiter[]>();
+  private exited = false;
+
+  private constructor(private child: child_process.ChildProcess) {
+    child.stdout!.on('data', (chunk: Buffer) => this.receive(chunk));
+    child.stderr!.on('data', (chunk: Buffer) => logger.debug(`clangd: ${chunk.toString().trimEnd()}`));
+    child.on('exit', code => this.fail(new Error(`clangd exited with code ${code}`)));
+    child.on('error', error => this.fail(error));
+  }
+
+  /**
+   * Spawn clangd with clang-tidy enabled and complete the LSP handshake.
+   * Checks come from the .clang-tidy files of the project, as for clang-tidy itself.
+   */
+  static async start(options: ClangdOptions): Promise<ClangdSession> {
+    const child = child_process.spawn(options.clangdPath, [
+      '--clang-tidy',
+      '--compile-commands-dir=' + options.compileCommandsDir,
+      '--background-index=false',
+      '--pch-storage=memory',
+      '--log=error'
+    ], { cwd: options.workspaceRoot, stdio: ['pipe', 'pipe', 'pipe'] });
+
+    const session = new ClangdSession(child);
+    await session.request('initialize', {
+      processId: process.pid,
+      rootUri: pathToFileURL(options.workspaceRoot).href,
+      capabilities: { textDocument: { publishDiagnostics: { versionSupport: true } } }
+    });
+    session.notify('initialized', {});
+    logger.info(`clangd live session started (${options.clangdPath})`);
+    return session;
+  }
+
+  isAlive(): boolean {
+    return !this.exited;
+  }
+
+  /**
+   * Analyze a file with the given content (the editor buffer, or the file on disk if omitted).
+   * Unchanged open files return their last diagnostics; changed ones are rebuilt on the warm preamble.
+   */
+  async analyze(filePath: string, text?: string): Promise<ClangTidyDiagnostic[]> {
+    if (this.exited) {
+      throw new Error('clangd is not running');
+    }
+    const file = path.normalize(filePath);
+    const content = text !== undefined ? text : await fs.promises.readFile(file, 'utf8');
+    const uri = pathToFileURL(file).href;
+    const document = this.documents.get(file);
+    const published = this.published.get(file);
+
+    if (document && document.text === content && published) {
+      return published.diagnostics;
+    }
+
+    const version = document ? document.version + 1 : 1;
+    const waiting = this.waitForDiagnostics(file, version);
+    if (!document) {
+      this.notify('textDocument/didOpen', {
+        textDocument: { uri, languageId: path.extname(file).toLowerCase() === '.c' ? 'c' : 'cpp', version, text: content }
+      });
+    } else {
+      this.notify('textDocument/didChange', { textDocument: { uri, version }, contentChanges: [{ text: content }] });
+      this.notify('textDocument/didSave', { textDocument: { uri } });
+    }
+    this.documents.set(file, { version, text: content });
+    return waiting;
+  }
+
+  /**
+   * Stop tracking a file (e.g. when its editor closes) so clangd can drop its AST
+   */
+  close(filePath: string): void {
+    const file = path.normalize(filePath);
+    if (!this.documents.has(file) || this.exited) {
+      return;
+    }
+    this.documents.delete(file);
+    this.published.delete(file);
+    this.notify('textDocument/didClose', { textDocument: { uri: pathToFileURL(file).href } });
+  }
+
+  /**
+   * Shut clangd down
+   */
+  async dispose(): Promise<void> {
+    if (this.exited) {
+      return;
+    }
+    try {
+      await Promise.race([this.request('shutdown', null), new Promise(resolve => setTimeout(resolve, 2000))]);
+      this.notify('exit', null);
+    } catch (error) {
+      // Already gone
+    }
+    this.child.kill();
+  }
+
+  private waitForDiagnostics(file: string, version: number): Promise<ClangTidyDiagnostic[]> {
+    return new Promise((resolve, reject) => {
+      const waiter: DiagnosticsWaiter = { version, resolve, reject };
+      const list = this.waiters.get(file) || [];
+      list.push(waiter);
+      this.waiters.set(file, list);
+      setTimeout(() => {
+        const pending = this.waiters.get(file);
+        if (pending && pending.includes(waiter)) {
+          pending.splice(pending.indexOf(waiter), 1);
+          reject(new Error(`clangd did not report diagnostics for ${file} in time`));
+        }
+      }, DIAGNOSTICS_TIMEOUT_MS);
+    });
+  }
+
+  private onDiagnostics(params: { uri: string; version?: number; diagnostics: LspDiagnostic[] }): void {
+    const file = path.normalize(fileURLToPath(params.uri));
+    const diagnostics = params.diagnostics
+      .map(diagnostic => ClangdSession.toDiagnostic(file, diagnostic))
+      .filter((diagnostic): diagnostic is ClangTidyDiagnostic => diagnostic !== null);
+    this.published.set(file, { version: params.version, diagnostics });
+
+    const waiters = this.waiters.get(file) || [];
+    // Without version support any publication after the change counts
+    const ready = waiters.filter(waiter => params.version === undefined || params.version >= waiter.version);
+    this.waiters.set(file, waiters.filter(waiter => !ready.includes(waiter)));
+    ready.forEach(waiter => waiter.resolve(diagnostics));
+  }
+
+  /**
+   * Convert an LSP diagnostic; keeps clang-tidy findings and compiler errors
+   */
+  private static toDiagnostic(file: string, diagnostic: LspDiagnostic): ClangTidyDiagnostic | null {
+    const isTidy = diagnostic.source === 'clang-tidy';
+    if (!isTidy && diagnostic.severity !== 1) {
+      return null;
+    }
+    return {
+      filePath: file,
+      line: diagnostic.range.start.line + 1,
+      column: diagnostic.range.start.character + 1,
+      severity: diagnostic.severity === 1 ? 'error' : diagnostic.severity === 2 ? 'warning' : 'note',
+      message: diagnostic.message.replace(/ \(fix available\)$/, ''),
+      checkName: isTidy && diagnostic.code !== undefined ? String(diagnostic.code) : 'clang-diagnostic-error'
+    };
+  }
+
+  private request(method: string, params: unknown): Promise<any> {
+    const id = this.nextId++;
+    return new Promise((resolve, reject) => {
+      this.requests.set(id, { resolve, reject });
+      this.send({ jsonrpc: '2.0', id, method, params });
+    });
+  }
+
+  private notify(method: string, params: unknown): void {
+    this.send({ jsonrpc: '2.0', method, params });
+  }
+
+  private send(message: object): void {
+    if (this.exited || !this.child.stdin || this.child.stdin.destroyed) {
+      return;
+    }
+    const body = Buffer.from(JSON.stringify(message), 'utf8');
+    this.child.stdin.write(`Content-Length: ${body.length}\r\n\r\n`);
+    this.child.stdin.write(body);
+  }
+
+  /**
+   * Split the stdout stream into LSP messages (Content-Length framed JSON)
+   */
+  private receive(chunk: Buffer): void {
+    this.buffer = Buffer.concat([this.buffer, chunk]);
+    while (true) {
+      const headerEnd = this.buffer.indexOf('\r\n\r\n');
+      if (headerEnd < 0) {
+        return;
+      }
+      const match = /Content-Length: (\d+)/i.exec(this.buffer.subarray(0, headerEnd).toString('ascii'));
+      if (!match) {
+        this.buffer = this.buffer.subarray(headerEnd + 4);
+        continue;
+      }
+      const length = parseInt(match[1], 10);
+      if (this.buffer.length < headerEnd + 4 + length) {
+        return;
+      }
+      const body = this.buffer.subarray(headerEnd + 4, headerEnd + 4 + length).toString('utf8');
+      this.buffer = this.buffer.subarray(headerEnd + 4 + length);
+
+      let message: any;
+      try {
+        message = JSON.parse(body);
+      } catch (error) {
+        logger.warn('Ignoring malformed message from clangd');
+        continue;
+      }
+      this.dispatch(message);
+    }
+  }
+
+  private dispatch(message: any): void {
+    if (message.id !== undefined && message.method === undefined) {
+      const pending = this.requests.get(message.id);
+      if (pending) {
+        this.requests.delete(message.id);
+        if (message.error) {
+          pending.reject(new Error(message.error.message));
+        } else {
+          pending.resolve(message.result);
+        }
+      }
+    } else if (message.method === 'textDocument/publishDiagnostics') {
+      this.onDiagnostics(message.params);
+    } else if (message.id !== undefined) {
+      // Server-to-client requests (e.g. progress tokens) need an answer, but none of them matter here
+      this.send({ jsonrpc: '2.0', id: message.id, result: null });
+    }
+  }
+
+  private fail(error: Error): void {
+    if (this.exited) {
+      return;
+    }
+    this.exited = true;
+    logger.warn(`clangd live session ended: ${error.message}`);
+    this.requests.forEach(pending => pending.reject(error));
+    this.requests.clear();
+    this.waiters.forEach(list => list.forEach(waiter => waiter.reject(error)));
+    this.waiters.clear();
+  }
+}
@@ -0,0 +1,86 @@
+// Diagnostic Caps - Bounds the diagnostics kept per translation unit and per (file, check); the rest are only counted
+import * as path from 'path';
+
+// Suppressed positions remembered exactly per file and check; past this they are only counted
+const MAX_SUPPRESSED_POSITIONS = 256;
+
+export class DiagnosticCaps {
+  private unitCount = 0;
+  private owned: Set<string> | null = null;
+  // "file\0check" -> positions kept (line * 65536 + column)
+  private kept = new Map<string, Set<number>>();
+  // "file\0check" -> first suppressed positions, and the count of further suppressions
+  private suppressed = new Map<string, { positions: Set<number>; overflow: number }>();
+
+  /**
+   * @param maxPerTranslationUnit Diagnostics kept from one translation unit's output (0: unlimited)
+   * @param maxPerFileCheck Distinct diagnostics kept per file and check over the whole run (0: unlimited)
+   */
+  constructor(private maxPerTranslationUnit: number, private maxPerFileCheck: number) {}
+
+  isEnabled(): boolean {
+    return this.maxPerTranslationUnit > 0 || this.maxPerFileCheck > 0;
+  }
+
+  /**
+   * Start counting the output of another translation unit
+   * @param owned Files the unit reports for (headers analyzed through it); diagnostics elsewhere are dropped uncounted
+   */
+  startUnit(owned: Set<string> | null = null): void {
+    this.unitCount = 0;
+    this.owned = owned;
+  }
+
+  /**
+   * Whether to keep a diagnostic. A diagnostic already kept from another translation unit (a header)
+   * is kept again, since it is merged later; a suppressed one is counted once however many units report it,
+   * as long as its (file, check) has few suppressions. Past that they are plain counts, so repeats from
+   * other units are counted again and memory stays bounded.
+   */
+  admit(filePath: string, checkName: string, line: number, column: number): boolean {
+    const file = path.normalize(filePath);
+    if (this.owned && !this.owned.has(file)) {
+      return false;
+    }
+    const key = file + '\0' + checkName;
+    const position = line * 65536 + column;
+    const kept = this.kept.get(key);
+    if (kept && kept.has(position)) {
+      return true;
+    }
+    const overUnitCap = this.maxPerTranslationUnit > 0 && this.unitCount >= this.maxPerTranslationUnit;
+    const overCheckCap = this.maxPerFileCheck > 0 && kept !== undefined && kept.size >= this.maxPerFileCheck;
+    if (overUnitCap || overCheckCap) {
+      const suppressed = this.suppressed.get(key) || { positions: new Set<number>(), overflow: 0 };
+      if (suppressed.positions.has(position)) {
+        return false;
+      }
+      if (suppressed.positions.size < MAX_SUPPRESSED_POSITIONS) {
+        suppressed.positions.add(position);
+      } else {
+        suppressed.overflow++;
+      }
+      this.suppressed.set(key, suppressed);
+      return false;
+    }
+    this.unitCount++;
+    this.kept.set(key, (kept || new Set<number>()).add(position));
+    return true;
+  }
+
+  /**
+   * Suppressed diagnostics per file and check, not counting those also kept through another unit
+   */
+  getSuppressed(): Record<string, Record<string, number>> {
+    const result: Record<string, Record<string, number>> = {};
+    for (const [key, { positions, overflow }] of this.suppressed) {
+      const kept = this.kept.get(key);
+      const count = (kept ? Array.from(positions).filter(position => !kept.has(position)).length : positions.size) + overflow;
+      if (count > 0) {
+        const [file, check] = key.split('\0');
+        result[file] = { ...result[file], [check]: count };
+      }
+    }
+    return result;
+  }
+}
@@ -1,18 +1,21 @@
 // Text Parser - Parses Clang-Tidy text output
 import { ClangTidyDiagnostic } from '../../types';
 import { logger } from '../../utils/logger';
+import { DiagnosticCaps } from './DiagnosticCaps';
 import * as fs from 'fs';
 import * as path from 'path';
 
 export class TextParser {
   /**
-   * Parse Clang-Tidy text output
+   * Parse Clang-Tidy text output.
+   * With caps, the text is the output of the unit the caller started on them; diagnostics the caps do not admit
+   * are skipped without building them, together with their notes and source lines.
    */
-  parseClangTidyText(text: string): ClangTidyDiagnostic[] {
+  parseClangTidyText(text: string, caps?: DiagnosticCaps): ClangTidyDiagnostic[] {
     logger.info('Parsing Clang-Tidy text output');
     
     try {
-      return this.transformTextToDiagnostics(text);
+      return this.transformTextToDiagnostics(text, caps);
     } catch (error) {
       logger.error('Failed to parse Clang-Tidy text output', error as Error);
       return [];
@@ -22,7 +25,7 @@ export class TextParser {
   /**
    * Transform text output to ClangTidyDiagnostic array
    */
-  private transformTextToDiagnostics(text: string): ClangTidyDiagnostic[] {
+  private transformTextToDiagnostics(text: string, caps?: DiagnosticCaps): ClangTidyDiagnostic[] {
     const diagnostics: ClangTidyDiagnostic[] = [];
 
     // Split text into lines for easier processing
@@ -40,6 +43,9 @@ export class TextParser {
     let matchedWarnings = 0;
     let invalidSeverities = 0;
     let currentDiagnostic: ClangTidyDiagnostic | null = null;
+    // Notes of a suppressed diagnostic are suppressed with it
+    let suppressing = false;
+    let suppressedCount = 0;
 
     for (const line of lines) {
       if (!line.trim()) {
@@ -71,6 +77,18 @@ export class TextParser {
           continue;
         }
 
+        // Errors are never capped: they are few (clang stops after -ferror-limit) and fail gated runs
+        if (caps && (severity === 'note' ? suppressing
+          : severity === 'warning' && !caps.admit(filePath, checkName, parseInt(lineStr, 10), parseInt(columnStr, 10)))) {
+          suppressing = true;
+          suppressedCount++;
+          currentDiagnostic = null;
+          continue;
+        }
+        if (severity !== 'note') {
+          suppressing = false;
+        }
+
         const diagnostic: ClangTidyDiagnostic = {
           filePath,
           line: parseInt(lineStr, 10),
@@ -125,7 +143,8 @@ export class TextParser {
     }
 
     logger.info(
-      `Parsed ${matchedWarnings} potential warning lines, created ${diagnostics.length} diagnostics, skipped ${invalidSeverities} with invalid severity`
+      `Parsed ${matchedWarnings} potential warning lines, created ${diagnostics.length} diagnostics, skipped ${invalidSeverities} with invalid severity` +
+      (suppressedCount > 0 ? `, ${suppressedCount} not admitted by the caps` : '')
     );
 
     // Read source code from files and add to diagnostics
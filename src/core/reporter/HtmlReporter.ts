@@ -1,7 +1,8 @@
 // HTML Reporter - Generates HTML reports from Clang-Tidy results
-import { ReportData, ReportOptions, ClangTidyDiagnostic } from '../../types';
+import { ReportData, ReportOptions, ClangTidyDiagnostic, RootSummary, SampleEstimate, SamplingSummary } from '../../types';
 import { ChartGenerator } from './ChartGenerator';
 import { logger } from '../../utils/logger';
+import { FileUtils } from '../../utils/fileUtils';
 import { i18n } from '../../utils/i18nService';
 
 // Handlebars-like template engine (simplified for this implementation)
@@ -68,6 +69,9 @@ export class HtmlReporter {
       filesWithWarnings,
       topCheckers,
       warningsByChecker: data.warningsByChecker,
+      roots: data.roots && data.roots.length > 1 ? data.roots : null,
+      sampling: data.sampling || null,
+      suppressed: data.suppressed || null,
       generateVscodeLink: this.generateVscodeLink
     };
   }
@@ -160,9 +164,101 @@ export class HtmlReporter {
       `;
     });
     
+    // Multi-root workspaces: files are listed per root, innermost root wins for nested folders
+    const roots: RootSummary[] | null = data.roots;
+    const rootOf = (fileName: string): RootSummary | undefined => {
+      const rootPath = roots ? FileUtils.findRoot(fileName, roots.map(root => root.path)) : null;
+      return roots?.find(root => root.path === rootPath);
+    };
+    // Root names, configuration labels (from -D/-std flags) and directory names may contain markup characters
+    const escape = (text: string) => text.replace(/[&<>"']/g, char => `&#${char.charCodeAt(0)};`);
+    // Files whose diagnostics were all over the caps still get an entry for their counts
+    const suppressed: Record<string, Record<string, number>> = data.suppressed || {};
+    const suppressedIn = (fileName: string) => suppressed[fileName] || suppressed[require('path').normalize(fileName)];
+    const suppressedTotal = (checks: Record<string, number> | undefined) => Object.values(checks || {}).reduce((sum, count) => sum + count, 0);
+    const totalSuppressed = Object.values(suppressed).reduce((sum, checks) => sum + suppressedTotal(checks), 0);
+    let fileEntries: Array<[string, unknown]> = Object.entries(data.filesWithWarnings);
+    const listed = new Set(fileEntries.map(([name]) => require('path').normalize(name)));
+    for (const fileName of Object.keys(suppressed)) {
+      if (!listed.has(fileName)) {
+        fileEntries.push([fileName, []]);
+      }
+    }
+    if (roots) {
+      const order = (fileName: string) => {
+        const root = rootOf(fileName);
+        return root ? roots.indexOf(root) : roots.length;
+      };
+      fileEntries = fileEntries.sort(([a], [b]) => order(a) - order(b));
+    }
+
+    let rootsHtml = '';
+    if (roots) {
+      rootsHtml = `
+    <section class="checker-ranking">
+      <h2 class="section-title">${i18n.t('report.workspaceRoots', 'Workspace Roots')}</h2>
+      <table class="ranking-table">
+        <tr>
+          <th>${i18n.t('report.root', 'Root')}</th>
+          <th>${i18n.t('report.totalFilesChecked')}</th>
+          <th>${i18n.t('report.filesWithWarnings')}</th>
+          <th>${i18n.t('report.totalWarnings')}</th>
+        </tr>
+        ${roots.map(root => `
+        <tr>
+          <td title="${escape(root.path)}">${escape(root.name)}</td>
+          <td>${root.totalFilesChecked}</td>
+          <td>${root.filesWithWarnings}</td>
+          <td>${root.totalWarnings}</td>
+        </tr>`).join('')}
+      </table>
+    </section>
+      `;
+    }
+
+    // Sampled runs: extrapolated totals per check and directory
+    const sampling: SamplingSummary | null = data.sampling;
+    let samplingHtml = '';
+    if (sampling) {
+      const estimateTable = (label: string, rows: SampleEstimate[]) => `
+      <table class="ranking-table">
+        <tr>
+          <th>${label}</th>
+          <th>${i18n.t('report.sampleObserved', 'In sample')}</th>
+          <th>${i18n.t('report.estimatedTotal', 'Estimated total')}</th>
+          <th>${i18n.t('report.confidenceInterval', '95% CI')}</th>
+        </tr>
+        ${rows.map(row => `
+        <tr>
+          <td>${escape(row.name)}</td>
+          <td>${row.observed}</td>
+          <td>${row.estimate}</td>
+          <td>${row.low} - ${row.high}</td>
+        </tr>`).join('')}
+      </table>`;
+      samplingHtml = `
+    <section class="checker-ranking">
+      <h2 class="section-title">${i18n.t('report.samplingEstimates', 'Estimated Totals')}</h2>
+      <p class="sampling-note">
+        ${i18n.t('report.samplingNote', `Extrapolated from ${sampling.sampledFiles} of ${sampling.totalFiles} files: about ${sampling.total.estimate} warnings (95% CI ${sampling.total.low} - ${sampling.total.high})`,
+          sampling.sampledFiles, sampling.totalFiles, sampling.total.estimate, sampling.total.low, sampling.total.high)}
+        ${sampling.headerDiagnostics > 0 ? i18n.t('report.samplingHeaders', `${sampling.headerDiagnostics} warnings in headers are shared between files and not extrapolated.`, sampling.headerDiagnostics) : ''}
+      </p>
+      ${estimateTable(i18n.t('report.ruleName'), sampling.byCheck)}
+      ${estimateTable(i18n.t('report.directory', 'Directory'), sampling.byDirectory)}
+    </section>
+      `;
+    }
+
     // Render files with warnings
     let filesHtml = '';
-    Object.entries(data.filesWithWarnings).forEach(([fileName, warnings]) => {
+    let currentRoot: RootSummary | undefined;
+    fileEntries.forEach(([fileName, warnings]) => {
+      const fileRoot = rootOf(fileName);
+      if (roots && (fileRoot !== currentRoot || filesHtml === '')) {
+        currentRoot = fileRoot;
+        filesHtml += `<h3 class="root-header">${fileRoot ? escape(fileRoot.name) : i18n.t('report.outsideRoots', 'Outside workspace roots')}</h3>`;
+      }
       let warningsHtml = '';
       const typedWarnings = warnings as ClangTidyDiagnostic[];
       typedWarnings.forEach((warn: ClangTidyDiagnostic) => {
@@ -199,6 +295,8 @@ export class HtmlReporter {
             <div class="warning-header">
               ${i18n.t('report.rule')}: ${warn.checkName.split('.').pop()}
               <span class="warning-location">${warn.filePath}:${warn.line}:${warn.column}</span>
+              ${warn.configurations ? `<span class="warning-configurations" title="${i18n.t('report.configurations', 'Configurations')}">${escape(warn.configurations.join(', '))}</span>` : ''}
+              ${warn.tier ? `<span class="warning-tier warning-tier-${warn.tier}" title="${i18n.t('report.tier', 'Check tier')}">${warn.tier === 'slow' ? i18n.t('report.tierSlow', 'slow') : i18n.t('report.tierFast', 'fast')}</span>` : ''}
               <a href="vscode://file/${warn.filePath.replace(/\\/g, '/')}:${warn.line}" class="vscode-link">
                 <span class="vscode-icon"> ></span> ${i18n.t('report.openInVSCode')}
               </a>
@@ -209,6 +307,16 @@ export class HtmlReporter {
         `;
       });
 
+      const fileSuppressed = suppressedIn(fileName);
+      if (fileSuppressed) {
+        const count = suppressedTotal(fileSuppressed);
+        warningsHtml += `
+          <div class="suppressed-note">${i18n.t('report.suppressedByCap', `+${count} more suppressed by cap`, count)}:
+            ${Object.entries(fileSuppressed).sort((a, b) => b[1] - a[1]).map(([check, checkCount]) => `${check || '-'} (${checkCount})`).join(', ')}
+          </div>
+        `;
+      }
+
       // Extract just the file name without path using path.basename
       const displayFileName = require('path').basename(fileName) || fileName;
       
@@ -391,6 +499,12 @@ export class HtmlReporter {
       border: 1px solid #eee;
     }
     
+    .root-header {
+      margin: 25px 0 10px;
+      padding-bottom: 5px;
+      border-bottom: 1px solid #e0e0e0;
+    }
+    
     .file-name {
       font-weight: 600;
       color: #2c3e50;
@@ -421,6 +535,40 @@ export class HtmlReporter {
       margin-left: 10px;
     }
     
+    .warning-configurations {
+      font-size: 11px;
+      color: #555;
+      background-color: #eef2f5;
+      border-radius: 3px;
+      padding: 1px 6px;
+      margin-left: 10px;
+    }
+    
+    .sampling-note {
+      color: #555;
+      margin-bottom: 12px;
+    }
+    
+    .suppressed-note {
+      color: #7f8c8d;
+      font-size: 13px;
+      font-style: italic;
+    }
+    
+    .warning-tier {
+      font-size: 11px;
+      border-radius: 3px;
+      padding: 1px 6px;
+      margin-left: 10px;
+      color: #2e6b30;
+      background-color: #e8f3e8;
+    }
+    
+    .warning-tier-slow {
+      color: #7a4b00;
+      background-color: #fbf0dc;
+    }
+    
     .warning-message {
       font-size: 14px;
       margin-top: 5px;
@@ -991,6 +1139,7 @@ export class HtmlReporter {
       <div class="stat-card">
         <div class="stat-label">${i18n.t('report.totalWarnings')}</div>
         <div class="stat-value">${data.stats.totalWarnings}</div>
+        ${totalSuppressed > 0 ? `<div class="suppressed-note">${i18n.t('report.suppressedByCap', `+${totalSuppressed} more suppressed by cap`, totalSuppressed)}</div>` : ''}
       </div>
       <div class="stat-card">
         <div class="stat-label">${i18n.t('report.violatedRulesCount')}</div>
@@ -1010,6 +1159,8 @@ export class HtmlReporter {
       </div>
     </section>
     
+    ${rootsHtml}
+    ${samplingHtml}
     <section class="checker-ranking">
       <h2 class="section-title">${i18n.t('report.violatedRulesRankings')}</h2>
       <table class="ranking-table">
@@ -0,0 +1,39 @@
+// Report Exporter - Writes reports to disk (no VS Code dependency)
+import * as path from 'path';
+import { ReportData, ReportOptions } from '../../types';
+import { HtmlReporter } from './HtmlReporter';
+import { FileUtils } from '../../utils/fileUtils';
+import { logger } from '../../utils/logger';
+
+export type ExportFormat = 'html' | 'json';
+
+export class ReportExporter {
+  /**
+   * Write the report in the requested formats into a directory.
+   * Returns the paths of the written files.
+   */
+  static async exportTo(
+    outputDir: string,
+    data: ReportData,
+    options: ReportOptions = {},
+    formats: ExportFormat[] = ['html', 'json']
+  ): Promise<string[]> {
+    const written: string[] = [];
+
+    if (formats.includes('html')) {
+      const htmlPath = path.join(outputDir, 'index.html');
+      const reporter = new HtmlReporter();
+      FileUtils.writeFile(htmlPath, await reporter.generateReport(data, options));
+      written.push(htmlPath);
+    }
+
+    if (formats.includes('json')) {
+      const jsonPath = path.join(outputDir, 'report.json');
+      FileUtils.writeJson(jsonPath, data);
+      written.push(jsonPath);
+    }
+
+    logger.info(`Report written to ${outputDir}: ${written.map(file => path.basename(file)).join(', ')}`);
+    return written;
+  }
+}
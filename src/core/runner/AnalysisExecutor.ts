@@ -0,0 +1,93 @@
+// Analysis Executor - Runs per-TU clang-tidy tasks locally or through the daemon
+import { ProcessResult } from '../../utils/processUtils';
+import { ResultCache } from '../cache/ResultCache';
+import { CompileCommand } from '../compiledb/CompileDatabase';
+import { Scheduler, SchedulerTask } from './Scheduler';
+import { logger } from '../../utils/logger';
+
+// One clang-tidy invocation for one translation unit
+export interface AnalysisTask extends SchedulerTask {
+  file: string;
+  // Content-addressed result key; tasks without one are never cached
+  cacheKey?: string;
+  // Workspace root that paths in cached output are stored relative to
+  cacheRoot?: string;
+  // Expected run time in milliseconds from the cost history, if known
+  estimatedCost?: number;
+  // Compile database entry of the TU, sent along to remote workers
+  compileEntry?: CompileCommand;
+}
+
+export interface AnalysisExecutor {
+  /**
+   * Execute tasks and resolve with results in input order.
+   * onResult is called as soon as each individual result is available.
+   */
+  execute(tasks: AnalysisTask[], onResult?: (index: number, result: ProcessResult) => void): Promise<ProcessResult[]>;
+
+  /**
+   * Start fetching cached results of tasks that are about to be executed, if the executor can
+   */
+  prefetch?(tasks: AnalysisTask[]): void;
+
+  /**
+   * Release resources held by the executor
+   */
+  dispose(): void;
+}
+
+/**
+ * Executes tasks in this process through the shared scheduler and result cache
+ */
+export class LocalExecutor implements AnalysisExecutor {
+  constructor(private scheduler: Scheduler, private cache: ResultCache | null) {}
+
+  async execute(tasks: AnalysisTask[], onResult?: (index: number, result: ProcessResult) => void): Promise<ProcessResult[]> {
+    let cacheHits = 0;
+
+    const results = await Promise.all(tasks.map(async (task, index) => {
+      let result = task.cacheKey && this.cache ? await this.cache.lookup(task.cacheKey, task.cacheRoot) : undefined;
+      if (result) {
+        cacheHits++;
+      } else {
+        result = await this.scheduler.submit(task);
+        if (task.cacheKey && this.cache && !result.cancelled) {
+          this.cache.set(task.cacheKey, result, task.cacheRoot);
+        }
+      }
+      if (onResult) {
+        onResult(index, result);
+      }
+      return result;
+    }));
+
+    if (this.cache) {
+      logger.debug(`Result cache: ${cacheHits}/${tasks.length} tasks served from cache`);
+    }
+    return results;
+  }
+
+  prefetch(tasks: AnalysisTask[]): void {
+    if (this.cache) {
+      this.cache.prefetch(tasks.filter(task => task.cacheKey).map(task => task.cacheKey!));
+    }
+  }
+
+  /**
+   * Number of tasks the local pool runs at once
+   */
+  getConcurrency(): number {
+    return this.scheduler.getConcurrency();
+  }
+
+  /**
+   * Get the result cache used by this executor
+   */
+  getCache(): ResultCache | null {
+    return this.cache;
+  }
+
+  dispose(): void {
+    // Scheduler and cache are process-wide; nothing to release
+  }
+}
@@ -1,22 +1,141 @@
 // Clang-Tidy Runner - Executes Clang-Tidy commands
-import * as vscode from 'vscode';
 import * as path from 'path';
 import * as fs from 'fs';
-import { RunOptions, RunResult, ParallelResult, ClangTidyDiagnostic } from '../../types';
-import { ProcessUtils } from '../../utils/processUtils';
-import { ConfigManager } from '../config/ConfigManager';
+import { RunOptions, RunResult, ParallelResult, RunnerSettings } from '../../types';
+import { ProcessUtils, ProcessResult } from '../../utils/processUtils';
 import { logger } from '../../utils/logger';
 import { FileUtils } from '../../utils/fileUtils';
+import { Scheduler, SchedulerTask } from './Scheduler';
+import { PreambleBuilder } from './PreambleBuilder';
+import { AnalysisExecutor, AnalysisTask, LocalExecutor } from './AnalysisExecutor';
+import { ResultCache } from '../cache/ResultCache';
+import { CheckResultCache, CheckSet } from '../cache/CheckResultCache';
+import { createRemoteBackend } from '../cache/RemoteCacheBackend';
+import { CompileCommand, CompileDatabase } from '../compiledb/CompileDatabase';
+import { AnalysisUnit, CompileUnitResolver, NamedDatabase } from '../compiledb/CompileUnitResolver';
+import { MinimalDatabase } from '../compiledb/MinimalDatabase';
+import { HeaderMapper } from '../compiledb/HeaderMapper';
+import { CommandRewriter } from '../compiledb/CommandRewriter';
+import { UnityBuilder } from '../compiledb/UnityBuilder';
+import { NinjaGraph } from '../compiledb/NinjaGraph';
+import { CheckTiers } from '../engine/CheckTiers';
+import { DiagnosticCaps } from '../parser/DiagnosticCaps';
+import { IncludeGraph } from '../compiledb/IncludeGraph';
+import { RemoteWorker } from '../../remote/RemoteWorker';
+import { DistributedExecutor, PlacementOptions } from '../../remote/DistributedExecutor';
+
+// Files whose cache keys are looked up in one shared-cache request
+const PREFETCH_BATCH_SIZE = 256;
+
+// Per-check cache state of a unit: the checks to run, or its complete cached result
+interface CheckPlan {
+  key: string;
+  set: CheckSet;
+  missing: string[];
+  result?: ProcessResult;
+}
 
 export class ClangTidyRunner {
-  private configManager: ConfigManager;
+  private settings: RunnerSettings;
   private clangTidyPath: string;
   private compileCommandsPath: string;
+  private clangTidyVersion = '';
+  private scheduler: Scheduler;
+  private localExecutor: LocalExecutor;
+  private executor: AnalysisExecutor;
+  private includeGraph = new IncludeGraph();
+  private headerMapper = new HeaderMapper(this.includeGraph);
+  private rewriter: CommandRewriter | null;
+  private costEstimator: ((file: string) => number) | null = null;
+  private checkTiers: CheckTiers | null = null;
+  // -list-checks output per argument list
+  private checkLists = new Map<string, Promise<string[]>>();
+  private checkCache: CheckResultCache | null;
+  // Enabled checks and option fingerprints per configuration
+  private checkSets = new Map<string, Promise<CheckSet | null>>();
+
+  /**
+   * @param settings ConfigManager inside VS Code, or command line settings in the CLI
+   */
+  constructor(settings: RunnerSettings) {
+    this.settings = settings;
+    this.clangTidyPath = settings.getClangTidyPath();
+    this.compileCommandsPath = settings.getCompileCommandsPath();
+    this.scheduler = Scheduler.getInstance();
+    this.scheduler.setConcurrency(settings.getParallelJobs());
+    this.localExecutor = new LocalExecutor(this.scheduler, this.createCache());
+    this.executor = this.localExecutor;
+    this.rewriter = this.createRewriter();
+    this.checkCache = this.createCheckCache();
+  }
+
+  /**
+   * Use another executor (e.g. the shared analysis daemon) instead of the in-process pool
+   */
+  setExecutor(executor: AnalysisExecutor): void {
+    if (this.executor !== this.localExecutor) {
+      this.executor.dispose();
+    }
+    this.executor = executor;
+  }
+
+  /**
+   * Put a decorator (e.g. a trace recorder) around the current executor, which stays in use behind it
+   */
+  wrapExecutor<T extends AnalysisExecutor>(wrap: (executor: AnalysisExecutor) => T): T {
+    const wrapper = wrap(this.executor);
+    this.executor = wrapper;
+    return wrapper;
+  }
+
+  /**
+   * Distribute tasks over remote workers in addition to the in-process pool.
+   * Workers running a different clang-tidy version are skipped, since their results would be cached under this version.
+   */
+  useRemoteWorkers(workers: RemoteWorker[], placement: PlacementOptions): void {
+    const compatible = workers.filter(worker => {
+      if (this.clangTidyVersion && worker.getToolVersion() !== this.clangTidyVersion) {
+        logger.warn(`Skipping worker ${worker.getAddress()}: clang-tidy version differs (${worker.getToolVersion().split('\n')[0]})`);
+        worker.dispose();
+        return false;
+      }
+      return true;
+    });
+    if (compatible.length > 0) {
+      this.setExecutor(new DistributedExecutor(this.localExecutor, compatible, placement));
+    }
+  }
 
-  constructor(configManager: ConfigManager) {
-    this.configManager = configManager;
-    this.clangTidyPath = configManager.getClangTidyPath();
-    this.compileCommandsPath = configManager.getCompileCommandsPath();
+  /**
+   * Set the per-file cost estimate used for task placement (e.g. from the cost history)
+   */
+  setCostEstimator(estimator: (file: string) => number): void {
+    this.costEstimator = estimator;
+  }
+
+  /**
+   * clang-tidy --version output, once checkClangTidyAvailable has run
+   */
+  getClangTidyVersion(): string {
+    return this.clangTidyVersion;
+  }
+
+  /**
+   * Get hit/miss counters of the in-process result cache, or null if caching is disabled
+   */
+  getCacheStats(): { hits: number; misses: number; remoteHits: number } | null {
+    const cache = this.localExecutor.getCache();
+    return cache ? cache.getStats() : null;
+  }
+
+  /**
+   * Wait until results are uploaded to the shared cache
+   */
+  async flushCache(): Promise<void> {
+    const cache = this.localExecutor.getCache();
+    if (cache) {
+      await cache.flush();
+    }
   }
 
   /**
@@ -25,8 +144,17 @@ export class ClangTidyRunner {
   async runAnalysis(files: string[], options: RunOptions = {}): Promise<RunResult> {
     logger.info('Running Clang-Tidy analysis on ' + files.length + ' files');
     
+    const tiered = await this.applyCheckTier(options);
+    if (!tiered) {
+      return { rawOutput: '', errorOutput: '', exitCode: 0, duration: 0 };
+    }
+    options = tiered;
+    const sourceFiles = this.filterSourceFiles(files);
+    // Only single-TU invocations map onto cache entries and a single compile command
+    const unit = sourceFiles.length === 1 ? this.rewriteUnit(this.createUnitResolver().resolve(sourceFiles[0])[0]) : null;
+    
     // Build command arguments
-    const args = this.buildArguments(files, options);
+    const args = this.buildArguments(files, options, unit ? this.compileDbDirFor(unit) : undefined);
     logger.debug('Clang-Tidy command: ' + this.clangTidyPath + ' ' + args.join(' '));
     
     const startTime = Date.now();
@@ -34,17 +162,18 @@ export class ClangTidyRunner {
     try {
       // Execute command from workspace root directory
       // This ensures Clang-Tidy can find .clang-tidy file in the workspace
-      const options = {
-        cwd: vscode.workspace.workspaceFolders?.[0].uri.fsPath || process.cwd()
-      };
-      const result = await ProcessUtils.executeCommand(this.clangTidyPath, args, options);
+      const cwd = this.settings.getWorkspaceRoot() || process.cwd();
+      const task = this.createTask(sourceFiles[0] || '', args, cwd, options.priority || 'interactive',
+        !!unit && !options.fix, unit?.entry);
+      const [result] = await this.executeTasks([task]);
       
       // Clang-Tidy outputs diagnostics to stdout
       return {
         rawOutput: result.stdout,
         errorOutput: result.stderr,
         exitCode: result.exitCode,
-        duration: Date.now() - startTime
+        duration: Date.now() - startTime,
+        cached: result.cached
       };
     } catch (error) {
       logger.error('Failed to execute Clang-Tidy', error as Error);
@@ -58,74 +187,587 @@ export class ClangTidyRunner {
   }
 
   /**
-   * Run Clang-Tidy in parallel on multiple batches of files
+   * Caps on the diagnostics kept from one run of this runner
    */
-  async runParallel(files: string[], options: RunOptions = {}, onProgress?: (completed: number, total: number) => void): Promise<ParallelResult[]> {
+  createDiagnosticCaps(): DiagnosticCaps {
+    const limits = this.settings.getDiagnosticLimits();
+    return new DiagnosticCaps(limits.maxDiagnosticsPerTranslationUnit, limits.maxDiagnosticsPerFileCheck);
+  }
+
+  /**
+   * Whether files must go through runParallel even when there is only one: the compile database policy
+   * may analyze a file in several configurations, or a header is analyzed through an including translation unit
+   */
+  needsUnitResolution(files: string[]): boolean {
+    return this.settings.getCompileDatabaseConfig().policy !== 'canonical' || files.some(file => HeaderMapper.isHeader(file));
+  }
+
+  /**
+   * Run Clang-Tidy in parallel, one translation unit per task.
+   * Tasks go through the shared scheduler, so concurrent runs never exceed parallelJobs in total.
+   * The compile database policy decides how many tasks a file yields; each result carries its configuration.
+   * Headers without a compile command are analyzed through the cheapest translation unit including them.
+   * In unity mode, small sources are merged; a merged batch that fails to compile is rerun file by file.
+   * In ninja builds, units including generated headers that do not exist yet can be run last or generated first.
+   * Aborting the signal stops the run: queued units are dropped, running ones killed, and only finished results returned.
+   * Units isRecorded reports as done (e.g. in a resumed journal) are skipped.
+   */
+  async runParallel(
+    files: string[],
+    options: RunOptions = {},
+    onProgress?: (completed: number, total: number) => void,
+    onFileResult?: (result: ParallelResult) => void,
+    signal?: AbortSignal,
+    isRecorded?: (files: string[], configuration?: string) => boolean
+  ): Promise<ParallelResult[]> {
     logger.info('Running Clang-Tidy analysis in parallel on ' + files.length + ' files');
     
-    const maxJobs = this.configManager.getParallelJobs();
-    const batchSize = Math.ceil(files.length / maxJobs);
-    const batches = ProcessUtils.splitArray(files, batchSize);
+    const tiered = await this.applyCheckTier(options);
+    if (!tiered) {
+      return [];
+    }
+    options = tiered;
+    const priority = options.priority || 'normal';
+    const compileDbConfig = this.settings.getCompileDatabaseConfig();
+    let units = this.resolveUnits(this.filterSourceFiles(files));
+    if (isRecorded) {
+      units = units.filter(unit => !isRecorded(unit.headers || [unit.file], unit.configuration));
+    }
+    // Units missing generated headers would only report errors; they run after the rest once the headers exist
+    const buildGraph = NinjaGraph.find(this.settings.getCompileCommandsPath());
+    let blocked: AnalysisUnit[] = [];
+    if (buildGraph && compileDbConfig.generatedHeaders !== 'off') {
+      ({ ready: units, blocked } = await buildGraph.partition(units, this.includeGraph, compileDbConfig.generatedHeaders));
+    }
+    // Fixes would be written into the generated unity sources, and remote workers could not read them
+    if (compileDbConfig.unityBatchSize > 1 && !options.fix && !(this.executor instanceof DistributedExecutor)) {
+      units = new UnityBuilder(compileDbConfig.unityBatchSize, file => this.sharesRootConfig(file)).apply(units);
+    }
+    // PCH paths are local, so remote workers could not load them
+    if (compileDbConfig.precompiledHeaders && !(this.executor instanceof DistributedExecutor)) {
+      const builder = new PreambleBuilder(this.scheduler, this.includeGraph, PreambleBuilder.findClang(this.clangTidyPath));
+      units = await builder.apply(units, this.settings.getWorkspaceRoot(), priority, options.extraArgs || this.settings.getExtraArgs() || []);
+    }
     
-    logger.debug('Using ' + maxJobs + ' parallel jobs, batch size: ' + batchSize);
+    logger.debug('Scheduling ' + units.length + ' translation units with priority ' + priority +
+      ' (global limit: ' + this.scheduler.getConcurrency() + ' jobs)');
     
-    // Create tasks for each batch
     // Set cwd to workspace root to ensure .clang-tidy file is found
-    const cwd = vscode.workspace.workspaceFolders?.[0].uri.fsPath || process.cwd();
-    const tasks = batches.map((batch) => {
-      return {
-        command: this.clangTidyPath,
-        args: this.buildArguments(batch, options),
-        options: { cwd }
-      };
-    });
-    
-    // Execute tasks in parallel
-    const results = await ProcessUtils.executeParallel(tasks, maxJobs, onProgress);
+    const cwd = this.settings.getWorkspaceRoot() || process.cwd();
+    // Units whose enabled checks are all cached need no run; the others only run their new or changed checks
+    const plans = await this.planCheckRuns(units, options, cwd);
+    const cached = units.filter(unit => plans.get(unit)?.result);
+    units = units.filter(unit => !plans.get(unit)?.result);
+    const tasks = await this.createTasks(units, options, cwd, priority, plans, signal);
     
     // Map results to ParallelResult
     // Clang-Tidy outputs diagnostics to stdout
-    return results.map((result, index) => ({
+    const toParallelResult = (result: ProcessResult, unit: AnalysisUnit): ParallelResult => ({
       rawOutput: result.stdout,
       errorOutput: result.stderr,
       exitCode: result.exitCode,
       duration: result.duration,
-      files: batches[index]
-    }));
+      files: unit.headers || (unit.members ? unit.members.map(member => member.file) : [unit.file]),
+      configuration: unit.configuration,
+      translationUnit: unit.headers ? unit.file : undefined,
+      cached: result.cached
+    });
+    
+    let completed = 0;
+    let total = tasks.length + cached.length + blocked.length;
+    const parallelResults: ParallelResult[] = [];
+    const fallback: AnalysisUnit[] = [];
+    const finish = (result: ParallelResult) => {
+      completed++;
+      parallelResults.push(result);
+      if (onFileResult) {
+        onFileResult(result);
+      }
+      if (onProgress) {
+        onProgress(completed, total);
+      }
+    };
+    
+    cached.forEach(unit => finish(toParallelResult(plans.get(unit)!.result!, unit)));
+    await this.executeTasks(tasks, (index, result) => {
+      const unit = units[index];
+      if (result.cancelled) {
+        return;
+      }
+      if (unit.members) {
+        result = { ...result, stdout: UnityBuilder.remapOutput(result.stdout, unit) };
+      }
+      if (unit.members && UnityBuilder.hasCompileErrors(result.stdout)) {
+        // The merged sources do not compile together (a hazard the scan missed)
+        logger.debug(`Unity batch of ${unit.members.length} files failed to compile, analyzing them one by one`);
+        fallback.push(...unit.members);
+        total += unit.members.length - 1;
+        return;
+      }
+      const plan = plans.get(unit);
+      finish(toParallelResult(plan ? this.checkCache!.record(plan.key, plan.set, plan.missing, result, this.settings.getWorkspaceRoot() || undefined) : result, unit));
+    });
+    
+    const finishUnlessCancelled = (result: ProcessResult, unit: AnalysisUnit) => {
+      if (!result.cancelled) {
+        finish(toParallelResult(result, unit));
+      }
+    };
+    
+    if (fallback.length > 0 && !signal?.aborted) {
+      const fallbackTasks = await this.createTasks(fallback, options, cwd, priority, undefined, signal);
+      await this.executeTasks(fallbackTasks, (index, result) => finishUnlessCancelled(result, fallback[index]));
+    }
+    
+    if (blocked.length > 0 && !signal?.aborted) {
+      const { ready, missing } = await buildGraph!.waitForInputs(blocked, this.includeGraph, signal);
+      // Units that were never analyzed must not pass as clean
+      if (!signal?.aborted) {
+        missing.forEach(unit => finish(toParallelResult({
+          stdout: '',
+          stderr: `Not analyzed: generated headers of ${unit.file} were not built`,
+          exitCode: 1,
+          duration: 0
+        }, unit)));
+      }
+      const delayedTasks = await this.createTasks(ready, options, cwd, priority, undefined, signal);
+      await this.executeTasks(delayedTasks, (index, result) => finishUnlessCancelled(result, ready[index]));
+    }
+    
+    return parallelResults;
+  }
+
+  /**
+   * Create the tasks of a list of units.
+   * Fix runs modify sources, so their results are never cached.
+   * Keys are computed in batches and each batch is prefetched from the shared cache
+   * while the next one is hashed, so remote lookups overlap with key computation.
+   */
+  private async createTasks(
+    units: AnalysisUnit[],
+    options: RunOptions,
+    cwd: string,
+    priority: SchedulerTask['priority'],
+    plans?: Map<AnalysisUnit, CheckPlan>,
+    signal?: AbortSignal
+  ): Promise<AnalysisTask[]> {
+    const tasks: AnalysisTask[] = [];
+    for (let i = 0; i < units.length; i += PREFETCH_BATCH_SIZE) {
+      const batch = units.slice(i, i + PREFETCH_BATCH_SIZE).map(unit => {
+        const unitOptions = { ...this.optionsFor(unit, options) };
+        const plan = plans?.get(unit);
+        // Narrow to the checks without cached results; -* alone would also turn off the compiler warnings
+        if (plan && plan.missing.length < Object.keys(plan.set.checks).length) {
+          unitOptions.checkFilter = '-*,clang-diagnostic-*,' + plan.missing.join(',');
+        }
+        return this.createTask(unit.file, this.buildArguments([unit.file], unitOptions, this.compileDbDirFor(unit)),
+          cwd, priority, !options.fix, unit.entry, signal);
+      });
+      tasks.push(...batch);
+      if (this.executor.prefetch && !options.fix) {
+        this.executor.prefetch(batch);
+        await new Promise(resolve => setImmediate(resolve));
+      }
+    }
+    return tasks;
+  }
+
+  /**
+   * Execute tasks, falling back to the in-process pool if the daemon connection fails.
+   * Only tasks whose results were not delivered yet run again.
+   */
+  private async executeTasks(tasks: AnalysisTask[], onResult?: (index: number, result: ProcessResult) => void): Promise<ProcessResult[]> {
+    const results: ProcessResult[] = new Array(tasks.length);
+    const delivered = new Set<number>();
+    const deliver = (index: number, result: ProcessResult) => {
+      if (delivered.has(index)) {
+        return;
+      }
+      delivered.add(index);
+      results[index] = result;
+      if (onResult) {
+        onResult(index, result);
+      }
+    };
+    try {
+      (await this.executor.execute(tasks, deliver)).forEach((result, index) => deliver(index, result));
+      return results;
+    } catch (error) {
+      if (this.executor === this.localExecutor) {
+        throw error;
+      }
+      logger.warn(`Analysis daemon unavailable, running locally: ${error instanceof Error ? error.message : String(error)}`);
+      this.setExecutor(this.localExecutor);
+      const remaining = tasks.map((_, index) => index).filter(index => !delivered.has(index));
+      await this.localExecutor.execute(remaining.map(index => tasks[index]), (index, result) => deliver(remaining[index], result));
+      return results;
+    }
+  }
+
+  /**
+   * Create a task; identical command lines share one execution
+   */
+  private createTask(
+    file: string,
+    args: string[],
+    cwd: string,
+    priority: SchedulerTask['priority'],
+    cacheable: boolean,
+    entry: CompileCommand | undefined,
+    signal?: AbortSignal
+  ): AnalysisTask {
+    return {
+      file,
+      command: this.clangTidyPath,
+      args,
+      options: { cwd },
+      priority,
+      // Each workspace root gets a fair share of the shared pool
+      group: this.settings.getWorkspaceRoot() || undefined,
+      key: JSON.stringify([this.clangTidyPath, cwd, args]),
+      cacheKey: cacheable ? this.computeCacheKey(file, args, cwd, entry) : undefined,
+      cacheRoot: this.settings.getWorkspaceRoot() || undefined,
+      estimatedCost: this.estimateCost(file),
+      compileEntry: entry,
+      signal
+    };
+  }
+
+  /**
+   * Look up units in the per-check cache. Fix runs and runs already narrowed (check tiers) are not planned.
+   */
+  private async planCheckRuns(units: AnalysisUnit[], options: RunOptions, cwd: string): Promise<Map<AnalysisUnit, CheckPlan>> {
+    const plans = new Map<AnalysisUnit, CheckPlan>();
+    if (!this.checkCache || options.fix || options.checkFilter) {
+      return plans;
+    }
+    let narrowed = 0;
+    for (const unit of units) {
+      const set = await this.checkSetFor(unit.file, options);
+      if (!set || Object.keys(set.checks).length === 0) {
+        continue;
+      }
+      const key = this.computeCheckCacheKey(unit, options, cwd, set);
+      const plan = { key, set, ...this.checkCache.lookup(key, set, this.settings.getWorkspaceRoot() || undefined) };
+      if (!plan.result && plan.missing.length < Object.keys(set.checks).length) {
+        narrowed++;
+      }
+      plans.set(unit, plan);
+    }
+    if (narrowed > 0) {
+      logger.info(`Check cache: ${narrowed} translation units only rerun checks added or changed since their last analysis`);
+    }
+    return plans;
+  }
+
+  /**
+   * Enabled checks with their option fingerprints, from clang-tidy's view of the configuration of a file
+   */
+  private checkSetFor(file: string, options: RunOptions): Promise<CheckSet | null> {
+    const checkArgs = this.buildArguments([], options);
+    const configFileArg = checkArgs.find(arg => arg.startsWith('--config-file='));
+    const configFile = configFileArg ? configFileArg.substring('--config-file='.length) : this.findNearestConfig(file);
+    const identity = [...checkArgs, configFile || '', configFile ? this.includeGraph.hashFile(configFile) : ''].join('\0');
+    let set = this.checkSets.get(identity);
+    if (!set) {
+      set = Promise.all([
+        this.listChecks(checkArgs, file),
+        ProcessUtils.executeCommand(this.clangTidyPath, ['--dump-config', ...checkArgs, file])
+          .then(result => result.exitCode === 0 ? result.stdout : null)
+          .catch(() => null)
+      ]).then(([enabled, dumped]) => dumped === null ? null : CheckResultCache.checkSet(enabled, dumped));
+      this.checkSets.set(identity, set);
+    }
+    return set;
+  }
+
+  /**
+   * Per-check cache key: like the result cache key, but without the check selection and configuration file,
+   * which the check set covers check by check
+   */
+  private computeCheckCacheKey(unit: AnalysisUnit, options: RunOptions, cwd: string, set: CheckSet): string {
+    const args = this.buildArguments([unit.file], this.optionsFor(unit, options), this.compileDbDirFor(unit))
+      .filter(arg => !arg.startsWith('--config-file=') && !arg.startsWith('-checks='));
+    const includeDirs = unit.entry ? CompileDatabase.getIncludeDirs(unit.entry) : [];
+    return ResultCache.computeKey([...this.portableKeyParts(cwd, args, unit.entry),
+      this.includeGraph.fingerprint(unit.file, includeDirs, this.settings.getWorkspaceRoot() || undefined), set.global]);
+  }
+
+  /**
+   * Narrow options to their check tier; null if the configuration enables no check of that tier
+   */
+  private async applyCheckTier(options: RunOptions): Promise<RunOptions | null> {
+    if (!options.checkTier || options.checkFilter) {
+      return options;
+    }
+    if (!this.checkTiers) {
+      const config = this.settings.getTierConfig();
+      this.checkTiers = CheckTiers.load(config.slowChecks, config.profileDirectory);
+    }
+    const narrowed = { ...options, checkFilter: this.checkTiers.filterFor(options.checkTier, await this.listChecks(['-checks=*'])) };
+    const enabled = await this.listChecks(this.buildArguments([], narrowed));
+    if (enabled.length === 0) {
+      logger.info(`No ${options.checkTier} checks enabled, skipping that tier`);
+      return null;
+    }
+    logger.debug(`${options.checkTier} tier: ${enabled.length} checks`);
+    return narrowed;
+  }
+
+  /**
+   * Estimated analysis cost of a file: the configured estimator, else its last build time from .ninja_log
+   */
+  private estimateCost(file: string): number | undefined {
+    if (this.costEstimator) {
+      return this.costEstimator(file);
+    }
+    const buildGraph = NinjaGraph.find(this.settings.getCompileCommandsPath());
+    return buildGraph ? buildGraph.getBuildTime(file) : undefined;
+  }
+
+  /**
+   * Cache key covering the tool, its arguments, the compile command,
+   * the source with all project headers it includes, and the effective .clang-tidy
+   */
+  private computeCacheKey(file: string, args: string[], cwd: string, entry: CompileCommand | undefined): string {
+    const parts = [...this.portableKeyParts(cwd, args, entry)];
+    
+    const includeDirs = entry ? CompileDatabase.getIncludeDirs(entry) : [];
+    parts.push(this.includeGraph.fingerprint(file, includeDirs, this.settings.getWorkspaceRoot() || undefined));
+    
+    const configFileArg = args.find(arg => arg.startsWith('--config-file='));
+    const configFile = configFileArg ? configFileArg.substring('--config-file='.length) : this.findNearestConfig(file);
+    if (configFile) {
+      parts.push(this.portable(configFile), this.includeGraph.hashFile(configFile));
+    }
+    
+    return ResultCache.computeKey(parts);
+  }
+
+  /**
+   * Key parts naming the tool, directory, arguments and compile entry without depending on where the workspace is:
+   * the clang-tidy version stands for its path, paths are relative to the workspace root, and a generated
+   * single-entry database (a temporary directory) is covered by the entry itself
+   */
+  private portableKeyParts(cwd: string, args: string[], entry: CompileCommand | undefined): string[] {
+    return [
+      this.clangTidyVersion || this.clangTidyPath,
+      this.portable(cwd),
+      ...args.filter(arg => !(entry && arg.startsWith('-p='))).map(arg => this.portable(arg)),
+      this.portable(JSON.stringify(entry || null))
+    ];
+  }
+
+  private portable(text: string): string {
+    return ResultCache.relativize(text, this.settings.getWorkspaceRoot() || undefined);
+  }
+
+  /**
+   * Whether a file is governed by the workspace root's .clang-tidy (passed explicitly) or by none,
+   * so analyzing it from a generated source elsewhere applies the same checks
+   */
+  private sharesRootConfig(file: string): boolean {
+    const config = this.findNearestConfig(file);
+    const root = this.settings.getWorkspaceRoot();
+    return !config || (!!root && config === path.join(root, '.clang-tidy'));
+  }
+
+  /**
+   * Find the .clang-tidy file clang-tidy would pick up for a source file
+   */
+  private findNearestConfig(file: string): string | null {
+    let dir = path.dirname(file);
+    while (true) {
+      const candidate = path.join(dir, '.clang-tidy');
+      if (fs.existsSync(candidate)) {
+        return candidate;
+      }
+      const parent = path.dirname(dir);
+      if (parent === dir) {
+        return null;
+      }
+      dir = parent;
+    }
+  }
+
+  /**
+   * Load the configured compile database, or null if unavailable
+   */
+  private loadCompileDatabase(): CompileDatabase | null {
+    const compileCommandsPath = this.settings.getCompileCommandsPath();
+    try {
+      return FileUtils.exists(compileCommandsPath) ? CompileDatabase.load(compileCommandsPath) : null;
+    } catch (error) {
+      logger.warn(`Failed to load compile database ${compileCommandsPath}: ${error instanceof Error ? error.message : String(error)}`);
+      return null;
+    }
+  }
+
+  /**
+   * Resolver applying the compile database policy to the configured database and any additional ones
+   */
+  private createUnitResolver(): CompileUnitResolver {
+    const config = this.settings.getCompileDatabaseConfig();
+    const databases: NamedDatabase[] = [];
+    const primary = this.loadCompileDatabase();
+    if (primary) {
+      databases.push({ name: CompileUnitResolver.nameFor(this.settings.getCompileCommandsPath()), database: primary });
+      if (config.policy === 'union') {
+        for (const additionalPath of config.additionalPaths) {
+          try {
+            databases.push({ name: CompileUnitResolver.nameFor(additionalPath), database: CompileDatabase.load(additionalPath) });
+          } catch (error) {
+            logger.warn(`Failed to load compile database ${additionalPath}: ${error instanceof Error ? error.message : String(error)}`);
+          }
+        }
+      }
+    }
+    return new CompileUnitResolver(config.policy, databases);
+  }
+
+  /**
+   * Resolve files into analysis units. Headers without a compile command of their own are
+   * grouped onto including translation units, which are run with a header filter limited to them.
+   */
+  private resolveUnits(files: string[]): AnalysisUnit[] {
+    const resolver = this.createUnitResolver();
+    const database = this.loadCompileDatabase();
+    const headers = new Set(database
+      ? files.filter(file => HeaderMapper.isHeader(file) && database.getEntriesForFile(file).length === 0)
+      : []);
+    const units = files.filter(file => !headers.has(file)).flatMap(file => resolver.resolve(file));
+
+    if (database && headers.size > 0) {
+      const { assignments, unassigned } = this.headerMapper.assign(Array.from(headers), database, this.costEstimator || undefined);
+      for (const assignment of assignments) {
+        units.push(...resolver.resolve(assignment.entry.file).map(unit => ({ ...unit, headers: assignment.headers })));
+      }
+      units.push(...unassigned.map(file => ({ file, needsMinimalDatabase: false })));
+      logger.debug(`Analyzing ${headers.size - unassigned.length} headers through ${assignments.length} translation units`);
+    }
+    return units.map(unit => this.rewriteUnit(unit));
+  }
+
+  /**
+   * Apply the compile command rewrite rules; a rewritten command is passed through its own database
+   */
+  private rewriteUnit(unit: AnalysisUnit): AnalysisUnit {
+    if (!this.rewriter || !unit.entry) {
+      return unit;
+    }
+    const entry = this.rewriter.rewrite(unit.entry);
+    return entry === unit.entry ? unit : { ...unit, entry, needsMinimalDatabase: true };
+  }
+
+  /**
+   * Create the compile command rewriter from configuration, or null if disabled
+   */
+  private createRewriter(): CommandRewriter | null {
+    const config = this.settings.getCompileDatabaseConfig();
+    return config.rewrite || config.rewriteRules.length > 0 ? new CommandRewriter(config.rewriteRules, config.rewrite) : null;
+  }
+
+  /**
+   * Run options of a unit: header units only report diagnostics in their headers
+   */
+  private optionsFor(unit: AnalysisUnit, options: RunOptions): RunOptions {
+    if (!unit.headers) {
+      return options;
+    }
+    const escape = (file: string) => file.replace(/[.*+?^${}()|[\]\\]/g, '\\$&');
+    return { ...options, headerFilter: '^(' + unit.headers.map(escape).join('|') + ')$' };
+  }
+
+  /**
+   * Directory of a single-entry compile database for units whose command cannot be selected with the configured one
+   */
+  private compileDbDirFor(unit: AnalysisUnit): string | undefined {
+    if (!unit.needsMinimalDatabase || !unit.entry) {
+      return undefined;
+    }
+    try {
+      return MinimalDatabase.write(unit.entry);
+    } catch (error) {
+      logger.warn(`Failed to write compile database for ${unit.file}: ${error instanceof Error ? error.message : String(error)}`);
+      return undefined;
+    }
+  }
+
+  /**
+   * Create the result cache from configuration
+   */
+  private createCache(): ResultCache | null {
+    const cacheConfig = this.settings.getCacheConfig();
+    if (!cacheConfig.enabled) {
+      return null;
+    }
+    const directory = cacheConfig.directory ? this.settings.resolvePath(cacheConfig.directory) : null;
+    const cache = new ResultCache(directory);
+    if (cacheConfig.remote) {
+      const location = /^https?:\/\//.test(cacheConfig.remote) ? cacheConfig.remote : this.settings.resolvePath(cacheConfig.remote);
+      const backend = createRemoteBackend(location, cacheConfig.remoteToken || undefined);
+      cache.setRemote(backend, cacheConfig.remoteUpload);
+      logger.info(`Shared result cache: ${backend.describe()}${cacheConfig.remoteUpload ? ' (uploading)' : ''}`);
+    }
+    return cache;
+  }
+
+  /**
+   * Per-check result store, next to the result cache
+   */
+  private createCheckCache(): CheckResultCache | null {
+    const cacheConfig = this.settings.getCacheConfig();
+    if (!cacheConfig.enabled || !cacheConfig.checkDelta) {
+      return null;
+    }
+    return new CheckResultCache(cacheConfig.directory ? path.join(this.settings.resolvePath(cacheConfig.directory), 'checks') : null);
+  }
+
+  /**
+   * Keep only C/C++ sources and headers
+   */
+  private filterSourceFiles(files: string[]): string[] {
+    return files.filter(file => {
+      const ext = path.extname(file).toLowerCase();
+      return ['.cpp', '.hpp', '.cc', '.hh', '.cxx', '.hxx', '.c', '.h'].includes(ext);
+    });
   }
 
   /**
    * Build Clang-Tidy command arguments
    */
-  private buildArguments(files: string[], options: RunOptions): string[] {
+  private buildArguments(files: string[], options: RunOptions, compileDbDir?: string): string[] {
     const args: string[] = [];
     
     // Check if .clang-tidy file exists in workspace root
     let clangTidyConfigPath: string | null = null;
-    const workspaceRoot = vscode.workspace.workspaceFolders?.[0].uri.fsPath;
+    const workspaceRoot = this.settings.getWorkspaceRoot();
     if (workspaceRoot) {
       clangTidyConfigPath = path.join(workspaceRoot, '.clang-tidy');
       if (fs.existsSync(clangTidyConfigPath)) {
         logger.debug('Found .clang-tidy file at: ' + clangTidyConfigPath);
         args.push('--config-file=' + clangTidyConfigPath);
+        if (options.checkFilter) {
+          args.push('-checks=' + options.checkFilter);
+        }
       } else {
         logger.debug('No .clang-tidy file found at workspace root: ' + workspaceRoot);
         clangTidyConfigPath = null;
         
         // Only add checks parameter if no .clang-tidy file exists
-        const checks = options.checks || this.configManager.getChecks();
+        const checks = options.checks || this.settings.getChecks();
         const finalChecks = checks || '*';
-        args.push('-checks=' + finalChecks);
+        args.push('-checks=' + [finalChecks, options.checkFilter].filter(Boolean).join(','));
       }
     } else {
       // No workspace root, add checks parameter if configured
-      const checks = options.checks || this.configManager.getChecks();
+      const checks = options.checks || this.settings.getChecks();
       const finalChecks = checks || '*';
-      args.push('-checks=' + finalChecks);
+      args.push('-checks=' + [finalChecks, options.checkFilter].filter(Boolean).join(','));
     }
     
     // Header Filter - respect .clang-tidy's HeaderFilterRegex if it exists
-    const headerFilter = options.headerFilter || this.configManager.getHeaderFilter();
+    const headerFilter = options.headerFilter || this.settings.getHeaderFilter();
     if (headerFilter) {
       // Only add header-filter if explicitly configured by user
       args.push('-header-filter=' + headerFilter);
@@ -145,7 +787,7 @@ export class ClangTidyRunner {
     
     // Compile Commands - Always add compile_commands.json path
     // This ensures Clang-Tidy can find compilation database
-    const compileCommandsPath = this.configManager.getCompileCommandsPath();
+    const compileCommandsPath = compileDbDir || this.settings.getCompileCommandsPath();
     if (compileCommandsPath) {
       args.push('-p=' + compileCommandsPath);
       logger.debug('Added compile commands path: ' + compileCommandsPath);
@@ -154,17 +796,13 @@ export class ClangTidyRunner {
     }
     
     // Extra Arguments
-    const extraArgs = options.extraArgs || this.configManager.getExtraArgs();
+    const extraArgs = options.extraArgs || this.settings.getExtraArgs();
     if (extraArgs && extraArgs.length > 0) {
       extraArgs.forEach(arg => args.push(arg));
     }
     
     // Files - only include C++ files
-    const cppFiles = files.filter(file => {
-      const ext = path.extname(file).toLowerCase();
-      return ['.cpp', '.hpp', '.cc', '.hh', '.cxx', '.hxx', '.c', '.h'].includes(ext);
-    });
-    args.push(...cppFiles);
+    args.push(...this.filterSourceFiles(files));
     
     return args;
   }
@@ -180,6 +818,7 @@ export class ClangTidyRunner {
       const isAvailable = result.exitCode === 0 && result.stdout.includes('LLVM');
       
       if (isAvailable) {
+        this.clangTidyVersion = result.stdout.trim();
         logger.info('Clang-Tidy found: ' + result.stdout.trim());
       } else {
         logger.warn('Clang-Tidy not found or incompatible: ' + result.stdout + ' ' + result.stderr);
@@ -223,6 +862,21 @@ export class ClangTidyRunner {
     }
   }
 
+  /**
+   * Checks enabled by an argument list (e.g. -checks=* for all available ones), listed once per argument list
+   */
+  private listChecks(args: string[], file: string = '-'): Promise<string[]> {
+    const key = [...args, file].join('\0');
+    let listing = this.checkLists.get(key);
+    if (!listing) {
+      listing = ProcessUtils.executeCommand(this.clangTidyPath, ['-list-checks', ...args, file])
+        .then(result => result.exitCode === 0 ? this.parseChecksList(result.stdout) : [])
+        .catch(() => []);
+      this.checkLists.set(key, listing);
+    }
+    return listing;
+  }
+
   /**
    * Parse checks list from Clang-Tidy output
    */
@@ -232,7 +886,8 @@ export class ClangTidyRunner {
     
     for (const line of lines) {
       const trimmedLine = line.trim();
-      if (trimmedLine && !trimmedLine.startsWith('-') && !trimmedLine.startsWith('Checks')) {
+      // Skip the "Enabled checks:" heading
+      if (trimmedLine && !trimmedLine.startsWith('-') && !trimmedLine.startsWith('Checks') && !trimmedLine.endsWith(':')) {
         checks.push(trimmedLine);
       }
     }
@@ -244,8 +899,19 @@ export class ClangTidyRunner {
    * Refresh configuration
    */
   refreshConfiguration(): void {
-    this.clangTidyPath = this.configManager.getClangTidyPath();
-    this.compileCommandsPath = this.configManager.getCompileCommandsPath();
+    this.clangTidyPath = this.settings.getClangTidyPath();
+    this.compileCommandsPath = this.settings.getCompileCommandsPath();
+    this.scheduler.setConcurrency(this.settings.getParallelJobs());
+    const usingLocalExecutor = this.executor === this.localExecutor;
+    this.localExecutor = new LocalExecutor(this.scheduler, this.createCache());
+    this.rewriter = this.createRewriter();
+    this.checkTiers = null;
+    this.checkLists.clear();
+    this.checkCache = this.createCheckCache();
+    this.checkSets.clear();
+    if (usingLocalExecutor) {
+      this.executor = this.localExecutor;
+    }
     logger.info('Clang-Tidy Runner configuration refreshed');
   }
 }
\ No newline at end of file
@@ -0,0 +1,183 @@
+// Preamble Builder - Precompiles the third-party headers shared by groups of translation units
+import * as crypto from 'crypto';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import { logger } from '../../utils/logger';
+import { CompileCommand, CompileDatabase } from '../compiledb/CompileDatabase';
+import { AnalysisUnit, CompileUnitResolver } from '../compiledb/CompileUnitResolver';
+import { CommandRewriter } from '../compiledb/CommandRewriter';
+import { IncludeGraph } from '../compiledb/IncludeGraph';
+import { Scheduler, TaskPriority } from './Scheduler';
+
+// Below this many translation units a group is not worth a precompile step
+const MIN_GROUP_SIZE = 3;
+// Headers without include guards must be re-included by every TU, so the shared prefix stops there
+const UNGUARDED_HEADERS = ['assert.h', 'cassert'];
+// clang-tidy options that add compiler flags in front of or behind the compile command
+const EXTRA_ARG = /^--?extra-arg(-before)?(=|$)/;
+
+type LeadingInclude = ReturnType<IncludeGraph['getLeadingIncludes']>[number];
+
+export class PreambleBuilder {
+  constructor(
+    private scheduler: Scheduler,
+    private includeGraph: IncludeGraph,
+    private clangPath: string,
+    private baseDir: string = path.join(os.tmpdir(), 'clang-tidy-visualizer', 'pch')
+  ) {}
+
+  /**
+   * The clang driver of the same installation as clang-tidy; PCH files only load in the version that wrote them
+   */
+  static findClang(clangTidyPath: string): string {
+    const dir = path.dirname(clangTidyPath);
+    const name = path.basename(clangTidyPath).replace('clang-tidy', 'clang');
+    return dir === '.' && !clangTidyPath.startsWith('.') ? name : path.join(dir, name);
+  }
+
+  /**
+   * Compiler flags clang-tidy adds to every compile command through --extra-arg-before and --extra-arg
+   */
+  static extraCompilerFlags(clangTidyArgs: string[]): { before: string[]; after: string[] } {
+    const flags = { before: [] as string[], after: [] as string[] };
+    for (let i = 0; i < clangTidyArgs.length; i++) {
+      const match = EXTRA_ARG.exec(clangTidyArgs[i]);
+      if (!match) {
+        continue;
+      }
+      const value = match[2] === '=' ? clangTidyArgs[i].substring(match[0].length) : clangTidyArgs[++i];
+      if (value !== undefined) {
+        (match[1] ? flags.before : flags.after).push(value);
+      }
+    }
+    return flags;
+  }
+
+  /**
+   * Group units by flag set, precompile the longest run of non-project headers every TU of a group
+   * starts with, and inject the result with -include-pch. Project headers are never precompiled,
+   * so their diagnostics are still reported. Units of groups that fail to build are returned unchanged.
+   * The PCH is built with the flags clang-tidy adds (extraArgs), since clang rejects a PCH whose
+   * language options or macros differ from the TU's.
+   */
+  async apply(units: AnalysisUnit[], workspaceRoot: string | null, priority: TaskPriority, extraArgs: string[] = []): Promise<AnalysisUnit[]> {
+    const extra = PreambleBuilder.extraCompilerFlags(extraArgs);
+    const groups = new Map<string, AnalysisUnit[]>();
+    for (const unit of units) {
+      if (!unit.entry || CommandRewriter.detectDriver(unit.entry.arguments) === 'cl' || unit.entry.arguments.includes('-include-pch')) {
+        continue;
+      }
+      const key = CompileUnitResolver.flagSetKey(unit.entry) + (path.extname(unit.file).toLowerCase() === '.c' ? ':c' : ':c++');
+      const group = groups.get(key);
+      if (group) {
+        group.push(unit);
+      } else {
+        groups.set(key, [unit]);
+      }
+    }
+
+    const replacements = new Map<AnalysisUnit, AnalysisUnit>();
+    await Promise.all(Array.from(groups.values())
+      .filter(group => group.length >= MIN_GROUP_SIZE)
+      .map(async group => {
+        const prefix = this.commonPrefix(group, workspaceRoot);
+        if (prefix.length === 0) {
+          return;
+        }
+        const pch = await this.build(group[0].entry!, extra, prefix, path.extname(group[0].file).toLowerCase() === '.c', priority);
+        if (!pch) {
+          return;
+        }
+        for (const unit of group) {
+          const args = unit.entry!.arguments;
+          const split = PreambleBuilder.firstFlagIndex(args);
+          replacements.set(unit, {
+            ...unit,
+            entry: { ...unit.entry!, arguments: [...args.slice(0, split), '-include-pch', pch, ...args.slice(split)] },
+            needsMinimalDatabase: true
+          });
+        }
+        logger.debug(`Precompiled ${prefix.length} shared headers for ${group.length} translation units`);
+      }));
+
+    return units.map(unit => replacements.get(unit) || unit);
+  }
+
+  /**
+   * Index of the first flag, skipping the compiler and any launcher (ccache) in front of it
+   */
+  private static firstFlagIndex(args: string[]): number {
+    const index = args.findIndex((arg, i) => i > 0 && arg.startsWith('-'));
+    return index < 0 ? args.length : index;
+  }
+
+  /**
+   * Longest include prefix shared by every unit of a group, cut at the first project or unguarded header
+   */
+  private commonPrefix(group: AnalysisUnit[], workspaceRoot: string | null): LeadingInclude[] {
+    const root = workspaceRoot ? path.normalize(workspaceRoot + path.sep) : null;
+    const identity = (include: LeadingInclude) => include.resolved || (include.quoted ? `"${include.name}"` : `<${include.name}>`);
+    let prefix: LeadingInclude[] | null = null;
+
+    for (const unit of group) {
+      const includes = this.includeGraph.getLeadingIncludes(unit.file, CompileDatabase.getIncludeDirs(unit.entry!));
+      const usable: LeadingInclude[] = [];
+      for (const include of includes) {
+        if ((include.resolved && root && include.resolved.startsWith(root)) || UNGUARDED_HEADERS.includes(include.name)) {
+          break;
+        }
+        usable.push(include);
+      }
+      if (prefix === null) {
+        prefix = usable;
+      } else {
+        let length = 0;
+        while (length < prefix.length && length < usable.length && identity(prefix[length]) === identity(usable[length])) {
+          length++;
+        }
+        prefix = prefix.slice(0, length);
+      }
+      if (prefix.length === 0) {
+        break;
+      }
+    }
+    return prefix || [];
+  }
+
+  /**
+   * Build the PCH for a preamble with the flags of an entry and the extra flags; returns its path, or null on failure
+   */
+  private async build(entry: CompileCommand, extra: { before: string[]; after: string[] }, prefix: LeadingInclude[], isC: boolean, priority: TaskPriority): Promise<string | null> {
+    const content = prefix
+      .map(include => include.resolved ? `#include "${include.resolved}"` : include.quoted ? `#include "${include.name}"` : `#include <${include.name}>`)
+      .join('\n') + '\n';
+    const args = CompileUnitResolver.stripInputOutput(entry);
+    const flags = [...extra.before, ...args.slice(PreambleBuilder.firstFlagIndex(args)), ...extra.after];
+    const hash = crypto.createHash('sha256').update(JSON.stringify([this.clangPath, entry.directory, flags, content])).digest('hex').substring(0, 24);
+    const dir = path.join(this.baseDir, hash);
+    const header = path.join(dir, isC ? 'preamble.h' : 'preamble.hpp');
+    const pch = path.join(dir, 'preamble.pch');
+
+    try {
+      fs.mkdirSync(dir, { recursive: true });
+      fs.writeFileSync(header, content, 'utf8');
+    } catch (error) {
+      logger.warn(`Failed to write preamble ${header}: ${error instanceof Error ? error.message : String(error)}`);
+      return null;
+    }
+
+    const result = await this.scheduler.submit({
+      command: this.clangPath,
+      args: [...flags, '-w', '-x', isC ? 'c-header' : 'c++-header', header, '-Xclang', '-emit-pch', '-o', pch],
+      options: { cwd: entry.directory },
+      priority,
+      key: 'pch:' + hash
+    });
+    if (result.exitCode !== 0) {
+      logger.warn(`Failed to precompile shared headers with ${this.clangPath}: ${result.stderr.split('\n')[0]}`);
+      return null;
+    }
+    return pch;
+  }
+}
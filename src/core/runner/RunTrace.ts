@@ -0,0 +1,204 @@
+// Run Trace - Records every clang-tidy execution of a run and replays them without clang-tidy
+import * as crypto from 'crypto';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import * as zlib from 'zlib';
+import { RunOptions } from '../../types';
+import { ProcessResult } from '../../utils/processUtils';
+import { logger } from '../../utils/logger';
+import { AnalysisExecutor, AnalysisTask } from './AnalysisExecutor';
+import { Scheduler } from './Scheduler';
+
+const TRACE_FORMAT_VERSION = 1;
+
+// Prints a recorded execution's output after its recorded duration and exits with its status
+const REPLAY_SCRIPT = 'const r = JSON.parse(require("fs").readFileSync(process.argv[1], "utf8"));' +
+  'setTimeout(() => { process.stdout.write(r.stdout); process.stderr.write(r.stderr); process.exitCode = r.exitCode; },' +
+  ' process.argv[2] === "none" ? 0 : r.duration);';
+
+export interface TraceHeader {
+  type: 'start';
+  version: number;
+  createdAt: string;
+  clangTidyVersion: string;
+  root: string;
+  compileCommands: string;
+  jobs: number;
+  files: string[];
+  options: RunOptions;
+  // Runner settings of the recording
+  settings: Record<string, unknown>;
+}
+
+export interface TraceRecord {
+  type: 'task';
+  file: string;
+  command: string;
+  args: string[];
+  cwd?: string;
+  // Milliseconds since the recording started
+  start: number;
+  duration: number;
+  exitCode: number;
+  stdout: string;
+  stderr: string;
+}
+
+export type ReplayTiming = 'recorded' | 'none';
+
+/**
+ * Executor decorator recording the executions of the executor it wraps
+ */
+export class TraceRecorder implements AnalysisExecutor {
+  private records: TraceRecord[] = [];
+  private startTime = Date.now();
+
+  constructor(private inner: AnalysisExecutor) {}
+
+  execute(tasks: AnalysisTask[], onResult?: (index: number, result: ProcessResult) => void): Promise<ProcessResult[]> {
+    return this.inner.execute(tasks, (index, result) => {
+      if (!result.cancelled) {
+        const task = tasks[index];
+        this.records.push({
+          type: 'task',
+          file: task.file,
+          command: task.command,
+          args: task.args,
+          cwd: task.options?.cwd?.toString(),
+          start: Math.max(0, Date.now() - this.startTime - result.duration),
+          duration: result.duration,
+          exitCode: result.exitCode,
+          stdout: result.stdout,
+          stderr: result.stderr
+        });
+      }
+      if (onResult) {
+        onResult(index, result);
+      }
+    });
+  }
+
+  prefetch(tasks: AnalysisTask[]): void {
+    if (this.inner.prefetch) {
+      this.inner.prefetch(tasks);
+    }
+  }
+
+  /**
+   * Write the trace as gzip-compressed JSON lines: a header, then one record per execution in completion order
+   */
+  save(filePath: string, header: Omit<TraceHeader, 'type' | 'version' | 'createdAt'>): void {
+    const start: TraceHeader = { type: 'start', version: TRACE_FORMAT_VERSION, createdAt: new Date().toISOString(), ...header };
+    const lines = [start, ...this.records].map(record => JSON.stringify(record) + '\n').join('');
+    fs.mkdirSync(path.dirname(path.resolve(filePath)), { recursive: true });
+    fs.writeFileSync(filePath, zlib.gzipSync(lines));
+    logger.info(`Recorded ${this.records.length} executions to ${filePath}`);
+  }
+
+  getRecords(): TraceRecord[] {
+    return this.records;
+  }
+
+  dispose(): void {
+    this.inner.dispose();
+  }
+}
+
+/**
+ * Executor answering tasks from a trace. Each execution is replayed by a small Node.js process scheduled
+ * like clang-tidy would be, so scheduling, process and pipe handling, parsing and reporting all run for real.
+ */
+export class TraceReplayer implements AnalysisExecutor {
+  // Recordings per file, taken in recorded order
+  private byFile = new Map<string, TraceRecord[]>();
+  private directory: string;
+  private replayed = 0;
+
+  private constructor(
+    private header: TraceHeader,
+    private records: TraceRecord[],
+    private scheduler: Scheduler,
+    private timing: ReplayTiming
+  ) {
+    for (const record of records) {
+      const list = this.byFile.get(record.file) || [];
+      list.push(record);
+      this.byFile.set(record.file, list);
+    }
+    const id = crypto.createHash('sha256').update(`${process.pid}\0${header.createdAt}\0${Date.now()}`).digest('hex').substring(0, 16);
+    this.directory = path.join(os.tmpdir(), 'clang-tidy-visualizer', 'replay', id);
+  }
+
+  /**
+   * Read a trace written by TraceRecorder.save
+   */
+  static read(filePath: string): { header: TraceHeader; records: TraceRecord[] } {
+    const lines = zlib.gunzipSync(fs.readFileSync(filePath)).toString('utf8').split('\n').filter(line => line.trim());
+    const header = JSON.parse(lines[0]) as TraceHeader;
+    if (header.type !== 'start' || header.version !== TRACE_FORMAT_VERSION) {
+      throw new Error(`${filePath} is not a version ${TRACE_FORMAT_VERSION} run trace`);
+    }
+    return { header, records: lines.slice(1).map(line => JSON.parse(line) as TraceRecord) };
+  }
+
+  static load(filePath: string, scheduler: Scheduler, timing: ReplayTiming = 'recorded'): TraceReplayer {
+    const { header, records } = TraceReplayer.read(filePath);
+    return new TraceReplayer(header, records, scheduler, timing);
+  }
+
+  getHeader(): TraceHeader {
+    return this.header;
+  }
+
+  /**
+   * End of the last recorded execution: the makespan of the recorded run
+   */
+  getRecordedMakespan(): number {
+    return this.records.reduce((end, record) => Math.max(end, record.start + record.duration), 0);
+  }
+
+  async execute(tasks: AnalysisTask[], onResult?: (index: number, result: ProcessResult) => void): Promise<ProcessResult[]> {
+    fs.mkdirSync(this.directory, { recursive: true });
+    return Promise.all(tasks.map(async (task, index) => {
+      const record = this.take(task);
+      let result: ProcessResult;
+      if (!record) {
+        logger.warn(`No recorded execution of ${task.file} in the trace`);
+        result = { stdout: '', stderr: `ctv: ${task.file} is not in the replayed trace`, exitCode: 1, duration: 0 };
+      } else {
+        const recordFile = path.join(this.directory, `${this.replayed++}.json`);
+        fs.writeFileSync(recordFile, JSON.stringify({ stdout: record.stdout, stderr: record.stderr, exitCode: record.exitCode, duration: record.duration }));
+        result = await this.scheduler.submit({
+          command: process.execPath,
+          args: ['-e', REPLAY_SCRIPT, recordFile, this.timing],
+          priority: task.priority,
+          group: task.group,
+          signal: task.signal
+        });
+      }
+      if (onResult) {
+        onResult(index, result);
+      }
+      return result;
+    }));
+  }
+
+  /**
+   * Recording of a task: one with the same arguments if there is one, else the next one of the file.
+   * A file asked for more often than it was recorded (e.g. a fallback rerun) gets its last recording again.
+   */
+  private take(task: AnalysisTask): TraceRecord | undefined {
+    const list = this.byFile.get(task.file);
+    if (!list || list.length === 0) {
+      return undefined;
+    }
+    const key = JSON.stringify(task.args);
+    const index = Math.max(0, list.findIndex(record => JSON.stringify(record.args) === key));
+    return list.length > 1 ? list.splice(index, 1)[0] : list[0];
+  }
+
+  dispose(): void {
+    fs.rmSync(this.directory, { recursive: true, force: true });
+  }
+}
@@ -0,0 +1,309 @@
+// Analysis Scheduler - Process-wide worker pool shared by every analysis request
+import * as child_process from 'child_process';
+import { ProcessUtils, ProcessResult } from '../../utils/processUtils';
+import { logger } from '../../utils/logger';
+
+// Priority classes, highest first
+export type TaskPriority = 'interactive' | 'normal' | 'background';
+
+const PRIORITY_ORDER: TaskPriority[] = ['interactive', 'normal', 'background'];
+
+export interface SchedulerTask {
+  command: string;
+  args: string[];
+  options?: child_process.SpawnOptions;
+  priority?: TaskPriority;
+  // Single-flight key: tasks with the same key share one execution and its result
+  key?: string;
+  // Fairness group (e.g. workspace root): within a priority class, groups take turns
+  group?: string;
+  // Aborting drops the task if it is still queued and kills its process if it is running
+  signal?: AbortSignal;
+}
+
+interface PendingTask {
+  task: SchedulerTask;
+  priority: TaskPriority;
+  resolve: (result: ProcessResult) => void;
+}
+
+// One execution shared by every submitter of its key; it is cancelled once all of them have aborted
+interface Execution {
+  promise: Promise<ProcessResult>;
+  pending: PendingTask | null;
+  controller: AbortController;
+  // Submitters that have not aborted (those without a signal never do)
+  sharers: number;
+}
+
+export class Scheduler {
+  private static instance: Scheduler | null = null;
+  private concurrency: number = ProcessUtils.getCpuCount();
+  private running = 0;
+  // Per priority class, one FIFO per group; Map order is the round-robin order
+  private queues: Record<TaskPriority, Map<string, PendingTask[]>> = {
+    interactive: new Map(),
+    normal: new Map(),
+    background: new Map()
+  };
+  private inFlight = new Map<string, Execution>();
+
+  private constructor() {}
+
+  /**
+   * Get Scheduler instance (Singleton)
+   */
+  static getInstance(): Scheduler {
+    if (!Scheduler.instance) {
+      Scheduler.instance = new Scheduler();
+    }
+    return Scheduler.instance;
+  }
+
+  /**
+   * Set the global concurrency limit shared by all callers
+   */
+  setConcurrency(limit: number): void {
+    const newLimit = Math.max(1, Math.floor(limit));
+    if (newLimit !== this.concurrency) {
+      logger.debug(`Scheduler concurrency limit set to ${newLimit}`);
+      this.concurrency = newLimit;
+      this.pump();
+    }
+  }
+
+  /**
+   * Get the global concurrency limit
+   */
+  getConcurrency(): number {
+    return this.concurrency;
+  }
+
+  /**
+   * Number of tasks currently executing and waiting
+   */
+  getLoad(): { running: number; queued: number } {
+    let queued = 0;
+    for (const priority of PRIORITY_ORDER) {
+      this.queues[priority].forEach(queue => queued += queue.length);
+    }
+    return { running: this.running, queued };
+  }
+
+  /**
+   * Submit a single task. Never rejects: spawn failures are reported as a failed result.
+   * A task whose key is in flight joins that execution; aborting resolves this submitter as cancelled,
+   * and the execution itself is only cancelled when every submitter sharing it has aborted.
+   */
+  submit(task: SchedulerTask): Promise<ProcessResult> {
+    const priority = task.priority || 'normal';
+    if (task.signal?.aborted) {
+      return Promise.resolve(Scheduler.cancelledResult());
+    }
+
+    if (task.key) {
+      const existing = this.inFlight.get(task.key);
+      if (existing) {
+        logger.debug(`Sharing in-flight execution for ${task.key}`);
+        // Raise a still-queued duplicate to the higher of both priorities
+        if (existing.pending && this.rank(priority) < this.rank(existing.pending.priority)) {
+          this.requeue(existing.pending, priority);
+        }
+        return this.join(existing, task);
+      }
+    }
+
+    let resolveResult!: (result: ProcessResult) => void;
+    const promise = new Promise<ProcessResult>((resolve) => {
+      resolveResult = resolve;
+    });
+    const controller = new AbortController();
+    const pending: PendingTask = { task: { ...task, signal: controller.signal }, priority, resolve: resolveResult };
+    const execution: Execution = { promise, pending, controller, sharers: 0 };
+
+    if (task.key) {
+      const key = task.key;
+      this.inFlight.set(key, execution);
+      promise.then(() => {
+        if (this.inFlight.get(key) === execution) {
+          this.inFlight.delete(key);
+        }
+      });
+    }
+
+    const onAbort = () => {
+      if (this.remove(pending)) {
+        pending.resolve(Scheduler.cancelledResult());
+      }
+    };
+    controller.signal.addEventListener('abort', onAbort, { once: true });
+    promise.then(() => controller.signal.removeEventListener('abort', onAbort));
+
+    const result = this.join(execution, task);
+    this.enqueue(pending);
+    this.pump();
+    return result;
+  }
+
+  /**
+   * Result of an execution for one submitter, resolved as cancelled as soon as its own signal aborts
+   */
+  private join(execution: Execution, task: SchedulerTask): Promise<ProcessResult> {
+    execution.sharers++;
+    const signal = task.signal;
+    if (!signal) {
+      return execution.promise;
+    }
+    return new Promise<ProcessResult>(resolve => {
+      const onAbort = () => {
+        resolve(Scheduler.cancelledResult());
+        if (--execution.sharers === 0) {
+          // Later submitters of the key start afresh instead of joining an execution being cancelled
+          if (task.key && this.inFlight.get(task.key) === execution) {
+            this.inFlight.delete(task.key);
+          }
+          execution.controller.abort();
+        }
+      };
+      signal.addEventListener('abort', onAbort, { once: true });
+      execution.promise.then(result => {
+        signal.removeEventListener('abort', onAbort);
+        resolve(result);
+      });
+    });
+  }
+
+  /**
+   * Submit a group of tasks and wait for all of them, preserving input order
+   */
+  async submitAll(
+    tasks: SchedulerTask[],
+    onProgress?: (completed: number, total: number) => void
+  ): Promise<ProcessResult[]> {
+    let completed = 0;
+    const total = tasks.length;
+
+    logger.debug(`Submitting ${total} tasks to scheduler (limit ${this.concurrency}, running ${this.running})`);
+
+    return Promise.all(tasks.map(task => this.submit(task).then(result => {
+      completed++;
+      if (onProgress) {
+        onProgress(completed, total);
+      }
+      return result;
+    })));
+  }
+
+  /**
+   * Start queued tasks while there is free capacity
+   */
+  private pump(): void {
+    while (this.running < this.concurrency) {
+      const next = this.dequeue();
+      if (!next) {
+        return;
+      }
+      this.start(next);
+    }
+  }
+
+  /**
+   * Take the next task from the highest non-empty priority class.
+   * Groups in a class are served in turn, so a large run in one workspace root
+   * does not starve the others.
+   */
+  private dequeue(): PendingTask | null {
+    for (const priority of PRIORITY_ORDER) {
+      const groups = this.queues[priority];
+      for (const [group, queue] of groups) {
+        const next = queue.shift();
+        // Move the group to the back of the rotation (or drop it when drained)
+        groups.delete(group);
+        if (queue.length > 0) {
+          groups.set(group, queue);
+        }
+        if (next) {
+          return next;
+        }
+      }
+    }
+    return null;
+  }
+
+  private enqueue(pending: PendingTask): void {
+    const groups = this.queues[pending.priority];
+    const group = pending.task.group || '';
+    const queue = groups.get(group);
+    if (queue) {
+      queue.push(pending);
+    } else {
+      groups.set(group, [pending]);
+    }
+  }
+
+  /**
+   * Execute a task and release its slot when done
+   */
+  private start(pending: PendingTask): void {
+    const { task } = pending;
+    this.running++;
+
+    if (task.key) {
+      const entry = this.inFlight.get(task.key);
+      if (entry && entry.pending === pending) {
+        entry.pending = null;
+      }
+    }
+
+    ProcessUtils.executeCommand(task.command, task.args, { ...task.options, signal: task.signal })
+      .catch((error): ProcessResult => {
+        if (task.signal?.aborted) {
+          return Scheduler.cancelledResult();
+        }
+        const errorMsg = error instanceof Error ? error.message : String(error);
+        logger.error(`Scheduled task failed: ${errorMsg}`);
+        return { stdout: '', stderr: errorMsg, exitCode: 1, duration: 0 };
+      })
+      .then((result) => {
+        this.running--;
+        pending.resolve(result);
+        this.pump();
+      });
+  }
+
+  /**
+   * Move a queued task into another priority class
+   */
+  private requeue(pending: PendingTask, priority: TaskPriority): void {
+    if (this.remove(pending)) {
+      pending.priority = priority;
+      this.enqueue(pending);
+    }
+  }
+
+  /**
+   * Take a task out of its queue; false if it is not queued (already started)
+   */
+  private remove(pending: PendingTask): boolean {
+    const groups = this.queues[pending.priority];
+    const group = pending.task.group || '';
+    const queue = groups.get(group);
+    const index = queue ? queue.indexOf(pending) : -1;
+    if (!queue || index === -1) {
+      return false;
+    }
+    queue.splice(index, 1);
+    if (queue.length === 0) {
+      groups.delete(group);
+    }
+    return true;
+  }
+
+  private static cancelledResult(): ProcessResult {
+    return { stdout: '', stderr: '', exitCode: 1, duration: 0, cancelled: true };
+  }
+
+  private rank(priority: TaskPriority): number {
+    return PRIORITY_ORDER.indexOf(priority);
+  }
+}
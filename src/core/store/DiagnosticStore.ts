@@ -0,0 +1,47 @@
+// Diagnostic Store - Latest diagnostics per translation unit
+import { ClangTidyDiagnostic } from '../../types';
+
+export class DiagnosticStore {
+  private byTranslationUnit = new Map<string, ClangTidyDiagnostic[]>();
+
+  /**
+   * Replace the diagnostics produced by analyzing a translation unit
+   */
+  update(translationUnit: string, diagnostics: ClangTidyDiagnostic[]): void {
+    this.byTranslationUnit.set(translationUnit, diagnostics);
+  }
+
+  /**
+   * Forget a translation unit
+   */
+  remove(translationUnit: string): void {
+    this.byTranslationUnit.delete(translationUnit);
+  }
+
+  /**
+   * Get diagnostics located in, or produced by analyzing, any of the given files.
+   * Returns everything when no files are given.
+   */
+  query(files?: string[]): ClangTidyDiagnostic[] {
+    const result: ClangTidyDiagnostic[] = [];
+    const wanted = files ? new Set(files) : null;
+
+    for (const [translationUnit, diagnostics] of this.byTranslationUnit) {
+      const wholeUnit = !wanted || wanted.has(translationUnit);
+      for (const diagnostic of diagnostics) {
+        if (wholeUnit || wanted!.has(diagnostic.filePath)) {
+          result.push(diagnostic);
+        }
+      }
+    }
+
+    return result;
+  }
+
+  /**
+   * Number of translation units with stored results
+   */
+  size(): number {
+    return this.byTranslationUnit.size;
+  }
+}
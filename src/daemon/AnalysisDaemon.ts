@@ -0,0 +1,208 @@
+// Analysis Daemon - Shares one worker pool and result cache across VS Code windows
+import * as fs from 'fs';
+import * as net from 'net';
+import { Scheduler } from '../core/runner/Scheduler';
+import { AnalysisTask } from '../core/runner/AnalysisExecutor';
+import { ResultCache } from '../core/cache/ResultCache';
+import { logger } from '../utils/logger';
+import { DaemonRequest, PROTOCOL_VERSION, onMessages, sendMessage } from './protocol';
+
+export interface DaemonOptions {
+  socketPath: string;
+  jobs: number;
+  cacheDirectory?: string;
+  // Exit after this long without connected clients (0 = never)
+  idleTimeoutMs: number;
+}
+
+export class AnalysisDaemon {
+  private server: net.Server | null = null;
+  private clients = new Set<net.Socket>();
+  private scheduler: Scheduler;
+  private cache: ResultCache;
+  private idleTimer: NodeJS.Timeout | null = null;
+  // Per client, the abort controllers of the tasks of each unfinished run
+  private runs = new Map<net.Socket, Map<number, AbortController[]>>();
+
+  constructor(private options: DaemonOptions) {
+    this.scheduler = Scheduler.getInstance();
+    this.scheduler.setConcurrency(options.jobs);
+    this.cache = new ResultCache(options.cacheDirectory || null);
+  }
+
+  /**
+   * Start listening; replaces a stale socket left behind by a crashed daemon
+   */
+  async start(): Promise<void> {
+    if (process.platform !== 'win32' && fs.existsSync(this.options.socketPath)) {
+      if (await this.isSocketAlive()) {
+        throw new Error(`Another daemon is already listening on ${this.options.socketPath}`);
+      }
+      logger.info(`Removing stale socket ${this.options.socketPath}`);
+      fs.unlinkSync(this.options.socketPath);
+    }
+
+    this.server = net.createServer(socket => this.handleConnection(socket));
+    await new Promise<void>((resolve, reject) => {
+      this.server!.once('error', reject);
+      this.server!.listen(this.options.socketPath, () => {
+        this.server!.off('error', reject);
+        resolve();
+      });
+    });
+
+    logger.info(`Analysis daemon ${process.pid} listening on ${this.options.socketPath} with ${this.options.jobs} jobs`);
+    this.armIdleTimer();
+  }
+
+  /**
+   * Stop accepting clients and exit
+   */
+  stop(): void {
+    logger.info('Analysis daemon shutting down');
+    for (const client of this.clients) {
+      client.destroy();
+    }
+    this.server?.close();
+    if (process.platform !== 'win32' && fs.existsSync(this.options.socketPath)) {
+      try {
+        fs.unlinkSync(this.options.socketPath);
+      } catch (error) {
+        // Already gone
+      }
+    }
+    process.exit(0);
+  }
+
+  /**
+   * Handle a new client connection
+   */
+  private handleConnection(socket: net.Socket): void {
+    this.clients.add(socket);
+    this.disarmIdleTimer();
+    logger.debug(`Client connected (${this.clients.size} total)`);
+
+    onMessages<DaemonRequest>(
+      socket,
+      message => {
+        this.handleRequest(socket, message).catch(error => {
+          sendMessage(socket, { id: message.id, type: 'error', message: error instanceof Error ? error.message : String(error) });
+        });
+      },
+      line => logger.warn(`Ignoring malformed message: ${line.substring(0, 200)}`)
+    );
+
+    socket.on('error', error => logger.debug(`Client socket error: ${error.message}`));
+    socket.on('close', () => {
+      this.clients.delete(socket);
+      // Nobody is left to receive the results of its runs
+      this.runs.get(socket)?.forEach(controllers => controllers.forEach(controller => controller.abort()));
+      this.runs.delete(socket);
+      logger.debug(`Client disconnected (${this.clients.size} remaining)`);
+      this.armIdleTimer();
+    });
+  }
+
+  /**
+   * Dispatch a single request
+   */
+  private async handleRequest(socket: net.Socket, request: DaemonRequest): Promise<void> {
+    switch (request.type) {
+      case 'hello':
+        if (request.version !== PROTOCOL_VERSION) {
+          sendMessage(socket, { id: request.id, type: 'error', message: `Protocol version mismatch: daemon ${PROTOCOL_VERSION}, client ${request.version}` });
+          return;
+        }
+        sendMessage(socket, { id: request.id, type: 'hello', version: PROTOCOL_VERSION, pid: process.pid });
+        break;
+      case 'run':
+        await this.runTasks(socket, request.id, request.tasks);
+        break;
+      case 'cancel': {
+        const controllers = this.runs.get(socket)?.get(request.run);
+        request.indexes.forEach(index => controllers?.[index]?.abort());
+        break;
+      }
+      case 'status': {
+        const load = this.scheduler.getLoad();
+        const cacheStats = this.cache.getStats();
+        sendMessage(socket, {
+          id: request.id,
+          type: 'status',
+          status: {
+            pid: process.pid,
+            clients: this.clients.size,
+            running: load.running,
+            queued: load.queued,
+            concurrency: this.scheduler.getConcurrency(),
+            cacheHits: cacheStats.hits,
+            cacheMisses: cacheStats.misses
+          }
+        });
+        break;
+      }
+      case 'shutdown':
+        sendMessage(socket, { id: request.id, type: 'done' });
+        setImmediate(() => this.stop());
+        break;
+      default:
+        sendMessage(socket, { id: (request as DaemonRequest).id, type: 'error', message: 'Unknown request type' });
+    }
+  }
+
+  /**
+   * Run tasks, streaming each result back as soon as it is available
+   */
+  private async runTasks(socket: net.Socket, id: number, tasks: AnalysisTask[]): Promise<void> {
+    logger.info(`Run request ${id}: ${tasks.length} tasks`);
+    const controllers = tasks.map(() => new AbortController());
+    const runs = this.runs.get(socket) || new Map<number, AbortController[]>();
+    runs.set(id, controllers);
+    this.runs.set(socket, runs);
+
+    await Promise.all(tasks.map(async (task, index) => {
+      let result = task.cacheKey ? this.cache.get(task.cacheKey, task.cacheRoot) : undefined;
+      const cached = !!result;
+      if (!result) {
+        result = await this.scheduler.submit({ ...task, signal: controllers[index].signal });
+        if (task.cacheKey && !result.cancelled) {
+          this.cache.set(task.cacheKey, result, task.cacheRoot);
+        }
+      }
+      sendMessage(socket, { id, type: 'result', index, result, cached });
+    }));
+
+    runs.delete(id);
+    sendMessage(socket, { id, type: 'done' });
+  }
+
+  private armIdleTimer(): void {
+    if (this.options.idleTimeoutMs > 0 && this.clients.size === 0 && !this.idleTimer) {
+      this.idleTimer = setTimeout(() => {
+        logger.info('No clients connected, daemon idle timeout reached');
+        this.stop();
+      }, this.options.idleTimeoutMs);
+    }
+  }
+
+  private disarmIdleTimer(): void {
+    if (this.idleTimer) {
+      clearTimeout(this.idleTimer);
+      this.idleTimer = null;
+    }
+  }
+
+  /**
+   * Check whether something is accepting connections on the socket path
+   */
+  private isSocketAlive(): Promise<boolean> {
+    return new Promise(resolve => {
+      const probe = net.connect(this.options.socketPath);
+      probe.once('connect', () => {
+        probe.destroy();
+        resolve(true);
+      });
+      probe.once('error', () => resolve(false));
+    });
+  }
+}
@@ -0,0 +1,237 @@
+// Daemon Client - Executes analysis tasks through a shared analysis daemon
+import * as child_process from 'child_process';
+import * as fs from 'fs';
+import * as net from 'net';
+import { ProcessResult } from '../utils/processUtils';
+import { logger } from '../utils/logger';
+import { AnalysisExecutor, AnalysisTask } from '../core/runner/AnalysisExecutor';
+import { DaemonRequest, DaemonResponse, DaemonStatus, PROTOCOL_VERSION, onMessages, sendMessage } from './protocol';
+
+type ResponseHandler = (response: DaemonResponse) => void;
+
+// Arguments for starting a daemon when none is running yet
+export interface DaemonSpawnOptions {
+  scriptPath: string;
+  jobs: number;
+  cacheDirectory?: string;
+  idleTimeoutMs: number;
+  logFile?: string;
+}
+
+export class DaemonClient implements AnalysisExecutor {
+  private nextId = 1;
+  private handlers = new Map<number, ResponseHandler>();
+  private closed = false;
+
+  private constructor(private socket: net.Socket) {
+    onMessages<DaemonResponse>(socket, response => {
+      const handler = this.handlers.get(response.id);
+      if (handler) {
+        handler(response);
+      }
+    });
+    socket.on('close', () => {
+      this.closed = true;
+      // Fail everything still waiting so callers can fall back
+      for (const [id, handler] of this.handlers) {
+        handler({ id, type: 'error', message: 'Connection to analysis daemon closed' });
+      }
+      this.handlers.clear();
+    });
+    socket.on('error', error => logger.warn(`Analysis daemon connection error: ${error.message}`));
+  }
+
+  /**
+   * Connect to a running daemon
+   */
+  static async connect(socketPath: string): Promise<DaemonClient> {
+    const socket = await new Promise<net.Socket>((resolve, reject) => {
+      const connection = net.connect(socketPath);
+      connection.once('connect', () => {
+        connection.off('error', reject);
+        resolve(connection);
+      });
+      connection.once('error', reject);
+    });
+
+    const client = new DaemonClient(socket);
+    const hello = await client.request({ id: 0, type: 'hello', version: PROTOCOL_VERSION });
+    if (hello.type !== 'hello') {
+      socket.destroy();
+      throw new Error(hello.type === 'error' ? hello.message : 'Unexpected handshake response');
+    }
+    logger.info(`Connected to analysis daemon ${hello.pid} at ${socketPath}`);
+    return client;
+  }
+
+  /**
+   * Connect to the daemon, starting a detached one first if nothing is listening
+   */
+  static async connectOrSpawn(socketPath: string, spawnOptions: DaemonSpawnOptions): Promise<DaemonClient> {
+    try {
+      return await this.connect(socketPath);
+    } catch (error) {
+      logger.info(`No analysis daemon at ${socketPath}, starting one`);
+    }
+
+    if (!fs.existsSync(spawnOptions.scriptPath)) {
+      throw new Error(`Daemon script not found: ${spawnOptions.scriptPath}`);
+    }
+
+    const args = [
+      spawnOptions.scriptPath,
+      '--socket', socketPath,
+      '--jobs', String(spawnOptions.jobs),
+      '--idle-timeout', String(spawnOptions.idleTimeoutMs)
+    ];
+    if (spawnOptions.cacheDirectory) {
+      args.push('--cache-dir', spawnOptions.cacheDirectory);
+    }
+    if (spawnOptions.logFile) {
+      args.push('--log-file', spawnOptions.logFile);
+    }
+
+    // Detached so the daemon outlives extension host restarts.
+    // process.execPath is the VS Code binary, which behaves as plain Node with ELECTRON_RUN_AS_NODE.
+    const child = child_process.spawn(process.execPath, args, {
+      detached: true,
+      stdio: 'ignore',
+      env: { ...process.env, ELECTRON_RUN_AS_NODE: '1' }
+    });
+    child.unref();
+
+    // Wait for the daemon to start listening
+    const deadline = Date.now() + 10000;
+    while (Date.now() < deadline) {
+      await new Promise(resolve => setTimeout(resolve, 200));
+      try {
+        return await this.connect(socketPath);
+      } catch (error) {
+        // Not ready yet
+      }
+    }
+    throw new Error(`Analysis daemon did not start listening on ${socketPath}`);
+  }
+
+  async execute(tasks: AnalysisTask[], onResult?: (index: number, result: ProcessResult) => void): Promise<ProcessResult[]> {
+    if (tasks.length === 0) {
+      return [];
+    }
+
+    const results: ProcessResult[] = new Array(tasks.length);
+    let cachedCount = 0;
+    let settled = 0;
+    const run = this.nextId++;
+    const signals = new Map<AbortSignal, number[]>();
+    tasks.forEach((task, index) => {
+      if (task.signal) {
+        signals.set(task.signal, [...(signals.get(task.signal) || []), index]);
+      }
+    });
+    const cleanup: Array<() => void> = [];
+
+    await new Promise<void>((resolve, reject) => {
+      const settle = (index: number, result: ProcessResult) => {
+        if (results[index]) {
+          return;
+        }
+        results[index] = result;
+        settled++;
+        if (onResult) {
+          onResult(index, result);
+        }
+        if (settled === tasks.length) {
+          resolve();
+        }
+      };
+
+      // Signals cannot cross the socket: the daemon is told which tasks to stop, and they resolve as cancelled at once
+      this.send({ id: run, type: 'run', tasks: tasks.map(({ signal, ...task }) => task) }, response => {
+        switch (response.type) {
+          case 'result':
+            if (response.cached && !results[response.index]) {
+              cachedCount++;
+            }
+            settle(response.index, response.result);
+            return false;
+          case 'done':
+            resolve();
+            return true;
+          case 'error':
+            reject(new Error(response.message));
+            return true;
+          default:
+            return false;
+        }
+      });
+
+      for (const [signal, indexes] of signals) {
+        const onAbort = () => {
+          const open = indexes.filter(index => !results[index]);
+          if (open.length > 0 && !this.closed) {
+            sendMessage<DaemonRequest>(this.socket, { id: this.nextId++, type: 'cancel', run, indexes: open });
+          }
+          open.forEach(index => settle(index, { stdout: '', stderr: '', exitCode: 1, duration: 0, cancelled: true }));
+        };
+        if (signal.aborted) {
+          onAbort();
+        } else {
+          signal.addEventListener('abort', onAbort, { once: true });
+          cleanup.push(() => signal.removeEventListener('abort', onAbort));
+        }
+      }
+    }).finally(() => cleanup.forEach(remove => remove()));
+
+    logger.debug(`Analysis daemon: ${cachedCount}/${tasks.length} tasks served from shared cache`);
+    return results;
+  }
+
+  /**
+   * Get daemon status
+   */
+  async getStatus(): Promise<DaemonStatus | null> {
+    const response = await this.request({ id: 0, type: 'status' });
+    return response.type === 'status' ? response.status : null;
+  }
+
+  /**
+   * Whether the connection is still usable
+   */
+  isConnected(): boolean {
+    return !this.closed;
+  }
+
+  dispose(): void {
+    this.socket.end();
+  }
+
+  /**
+   * Send a request expecting a single response
+   */
+  private request(message: DaemonRequest): Promise<DaemonResponse> {
+    return new Promise(resolve => {
+      this.send(message, response => {
+        resolve(response);
+        return true;
+      });
+    });
+  }
+
+  /**
+   * Send a request; the handler returns true once the final response arrived
+   */
+  private send(message: DaemonRequest, handler: (response: DaemonResponse) => boolean): void {
+    const id = message.id || this.nextId++;
+    this.handlers.set(id, response => {
+      if (handler(response)) {
+        this.handlers.delete(id);
+      }
+    });
+    if (this.closed) {
+      handler({ id, type: 'error', message: 'Connection to analysis daemon closed' });
+      this.handlers.delete(id);
+      return;
+    }
+    sendMessage(this.socket, { ...message, id });
+  }
+}
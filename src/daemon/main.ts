@@ -0,0 +1,53 @@
+// Analysis Daemon - Process entry point (bundled as dist/daemon.js)
+import * as os from 'os';
+import { logger } from '../utils/logger';
+import { AnalysisDaemon } from './AnalysisDaemon';
+import { getDefaultSocketPath } from './protocol';
+
+/**
+ * Parse "--name value" pairs
+ */
+function parseArgs(argv: string[]): Record<string, string> {
+  const parsed: Record<string, string> = {};
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    if (arg.startsWith('--')) {
+      const next = argv[i + 1];
+      if (next !== undefined && !next.startsWith('--')) {
+        parsed[arg.substring(2)] = next;
+        i++;
+      } else {
+        parsed[arg.substring(2)] = 'true';
+      }
+    }
+  }
+  return parsed;
+}
+
+async function main(): Promise<void> {
+  const args = parseArgs(process.argv.slice(2));
+
+  if (args['log-file']) {
+    logger.setLogFile(args['log-file']);
+  }
+  if (args['log-level']) {
+    logger.setLogLevel(args['log-level'] as 'error' | 'warn' | 'info' | 'debug');
+  }
+
+  const daemon = new AnalysisDaemon({
+    socketPath: args['socket'] || getDefaultSocketPath(),
+    jobs: parseInt(args['jobs'], 10) || os.cpus().length,
+    cacheDirectory: args['cache-dir'],
+    idleTimeoutMs: args['idle-timeout'] !== undefined ? parseInt(args['idle-timeout'], 10) || 0 : 30 * 60 * 1000
+  });
+
+  process.on('SIGTERM', () => daemon.stop());
+  process.on('SIGINT', () => daemon.stop());
+
+  await daemon.start();
+}
+
+main().catch(error => {
+  logger.error('Analysis daemon failed to start', error as Error);
+  process.exit(1);
+});
@@ -0,0 +1,91 @@
+// Daemon Protocol - Newline-delimited JSON messages exchanged over a local socket
+import * as net from 'net';
+import * as os from 'os';
+import * as path from 'path';
+import { ProcessResult } from '../utils/processUtils';
+import { AnalysisTask } from '../core/runner/AnalysisExecutor';
+
+export const PROTOCOL_VERSION = 3;
+
+// Client -> daemon
+export type DaemonRequest =
+  | { id: number; type: 'hello'; version: number }
+  | { id: number; type: 'run'; tasks: AnalysisTask[] }
+  // Stop tasks of a run (by index) whose caller aborted; no response
+  | { id: number; type: 'cancel'; run: number; indexes: number[] }
+  | { id: number; type: 'status' }
+  | { id: number; type: 'shutdown' };
+
+export interface DaemonStatus {
+  pid: number;
+  clients: number;
+  running: number;
+  queued: number;
+  concurrency: number;
+  cacheHits: number;
+  cacheMisses: number;
+}
+
+// Daemon -> client. A 'run' request streams one 'result' per task followed by 'done'.
+export type DaemonResponse =
+  | { id: number; type: 'hello'; version: number; pid: number }
+  | { id: number; type: 'result'; index: number; result: ProcessResult; cached: boolean }
+  | { id: number; type: 'done' }
+  | { id: number; type: 'status'; status: DaemonStatus }
+  | { id: number; type: 'error'; message: string };
+
+/**
+ * Default socket path: a Unix domain socket per user, or a named pipe on Windows
+ */
+export function getDefaultSocketPath(): string {
+  const user = (() => {
+    try {
+      return os.userInfo().username;
+    } catch (error) {
+      return 'default';
+    }
+  })().replace(/[^a-zA-Z0-9_-]/g, '_');
+
+  if (process.platform === 'win32') {
+    return `\\\\.\\pipe\\clang-tidy-visualizer-${user}`;
+  }
+  return path.join(os.tmpdir(), `clang-tidy-visualizer-${user}.sock`);
+}
+
+/**
+ * Write one message to a socket (also used by the remote worker protocol)
+ */
+export function sendMessage<T extends { id: number; type: string } = DaemonRequest | DaemonResponse>(socket: net.Socket, message: T): void {
+  if (!socket.destroyed) {
+    socket.write(JSON.stringify(message) + '\n');
+  }
+}
+
+/**
+ * Split incoming socket data into JSON messages
+ */
+export function onMessages<T>(socket: net.Socket, handler: (message: T) => void, onInvalid?: (line: string) => void): void {
+  let buffer = '';
+  socket.setEncoding('utf8');
+  socket.on('data', (chunk: string) => {
+    buffer += chunk;
+    let newline: number;
+    while ((newline = buffer.indexOf('\n')) !== -1) {
+      const line = buffer.substring(0, newline);
+      buffer = buffer.substring(newline + 1);
+      if (!line.trim()) {
+        continue;
+      }
+      let message: T;
+      try {
+        message = JSON.parse(line) as T;
+      } catch (error) {
+        if (onInvalid) {
+          onInvalid(line);
+        }
+        continue;
+      }
+      handler(message);
+    }
+  });
+}
@@ -1,7 +1,6 @@
 // Clang-Tidy Visualizer - Extension Main Entry
 import * as vscode from 'vscode';
 import * as path from 'path';
-import * as fs from 'fs';
 import * as child_process from 'child_process';
 import { ExtensionContext } from 'vscode';
 import { ConfigManager } from './core/config/ConfigManager';
@@ -13,11 +12,32 @@ import { ReportWebview } from './ui/webview/ReportWebview';
 import { logger } from './utils/logger';
 import { FileUtils } from './utils/fileUtils';
 import { i18n } from './utils/i18nService';
-import { RunOptions, ReportData, ClangTidyDiagnostic } from './types';
+import { ClangTidyDiagnostic, RunOptions } from './types';
+import { WorkspaceEngine, RootAnalysis } from './core/engine/WorkspaceEngine';
+import { FileDiscovery } from './core/engine/FileDiscovery';
+import { DaemonClient } from './daemon/DaemonClient';
+import { getDefaultSocketPath } from './daemon/protocol';
+import { RunJournal } from './core/journal/RunJournal';
+import { AnalysisEngine, AnalysisOutcome } from './core/engine/AnalysisEngine';
+import { DiagnosticStore } from './core/store/DiagnosticStore';
+import { ClangdSession } from './core/live/ClangdSession';
+import { CheckTiers } from './core/engine/CheckTiers';
 
 // Global storage for WSL distribution name (auto-detected, no hardcoding)
 let wslDistroName = '';
 
+// Journal of the running analysis, kept in workspace storage so interrupted runs can be resumed
+let runJournalPath: string | null = null;
+
+// Runners of additional roots in multi-root workspaces, each with its own compile database, config and cache
+const rootRunners = new Map<string, ClangTidyRunner>();
+let daemonClient: DaemonClient | null = null;
+
+// Live analysis of editor files: latest results per file, the clangd session and the Problems panel entries
+const liveStore = new DiagnosticStore();
+let clangdSession: ClangdSession | null = null;
+let liveDiagnostics: vscode.DiagnosticCollection | null = null;
+
 // Export function to get WSL distro name
 export function getWslDistroName(): string {
     return wslDistroName;
@@ -74,6 +94,15 @@ export function activate(context: ExtensionContext) {
     const textParser = new TextParser();
     const webview = new ReportWebview(context);
 
+    // Share the worker pool and result cache with other windows when enabled
+    if (configManager.getDaemonConfig().enabled) {
+        connectAnalysisDaemon(context, configManager, runner);
+    }
+
+    const storageDir = context.storageUri?.fsPath || context.globalStorageUri.fsPath;
+    runJournalPath = path.join(storageDir, 'run-journal.jsonl');
+    offerResume(configManager, runner, jsonParser, textParser, webview);
+
     // Register commands
     const runAnalysisCommand = vscode.commands.registerCommand('clangTidyVisualizer.run', async () => {
         // New command: show analysis scope selection first
@@ -94,9 +123,250 @@ export function activate(context: ExtensionContext) {
     context.subscriptions.push(runDirectCommand);
     context.subscriptions.push(showLastReportCommand);
 
+    // On-save analysis and the clangd live engine
+    liveDiagnostics = vscode.languages.createDiagnosticCollection('clang-tidy');
+    context.subscriptions.push(liveDiagnostics);
+    context.subscriptions.push(vscode.workspace.onDidSaveTextDocument(document => analyzeOnSave(document, configManager, runner, textParser)));
+    context.subscriptions.push(vscode.workspace.onDidCloseTextDocument(document => clangdSession?.close(document.uri.fsPath)));
+    context.subscriptions.push({ dispose: () => { clangdSession?.dispose(); } });
+
     logger.info('Extension commands registered');
 }
 
+/**
+ * Connect the runner to the shared analysis daemon, starting it if needed.
+ * Analysis keeps running in-process if the daemon is unavailable.
+ */
+async function connectAnalysisDaemon(
+    context: ExtensionContext,
+    configManager: ConfigManager,
+    runner: ClangTidyRunner
+): Promise<void> {
+    const daemonConfig = configManager.getDaemonConfig();
+    const cacheConfig = configManager.getCacheConfig();
+    const socketPath = daemonConfig.socketPath ? configManager.resolvePath(daemonConfig.socketPath) : getDefaultSocketPath();
+
+    try {
+        const client = await DaemonClient.connectOrSpawn(socketPath, {
+            scriptPath: context.asAbsolutePath(path.join('dist', 'daemon.js')),
+            jobs: configManager.getParallelJobs(),
+            cacheDirectory: cacheConfig.enabled && cacheConfig.directory ? configManager.resolvePath(cacheConfig.directory) : undefined,
+            idleTimeoutMs: daemonConfig.idleTimeoutMinutes * 60 * 1000,
+            logFile: path.join(context.logUri.fsPath, 'daemon.log')
+        });
+        runner.setExecutor(client);
+        rootRunners.forEach(rootRunner => rootRunner.setExecutor(client));
+        daemonClient = client;
+        context.subscriptions.push({ dispose: () => client.dispose() });
+    } catch (error) {
+        logger.warn(`Analysis daemon unavailable, running analyses in this window: ${error instanceof Error ? error.message : String(error)}`);
+    }
+}
+
+/**
+ * Get the clangd live session, starting clangd on first use or after it exited
+ */
+async function getClangdSession(configManager: ConfigManager): Promise<ClangdSession> {
+    if (clangdSession && clangdSession.isAlive()) {
+        return clangdSession;
+    }
+    const clangdPath = configManager.getLiveConfig().clangdPath;
+    try {
+        clangdSession = await ClangdSession.start({
+            clangdPath,
+            compileCommandsDir: path.dirname(configManager.getCompileCommandsPath()),
+            workspaceRoot: configManager.getWorkspaceRoot() || process.cwd()
+        });
+    } catch (error) {
+        const message = error instanceof Error ? error.message : String(error);
+        throw new Error(i18n.t('error.clangdUnavailable', `clangd could not be started (${clangdPath}): ${message}`, clangdPath, message));
+    }
+    return clangdSession;
+}
+
+/**
+ * Analyze editor files through clangd, using the unsaved editor contents.
+ * Files clangd already built are only re-parsed if they changed.
+ */
+async function analyzeWithClangd(
+    files: string[],
+    configManager: ConfigManager,
+    onProgress: (completed: number, total: number) => void
+): Promise<AnalysisOutcome> {
+    const startTime = Date.now();
+    const session = await getClangdSession(configManager);
+    const errors: string[] = [];
+    let completed = 0;
+
+    await Promise.all(files.map(async file => {
+        const document = vscode.workspace.textDocuments.find(doc => doc.uri.fsPath === file);
+        try {
+            liveStore.update(file, await session.analyze(file, document?.getText()));
+        } catch (error) {
+            errors.push(error instanceof Error ? error.message : String(error));
+        }
+        onProgress(++completed, files.length);
+    }));
+    publishLiveDiagnostics(files, configManager);
+
+    const diagnostics = liveStore.query(files);
+    return {
+        diagnostics,
+        reportData: AnalysisEngine.buildReportData(diagnostics, files.length),
+        results: [],
+        rawOutput: '',
+        errorOutput: errors.join('\n'),
+        exitCode: errors.length === files.length ? 1 : 0,
+        duration: Date.now() - startTime
+    };
+}
+
+/**
+ * Analyze a saved C/C++ file with the configured live engine and show the findings in the Problems panel
+ */
+async function analyzeOnSave(
+    document: vscode.TextDocument,
+    configManager: ConfigManager,
+    runner: ClangTidyRunner,
+    textParser: TextParser
+): Promise<void> {
+    const liveConfig = configManager.getLiveConfig();
+    if (!liveConfig.analyzeOnSave || (document.languageId !== 'cpp' && document.languageId !== 'c')) {
+        return;
+    }
+    const file = document.uri.fsPath;
+    try {
+        let diagnostics: ClangTidyDiagnostic[];
+        if (liveConfig.engine === 'clangd') {
+            diagnostics = await (await getClangdSession(configManager)).analyze(file, document.getText());
+        } else {
+            const root = FileUtils.getWorkspaceRootFor(file);
+            const fileRunner = root ? getRunnerForRoot(root, runner) : runner;
+            const outcome = await new AnalysisEngine(fileRunner, textParser).analyze([file], {
+                checks: configManager.getChecks(),
+                headerFilter: configManager.getHeaderFilter(),
+                extraArgs: configManager.getExtraArgs(),
+                priority: 'interactive'
+            });
+            diagnostics = outcome.diagnostics;
+        }
+        liveStore.update(file, diagnostics);
+        publishLiveDiagnostics([file], configManager);
+    } catch (error) {
+        logger.warn(`On-save analysis of ${file} failed: ${error instanceof Error ? error.message : String(error)}`);
+    }
+}
+
+/**
+ * Refresh the Problems panel entries of the given files and of every file their results touch
+ */
+function publishLiveDiagnostics(files: string[], configManager: ConfigManager): void {
+    if (!liveDiagnostics || !configManager.getUIConfig().problemsPanel) {
+        return;
+    }
+    const affected = new Set(files);
+    liveStore.query(files).forEach(diag => affected.add(diag.filePath));
+    for (const file of affected) {
+        const entries = liveStore.query([file])
+            .filter(diag => diag.filePath === file && diag.severity !== 'note')
+            .map(diag => {
+                const position = new vscode.Position(Math.max(0, diag.line - 1), Math.max(0, diag.column - 1));
+                const entry = new vscode.Diagnostic(
+                    new vscode.Range(position, position),
+                    diag.message,
+                    diag.severity === 'warning' ? vscode.DiagnosticSeverity.Warning : vscode.DiagnosticSeverity.Error
+                );
+                entry.source = 'clang-tidy';
+                entry.code = diag.checkName;
+                return entry;
+            });
+        liveDiagnostics.set(vscode.Uri.file(file), entries);
+    }
+}
+
+/**
+ * Get the runner for a workspace root; the first root uses the primary runner
+ */
+function getRunnerForRoot(root: string, primaryRunner: ClangTidyRunner): ClangTidyRunner {
+    if (root === FileUtils.getWorkspaceRoot()) {
+        return primaryRunner;
+    }
+    let rootRunner = rootRunners.get(root);
+    if (!rootRunner) {
+        rootRunner = new ClangTidyRunner(ConfigManager.getForRoot(root));
+        if (daemonClient) {
+            rootRunner.setExecutor(daemonClient);
+        }
+        rootRunners.set(root, rootRunner);
+    }
+    return rootRunner;
+}
+
+/**
+ * Split files by workspace root and drop roots without a compile database
+ */
+async function groupFilesByRoot(files: string[], primaryRunner: ClangTidyRunner): Promise<RootAnalysis[]> {
+    const primaryRoot = FileUtils.getWorkspaceRoot() || '';
+    const byRoot = new Map<string, string[]>();
+    for (const file of files) {
+        const root = FileUtils.getWorkspaceRootFor(file) || primaryRoot;
+        const rootFiles = byRoot.get(root);
+        if (rootFiles) {
+            rootFiles.push(file);
+        } else {
+            byRoot.set(root, [file]);
+        }
+    }
+
+    const groups: RootAnalysis[] = [];
+    for (const [root, rootFiles] of byRoot) {
+        const compileCommandsPath = ConfigManager.getForRoot(root).getCompileCommandsPath();
+        if (!FileUtils.exists(compileCommandsPath)) {
+            logger.warn(`Skipping ${rootFiles.length} files in ${root}: compile database not found at ${compileCommandsPath}`);
+            continue;
+        }
+        const rootRunner = getRunnerForRoot(root, primaryRunner);
+        if (rootRunner !== primaryRunner && !(await rootRunner.checkClangTidyAvailable())) {
+            logger.warn(`Skipping ${root}: clang-tidy not available with this root's settings`);
+            continue;
+        }
+        groups.push({ root, runner: rootRunner, files: rootFiles });
+    }
+    return groups;
+}
+
+/**
+ * Offer to resume a run that was interrupted by a reload or crash
+ */
+async function offerResume(
+    configManager: ConfigManager,
+    runner: ClangTidyRunner,
+    jsonParser: JsonParser,
+    textParser: TextParser,
+    webview: ReportWebview
+): Promise<void> {
+    const journal = runJournalPath ? RunJournal.open(runJournalPath) : null;
+    if (!journal) {
+        return;
+    }
+
+    const header = journal.getHeader();
+    const done = header.files.length - journal.getRemaining().length;
+    const resume = i18n.t('action.resume', 'Resume');
+    const discard = i18n.t('action.discard', 'Discard');
+    const choice = await vscode.window.showInformationMessage(
+        i18n.t('info.resumeRun', 'A Clang-Tidy run ({0}) was interrupted after {1} of {2} files. Resume it?', header.scope, done, header.files.length),
+        resume,
+        discard
+    );
+
+    if (choice === resume) {
+        await runClangTidyAnalysis(configManager, runner, jsonParser, textParser, webview, header.scope, journal);
+    } else if (choice === discard) {
+        journal.discard();
+    }
+}
+
 /**
  * Show analysis scope selection QuickPick
  */
@@ -143,8 +413,10 @@ async function runClangTidyAnalysis(
     jsonParser: JsonParser,
     textParser: TextParser,
     webview: ReportWebview,
-    scope: string | null
+    scope: string | null,
+    resumeJournal?: RunJournal
 ): Promise<void> {
+    let journal: RunJournal | undefined = resumeJournal;
     try {
         // Show progress bar
         await vscode.window.withProgress(
@@ -169,11 +441,12 @@ async function runClangTidyAnalysis(
                     return;
                 }
 
-                // Check if compile_commands.json exists
+                // Check if compile_commands.json exists (multi-root workspaces check each root below)
+                const multiRoot = FileUtils.getWorkspaceRoots().length > 1;
                 const compileCommandsPath = configManager.getCompileCommandsPath();
                 logger.debug(`Checking if compile_commands.json exists at: ${compileCommandsPath}`);
                 
-                if (!FileUtils.exists(compileCommandsPath)) {
+                if (!multiRoot && !FileUtils.exists(compileCommandsPath)) {
                     logger.error(`Compile database not found at: ${compileCommandsPath}`);
                     vscode.window.showErrorMessage(i18n.t('error.compileDatabaseNotFound', `Compile database not found at: ${compileCommandsPath}`, compileCommandsPath));
                     vscode.window.showInformationMessage(i18n.t('info.generateCompileCommands'));
@@ -186,8 +459,11 @@ async function runClangTidyAnalysis(
                 let files: string[] = [];
                 const activeEditor = vscode.window.activeTextEditor;
                 
-                // If no scope specified (backward compatibility), use old logic
-                if (!scope) {
+                if (journal) {
+                    // Resumed run: same files as the interrupted one
+                    files = journal.getHeader().files;
+                } else if (!scope) {
+                    // If no scope specified (backward compatibility), use old logic
                     if (activeEditor && (activeEditor.document.languageId === 'cpp' || activeEditor.document.languageId === 'c')) {
                         files = await getCurrentFileFiles(activeEditor);
                     } else {
@@ -229,71 +505,84 @@ async function runClangTidyAnalysis(
                 progress.report({ message: `Found ${files.length} files to analyze...` });
 
                 // Prepare run options
-                const options: RunOptions = {
+                const options: RunOptions = journal ? journal.getHeader().options : {
                     checks: configManager.getChecks(),
                     headerFilter: configManager.getHeaderFilter(),
                     parallel: true,
                     outputFormat: 'text',
-                    extraArgs: configManager.getExtraArgs()
+                    extraArgs: configManager.getExtraArgs(),
+                    // Editor-driven scopes jump ahead of bulk runs in the shared worker pool
+                    priority: scope === 'currentFile' || scope === 'openFiles' ? 'interactive' : 'normal'
                 };
 
+                // One group per workspace root, all feeding the shared worker pool
+                const rootGroups = multiRoot ? await groupFilesByRoot(files, runner) : [{ root: workspaceFolder, runner, files }];
+                if (rootGroups.length === 0) {
+                    vscode.window.showErrorMessage(i18n.t('error.compileDatabaseNotFound', `Compile database not found at: ${compileCommandsPath}`, compileCommandsPath));
+                    return;
+                }
+
+                // Open files can be served by the warm clangd session instead of fresh clang-tidy processes
+                const useClangd = !journal && scope === 'openFiles' && configManager.getLiveConfig().engine === 'clangd';
+
+                // Cheap checks first, expensive ones in the background (resumed runs keep their original form)
+                const tiered = !journal && !useClangd && configManager.getTierConfig().enabled;
+
+                // Journal multi-file runs so they survive reloads and crashes
+                if (!journal && !useClangd && !tiered && runJournalPath && files.length > 1) {
+                    journal = RunJournal.create(runJournalPath, scope || 'default', files, options);
+                }
+
                 // Run analysis
                 progress.report({ message: 'Running Clang-Tidy analysis...' });
                 
-                // Create a single result object compatible with textParser
-                let result;
-                
-                // Use parallel processing if multiple files
-                if (files.length > 1) {
-                    const parallelResults = await runner.runParallel(files, options, (completed, total) => {
-                        const percentage = Math.round((completed / total) * 100);
-                        progress.report({
-                            message: `Analyzing files... ${percentage}% (${completed}/${total} batches)`,
-                            increment: Math.round(100 / total)
-                        });
+                const reportProgress = (completed: number, total: number) => {
+                    const percentage = Math.round((completed / total) * 100);
+                    progress.report({
+                        message: `Analyzing files... ${percentage}% (${completed}/${total} files)`,
+                        increment: Math.round(100 / total)
                     });
-                    
-                    // Combine results from all batches
-                    const rawOutput = parallelResults.map(r => r.rawOutput).join('\n');
-                    const errorOutput = parallelResults.map(r => r.errorOutput).join('\n');
-                    const exitCode = parallelResults.some(r => r.exitCode !== 0) ? 1 : 0;
-                    
-                    result = {
-                        rawOutput,
-                        errorOutput,
-                        exitCode
-                    };
-                } else {
-                    // Use single file processing for better performance with small number of files
-                    result = await runner.runAnalysis(files, options);
+                };
+                const reportOptions = {
+                    checks: options.checks,
+                    includeCharts: configManager.getReportConfig().includeCharts,
+                    style: configManager.getReportConfig().style
+                };
+                const result = useClangd
+                    ? await analyzeWithClangd(files, configManager, reportProgress)
+                    : tiered
+                        ? await CheckTiers.run(
+                            (tierOptions, tierProgress) => new WorkspaceEngine(textParser).analyze(rootGroups, tierOptions, tierProgress),
+                            options, reportProgress, async fast => {
+                                // Show the fast findings while the slow checks keep running
+                                progress.report({ message: i18n.t('status.slowTierRunning', `Fast checks done (${fast.reportData.totalWarnings} issues), running slow checks...`, fast.reportData.totalWarnings) });
+                                if (fast.diagnostics.length > 0) {
+                                    await webview.showReport(fast.reportData, reportOptions);
+                                }
+                            })
+                        : await new WorkspaceEngine(textParser).analyze(rootGroups, options, reportProgress, journal);
+                if (journal) {
+                    journal.finish();
+                    journal = undefined;
                 }
 
-                if (result.exitCode !== 0 && !result.rawOutput) {
+                if (result.exitCode !== 0 && !result.rawOutput.trim()) {
                     vscode.window.showErrorMessage(i18n.t('error.analysisFailed', `Clang-Tidy analysis failed: ${result.errorOutput}`, result.errorOutput));
                     return;
                 }
 
-                // Parse results - use text format only
-                progress.report({ message: 'Parsing results...' });
-                logger.info('Using text format for parsing results');
-                const diagnostics = textParser.parseClangTidyText(result.rawOutput);
+                const diagnostics = result.diagnostics;
 
                 if (diagnostics.length === 0) {
                     vscode.window.showInformationMessage(i18n.t('info.noIssuesFound'));
                     return;
                 }
 
-                // Prepare report data
-                progress.report({ message: 'Generating report...' });
-                const reportData = prepareReportData(diagnostics, files.length);
+                const reportData = result.reportData;
 
                 // Show report in Webview
                 progress.report({ message: 'Opening report...' });
-                await webview.showReport(reportData, {
-                    checks: options.checks,
-                    includeCharts: configManager.getReportConfig().includeCharts,
-                    style: configManager.getReportConfig().style
-                });
+                await webview.showReport(reportData, reportOptions);
 
                 // Show summary notification
                 vscode.window.showInformationMessage(
@@ -304,6 +593,8 @@ async function runClangTidyAnalysis(
             }
         );
     } catch (error) {
+        // Keep the journal of the failed run so it can be resumed
+        journal?.close();
         logger.error('Error during Clang-Tidy analysis', error as Error);
         vscode.window.showErrorMessage(i18n.t('error.generic', `Error: ${error instanceof Error ? error.message : String(error)}`, error instanceof Error ? error.message : String(error)));
     }
@@ -396,93 +687,65 @@ async function getSelectedFolderFiles(): Promise<string[]> {
     logger.debug(`Searching for files in selected folder: ${folderPath}`);
     
     // Always use fs directly for searching files - this is more reliable
-    const fileExtensions = ['.cpp', '.c', '.hpp', '.h', '.cxx', '.cc', '.hh', '.hxx'];
-    const files: string[] = [];
+    const files = FileDiscovery.fromDirectory(folderPath);
+    logger.debug(`Found ${files.length} C/C++ files in selected folder`);
+    return files;
+}
+
+/**
+ * Get files for "Compile Database" scope
+ */
+async function getCompileDatabaseFiles(configManager: ConfigManager): Promise<string[]> {
+    const roots = FileUtils.getWorkspaceRoots();
+    const managers = roots.length > 1 ? roots.map(root => ConfigManager.getForRoot(root)) : [configManager];
+    const files = new Set<string>();
     
-    // Use fs to recursively search for files
-    const searchRecursively = (dir: string) => {
+    for (const manager of managers) {
+        const compileCommandsPath = manager.getCompileCommandsPath();
+        if (!FileUtils.exists(compileCommandsPath)) {
+            logger.error(`Compile database not found at: ${compileCommandsPath}`);
+            continue;
+        }
+        
         try {
-            const entries = fs.readdirSync(dir, { withFileTypes: true });
-            
-            for (const entry of entries) {
-                const fullPath = path.join(dir, entry.name);
-                
-                if (entry.isDirectory()) {
-                    // Skip ignored directories
-                    if (entry.name === 'node_modules' || entry.name === 'build' || entry.name === 'out' || entry.name === 'third_party') {
-                        logger.debug(`Skipping ignored directory: ${fullPath}`);
-                        continue;
-                    }
-                    searchRecursively(fullPath);
-                } else if (entry.isFile()) {
-                    const ext = path.extname(entry.name).toLowerCase();
-                    if (fileExtensions.includes(ext)) {
-                        logger.debug(`Found C/C++ file: ${fullPath}`);
-                        files.push(fullPath);
-                    }
-                }
-            }
+            FileDiscovery.fromCompileDatabase(compileCommandsPath).forEach(file => files.add(file));
         } catch (error) {
-            logger.error(`Error reading directory ${dir}: ${error}`);
+            logger.error('Failed to parse compile_commands.json:', error as Error);
         }
-    };
-    
-    try {
-        searchRecursively(folderPath);
-        logger.debug(`Found ${files.length} C/C++ files in selected folder`);
-        return files;
-    } catch (error) {
-        logger.error(`Error searching files in folder ${folderPath}: ${error}`);
-        vscode.window.showErrorMessage(`Error searching files in folder: ${error}`);
-        return [];
     }
+    
+    return Array.from(files);
 }
 
 /**
- * Get files for "Compile Database" scope
+ * Keep the files listed in a root's compile database (all files if it has none or none match)
  */
-async function getCompileDatabaseFiles(configManager: ConfigManager): Promise<string[]> {
+function filterByCompileDatabase(files: string[], configManager: ConfigManager): string[] {
     const compileCommandsPath = configManager.getCompileCommandsPath();
     if (!FileUtils.exists(compileCommandsPath)) {
-        logger.error(`Compile database not found at: ${compileCommandsPath}`);
-        return [];
+        return files;
     }
     
     try {
-        const compileCommandsContent = FileUtils.readFile(compileCommandsPath);
-        const compileCommands = JSON.parse(compileCommandsContent);
-        
-        const files = new Set<string>();
-        // Enhanced ignore pattern - similar to other scopes
-        const ignorePatterns = [
-            /node_modules/i,
-            /build/i,
-            /out/i,
-            /third_party/i
-        ];
+        const compileCommands = JSON.parse(FileUtils.readFile(compileCommandsPath));
+        const buildFiles = new Set<string>();
         
         for (const entry of compileCommands) {
             const file = entry['file'];
             const directory = entry['directory'];
-            
-            let absFile = path.isAbsolute(file) ? file : path.join(directory, file);
-            absFile = path.normalize(absFile);
-            
-            // Check if file path matches any ignore pattern
-            const shouldIgnore = ignorePatterns.some(pattern => pattern.test(absFile));
-            if (shouldIgnore) {
-                logger.debug(`Ignoring file from compile database: ${absFile}`);
-                continue;
-            }
-            
-            files.add(absFile);
+            const absFile = path.isAbsolute(file) ? file : path.join(directory, file);
+            buildFiles.add(absFile);
         }
         
-        logger.debug(`Found ${files.size} files in compile_commands.json after filtering`);
-        return Array.from(files);
+        const filteredFiles = files.filter(file => buildFiles.has(file));
+        logger.debug(`Filtered files using compile_commands.json: ${filteredFiles.length} out of ${files.length} files`);
+        
+        // Use filtered files if we found any, otherwise use all files
+        return filteredFiles.length > 0 ? filteredFiles : files;
     } catch (error) {
-        logger.error('Failed to parse compile_commands.json:', error as Error);
-        return [];
+        logger.error('Failed to filter files using compile_commands.json:', error as Error);
+        // Continue with all found files if compile_commands.json parsing fails
+        return files;
     }
 }
 
@@ -506,67 +769,20 @@ async function getWholeWorkspaceFiles(configManager: ConfigManager): Promise<str
     let files = allFiles.flat().map(uri => uri.fsPath);
     
     // Additional filtering - ensure we only analyze source files from compile_commands.json
-    // This helps avoid analyzing files that aren't part of the build system
-    const compileCommandsPath = configManager.getCompileCommandsPath();
-    if (FileUtils.exists(compileCommandsPath)) {
-        try {
-            const compileCommands = JSON.parse(FileUtils.readFile(compileCommandsPath));
-            const buildFiles = new Set<string>();
-            
-            for (const entry of compileCommands) {
-                const file = entry['file'];
-                const directory = entry['directory'];
-                const absFile = path.isAbsolute(file) ? file : path.join(directory, file);
-                buildFiles.add(absFile);
-            }
-            
-            const filteredFiles = files.filter(file => buildFiles.has(file));
-            logger.debug(`Filtered files using compile_commands.json: ${filteredFiles.length} out of ${files.length} files`);
-            
-            // Use filtered files if we found any, otherwise use all files
-            files = filteredFiles.length > 0 ? filteredFiles : files;
-        } catch (error) {
-            logger.error('Failed to filter files using compile_commands.json:', error as Error);
-            // Continue with all found files if compile_commands.json parsing fails
-        }
+    // This helps avoid analyzing files that aren't part of the build system.
+    // In multi-root workspaces each root is filtered with its own compile database.
+    const roots = FileUtils.getWorkspaceRoots();
+    const filtered: string[] = [];
+    for (const root of roots.length > 1 ? roots : [null]) {
+        const rootFiles = root ? files.filter(file => FileUtils.getWorkspaceRootFor(file) === root) : files;
+        filtered.push(...filterByCompileDatabase(rootFiles, root ? ConfigManager.getForRoot(root) : configManager));
     }
+    files = filtered;
     
     logger.debug(`Found ${files.length} C/C++ files in whole workspace`);
     return files;
 }
 
-/**
- * Prepare report data from diagnostics
- */
-function prepareReportData(diagnostics: any[], totalFiles: number): ReportData {
-    // Count warnings by checker
-    const warningsByChecker: Record<string, number> = {};
-    diagnostics.forEach(diag => {
-        // Only count warnings with a valid check name
-        if (diag.checkName) {
-            warningsByChecker[diag.checkName] = (warningsByChecker[diag.checkName] || 0) + 1;
-        }
-    });
-
-    // Group diagnostics by file
-    const files: Record<string, any[]> = {};
-    diagnostics.forEach(diag => {
-        if (!files[diag.filePath]) {
-            files[diag.filePath] = [];
-        }
-        files[diag.filePath].push(diag);
-    });
-
-    return {
-        diagnostics,
-        totalFilesChecked: totalFiles,
-        filesWithWarnings: Object.keys(files).length,
-        totalWarnings: diagnostics.length,
-        warningsByChecker,
-        files
-    };
-}
-
 export function deactivate() {
     logger.info('Clang-Tidy Visualizer extension deactivated');
 }
@@ -0,0 +1,151 @@
+// Cache Server - Minimal content-addressed HTTP store for shared result cache entries
+import * as fs from 'fs';
+import * as http from 'http';
+import * as path from 'path';
+import { logger } from '../utils/logger';
+
+export interface CacheServerOptions {
+  host: string;
+  port: number;
+  directory: string;
+  // Bearer token required for writes (and reads when readToken is true)
+  token?: string;
+  readToken?: boolean;
+}
+
+const KEY_PATH = /^\/([0-9a-f]{64})$/;
+const MAX_BODY_BYTES = 64 * 1024 * 1024;
+// Keys per batch request
+const MAX_BATCH_KEYS = 4096;
+
+export class CacheServer {
+  private server: http.Server | null = null;
+
+  constructor(private options: CacheServerOptions) {}
+
+  /**
+   * Start serving; resolves with the bound port
+   */
+  start(): Promise<number> {
+    fs.mkdirSync(this.options.directory, { recursive: true });
+    return new Promise((resolve, reject) => {
+      this.server = http.createServer((req, res) => {
+        this.handle(req, res).catch(error => {
+          logger.warn(`Cache server: ${error instanceof Error ? error.message : String(error)}`);
+          this.reply(res, 500, 'Internal error');
+        });
+      });
+      this.server.once('error', reject);
+      this.server.listen(this.options.port, this.options.host, () => {
+        const address = this.server!.address() as { port: number };
+        logger.info(`Cache server listening on ${this.options.host}:${address.port}, storing in ${this.options.directory}`);
+        resolve(address.port);
+      });
+    });
+  }
+
+  /**
+   * Stop serving
+   */
+  stop(): void {
+    if (this.server) {
+      this.server.close();
+      this.server = null;
+    }
+  }
+
+  private async handle(req: http.IncomingMessage, res: http.ServerResponse): Promise<void> {
+    const url = (req.url || '/').split('?')[0];
+    const writing = req.method !== 'GET' && !(req.method === 'POST' && url === '/batch');
+    if (this.options.token && (writing || this.options.readToken) && req.headers.authorization !== `Bearer ${this.options.token}`) {
+      this.reply(res, 401, 'Unauthorized');
+      return;
+    }
+
+    if (req.method === 'POST' && url === '/batch') {
+      const body = await this.readBody(req);
+      let keys: unknown;
+      try {
+        const request = JSON.parse(body);
+        keys = request && typeof request === 'object' ? request.keys || [] : null;
+      } catch (error) {
+        this.reply(res, 400, 'Batch is not JSON');
+        return;
+      }
+      if (!Array.isArray(keys) || keys.length > MAX_BATCH_KEYS) {
+        this.reply(res, 400, 'Bad batch');
+        return;
+      }
+      const entries: Record<string, unknown> = {};
+      await Promise.all(keys.filter((key): key is string => typeof key === 'string' && KEY_PATH.test('/' + key)).map(async key => {
+        try {
+          entries[key] = JSON.parse(await fs.promises.readFile(this.entryPath(key), 'utf8'));
+        } catch (error) {
+          // Missing entry
+        }
+      }));
+      this.reply(res, 200, JSON.stringify({ entries }), 'application/json');
+      return;
+    }
+
+    const match = KEY_PATH.exec(url);
+    if (!match) {
+      this.reply(res, 404, 'Not found');
+      return;
+    }
+    const entryPath = this.entryPath(match[1]);
+
+    if (req.method === 'GET') {
+      try {
+        this.reply(res, 200, await fs.promises.readFile(entryPath, 'utf8'), 'application/json');
+      } catch (error) {
+        this.reply(res, 404, 'Not found');
+      }
+    } else if (req.method === 'PUT') {
+      const body = await this.readBody(req);
+      try {
+        JSON.parse(body);
+      } catch (error) {
+        this.reply(res, 400, 'Entry is not JSON');
+        return;
+      }
+      const tempPath = `${entryPath}.${process.pid}.${Date.now()}.tmp`;
+      await fs.promises.mkdir(path.dirname(entryPath), { recursive: true });
+      await fs.promises.writeFile(tempPath, body, 'utf8');
+      await fs.promises.rename(tempPath, entryPath);
+      this.reply(res, 204, '');
+    } else {
+      this.reply(res, 405, 'Method not allowed');
+    }
+  }
+
+  private readBody(req: http.IncomingMessage): Promise<string> {
+    return new Promise((resolve, reject) => {
+      let size = 0;
+      const chunks: Buffer[] = [];
+      req.on('data', (chunk: Buffer) => {
+        size += chunk.length;
+        if (size > MAX_BODY_BYTES) {
+          reject(new Error('Request body too large'));
+          req.destroy();
+          return;
+        }
+        chunks.push(chunk);
+      });
+      req.on('end', () => resolve(Buffer.concat(chunks).toString('utf8')));
+      req.on('error', reject);
+    });
+  }
+
+  private reply(res: http.ServerResponse, status: number, body: string, contentType: string = 'text/plain'): void {
+    if (res.headersSent) {
+      return;
+    }
+    res.writeHead(status, { 'Content-Type': contentType });
+    res.end(body);
+  }
+
+  private entryPath(key: string): string {
+    return path.join(this.options.directory, key.substring(0, 2), key + '.json');
+  }
+}
@@ -0,0 +1,109 @@
+// Distributed Executor - Runs tasks on the local pool plus the slots of remote workers
+import { ProcessResult } from '../utils/processUtils';
+import { logger } from '../utils/logger';
+import { AnalysisExecutor, AnalysisTask, LocalExecutor } from '../core/runner/AnalysisExecutor';
+import { RemoteWorker } from './RemoteWorker';
+import { WorkerAgent } from './WorkerAgent';
+
+export interface PlacementOptions {
+  // Tasks estimated below this many milliseconds stay local; shipping them costs more than it saves
+  minRemoteCostMs: number;
+}
+
+export class DistributedExecutor implements AnalysisExecutor {
+  constructor(
+    private local: LocalExecutor,
+    private workers: RemoteWorker[],
+    private placement: PlacementOptions
+  ) {}
+
+  /**
+   * Tasks are dispatched most expensive first. Every local and remote slot pulls the next task
+   * when it becomes free; remote slots only take tasks above the placement threshold.
+   * Tasks a worker fails to run are executed locally instead.
+   */
+  async execute(tasks: AnalysisTask[], onResult?: (index: number, result: ProcessResult) => void): Promise<ProcessResult[]> {
+    const results: ProcessResult[] = new Array(tasks.length);
+    const cache = this.local.getCache();
+    const queue: number[] = [];
+
+    const finish = (index: number, result: ProcessResult) => {
+      results[index] = result;
+      if (onResult) {
+        onResult(index, result);
+      }
+    };
+
+    await Promise.all(tasks.map(async (task, index) => {
+      const cached = task.cacheKey && cache ? await cache.lookup(task.cacheKey, task.cacheRoot) : undefined;
+      if (cached) {
+        finish(index, cached);
+      } else {
+        queue.push(index);
+      }
+    }));
+    // Unknown costs sort first: without history every TU is a candidate for remote slots
+    const costOf = (index: number) => tasks[index].estimatedCost ?? Number.MAX_SAFE_INTEGER;
+    queue.sort((a, b) => costOf(b) - costOf(a));
+
+    let remoteCount = 0;
+
+    const runLocal = async (index: number) => {
+      const [result] = await this.local.execute([tasks[index]]);
+      finish(index, result);
+    };
+
+    const localSlot = async () => {
+      let index: number | undefined;
+      while ((index = queue.shift()) !== undefined) {
+        await runLocal(index);
+      }
+    };
+
+    const remoteSlot = async (worker: RemoteWorker) => {
+      while (worker.isConnected() && queue.length > 0 && costOf(queue[0]) >= this.placement.minRemoteCostMs) {
+        const index = queue.shift()!;
+        // A stopped run is not shipped anywhere; the local pool resolves it as cancelled.
+        // Fix runs and the like would be refused by the worker.
+        if (tasks[index].signal?.aborted || WorkerAgent.findForbiddenArgument(tasks[index]) !== null) {
+          await runLocal(index);
+          continue;
+        }
+        try {
+          const result = await worker.run(tasks[index]);
+          remoteCount++;
+          if (tasks[index].cacheKey && cache) {
+            cache.set(tasks[index].cacheKey!, result, tasks[index].cacheRoot);
+          }
+          finish(index, result);
+        } catch (error) {
+          logger.warn(`Worker ${worker.getAddress()} failed on ${tasks[index].file}, running locally: ${error instanceof Error ? error.message : String(error)}`);
+          await runLocal(index);
+          return;
+        }
+      }
+    };
+
+    const slots: Promise<void>[] = [];
+    for (const worker of this.workers.filter(candidate => candidate.isConnected())) {
+      for (let i = 0; i < worker.getSlots(); i++) {
+        slots.push(remoteSlot(worker));
+      }
+    }
+    for (let i = 0; i < Math.max(1, this.local.getConcurrency()); i++) {
+      slots.push(localSlot());
+    }
+    await Promise.all(slots);
+
+    logger.debug(`Distributed executor: ${remoteCount}/${tasks.length} tasks ran on remote workers`);
+    return results;
+  }
+
+  prefetch(tasks: AnalysisTask[]): void {
+    this.local.prefetch(tasks);
+  }
+
+  dispose(): void {
+    this.workers.forEach(worker => worker.dispose());
+  }
+}
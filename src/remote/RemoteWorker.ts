@@ -0,0 +1,119 @@
+// Remote Worker - Coordinator-side connection to one worker agent
+import * as fs from 'fs';
+import * as net from 'net';
+import { ProcessResult } from '../utils/processUtils';
+import { logger } from '../utils/logger';
+import { AnalysisTask } from '../core/runner/AnalysisExecutor';
+import { onMessages, sendMessage } from '../daemon/protocol';
+import { CoordinatorMessage, REMOTE_PROTOCOL_VERSION, RemoteJob, WorkerMessage, parseAddress } from './protocol';
+
+export class RemoteWorker {
+  private nextId = 1;
+  private handlers = new Map<number, (message: WorkerMessage) => void>();
+  private closed = false;
+  private slots = 0;
+  private host = '';
+  private toolVersion = '';
+
+  private constructor(private socket: net.Socket, private address: string) {
+    onMessages<WorkerMessage>(socket, message => {
+      const handler = this.handlers.get(message.id);
+      if (handler) {
+        this.handlers.delete(message.id);
+        handler(message);
+      }
+    });
+    socket.on('close', () => {
+      this.closed = true;
+      for (const [id, handler] of this.handlers) {
+        handler({ id, type: 'error', message: `Connection to worker ${address} closed` });
+      }
+      this.handlers.clear();
+    });
+    socket.on('error', error => logger.warn(`Worker ${address}: ${error.message}`));
+  }
+
+  /**
+   * Connect to a worker agent at "host:port" and perform the handshake
+   */
+  static async connect(address: string, token?: string): Promise<RemoteWorker> {
+    const { host, port } = parseAddress(address);
+    const socket = await new Promise<net.Socket>((resolve, reject) => {
+      const connection = net.connect(port, host);
+      connection.once('connect', () => {
+        connection.off('error', reject);
+        resolve(connection);
+      });
+      connection.once('error', reject);
+    });
+    socket.setNoDelay(true);
+
+    const worker = new RemoteWorker(socket, address);
+    const hello = await worker.request({ id: worker.nextId++, type: 'hello', version: REMOTE_PROTOCOL_VERSION, token });
+    if (hello.type !== 'hello') {
+      socket.destroy();
+      throw new Error(hello.type === 'error' ? hello.message : 'Unexpected handshake response');
+    }
+    worker.slots = Math.max(1, hello.slots);
+    worker.host = hello.host;
+    worker.toolVersion = hello.toolVersion;
+    logger.info(`Connected to worker ${hello.host} (${address}) with ${worker.slots} slots`);
+    return worker;
+  }
+
+  /**
+   * Run a task on the worker. Rejects if the worker fails or disconnects,
+   * so the caller can run the task elsewhere.
+   */
+  async run(task: AnalysisTask): Promise<ProcessResult> {
+    const configArg = task.args.find(arg => arg.startsWith('--config-file='));
+    const job: RemoteJob = {
+      file: task.file,
+      cwd: String(task.options?.cwd || process.cwd()),
+      args: task.args,
+      compileEntry: task.compileEntry,
+      config: configArg ? fs.readFileSync(configArg.substring('--config-file='.length), 'utf8') : undefined
+    };
+
+    const response = await this.request({ id: this.nextId++, type: 'job', job });
+    if (response.type !== 'result') {
+      throw new Error(response.type === 'error' ? response.message : 'Unexpected response from worker');
+    }
+    return response.result;
+  }
+
+  getAddress(): string {
+    return this.address;
+  }
+
+  getHost(): string {
+    return this.host;
+  }
+
+  getSlots(): number {
+    return this.slots;
+  }
+
+  getToolVersion(): string {
+    return this.toolVersion;
+  }
+
+  isConnected(): boolean {
+    return !this.closed;
+  }
+
+  dispose(): void {
+    this.socket.end();
+  }
+
+  private request(message: CoordinatorMessage): Promise<WorkerMessage> {
+    return new Promise(resolve => {
+      if (this.closed) {
+        resolve({ id: message.id, type: 'error', message: `Connection to worker ${this.address} closed` });
+        return;
+      }
+      this.handlers.set(message.id, resolve);
+      sendMessage(this.socket, message);
+    });
+  }
+}
@@ -0,0 +1,185 @@
+// Worker Agent - Accepts translation units over TCP and runs them with the local clang-tidy
+import * as crypto from 'crypto';
+import * as fs from 'fs';
+import * as net from 'net';
+import * as os from 'os';
+import * as path from 'path';
+import { ProcessResult } from '../utils/processUtils';
+import { logger } from '../utils/logger';
+import { Scheduler } from '../core/runner/Scheduler';
+import { onMessages, sendMessage } from '../daemon/protocol';
+import { CoordinatorMessage, PathMapper, REMOTE_PROTOCOL_VERSION, RemoteJob, WorkerMessage } from './protocol';
+
+export interface WorkerOptions {
+  host: string;
+  port: number;
+  slots: number;
+  clangTidyPath: string;
+  // Version string reported by clang-tidy --version
+  toolVersion: string;
+  pathMappings: string[];
+  // Shared secret coordinators must present, if set
+  token?: string;
+}
+
+// clang-tidy arguments that would load code supplied by the coordinator, write files on the worker or read a response file
+const FORBIDDEN_ARGS = /^(--?(load|fix|fix-errors|fix-notes|export-fixes|store-check-profile)(=|$)|@)/;
+// Compiler arguments loading plugins (-Xclang -load, -fplugin=, -fpass-plugin=) or reading a response file
+const FORBIDDEN_COMPILE_ARGS = /^(--?(load|plugin|add-plugin|fplugin|fpass-plugin)(=|-arg-|$)|@)/;
+// clang-tidy arguments passing their value on to the compiler
+const EXTRA_ARG = /^--?extra-arg(-before)?(=|$)/;
+
+export class WorkerAgent {
+  private server: net.Server | null = null;
+  private scheduler = Scheduler.getInstance();
+  private mapper: PathMapper;
+  private jobCounter = 0;
+
+  constructor(private options: WorkerOptions) {
+    this.mapper = new PathMapper(options.pathMappings);
+    this.scheduler.setConcurrency(options.slots);
+  }
+
+  /**
+   * Start listening; resolves with the bound port
+   */
+  start(): Promise<number> {
+    return new Promise((resolve, reject) => {
+      this.server = net.createServer(socket => this.handleConnection(socket));
+      this.server.once('error', reject);
+      this.server.listen(this.options.port, this.options.host, () => {
+        const address = this.server!.address() as net.AddressInfo;
+        logger.info(`Worker listening on ${this.options.host}:${address.port} with ${this.options.slots} slots`);
+        resolve(address.port);
+      });
+    });
+  }
+
+  /**
+   * Stop accepting coordinators
+   */
+  stop(): void {
+    if (this.server) {
+      this.server.close();
+      this.server = null;
+    }
+  }
+
+  private handleConnection(socket: net.Socket): void {
+    const peer = `${socket.remoteAddress}:${socket.remotePort}`;
+    let authenticated = false;
+    logger.info(`Coordinator connected from ${peer}`);
+
+    socket.on('error', error => logger.warn(`Coordinator ${peer}: ${error.message}`));
+    socket.on('close', () => logger.info(`Coordinator ${peer} disconnected`));
+
+    onMessages<CoordinatorMessage>(socket, message => {
+      if (message.type === 'hello') {
+        if (message.version !== REMOTE_PROTOCOL_VERSION || (this.options.token && !WorkerAgent.tokenMatches(message.token, this.options.token))) {
+          this.send(socket, { id: message.id, type: 'error', message: 'Protocol version mismatch or invalid token' });
+          socket.end();
+          return;
+        }
+        authenticated = true;
+        this.send(socket, {
+          id: message.id,
+          type: 'hello',
+          version: REMOTE_PROTOCOL_VERSION,
+          host: os.hostname(),
+          slots: this.options.slots,
+          toolVersion: this.options.toolVersion
+        });
+        return;
+      }
+
+      if (!authenticated) {
+        socket.destroy();
+        return;
+      }
+
+      this.runJob(message.job).then(
+        result => this.send(socket, { id: message.id, type: 'result', result }),
+        error => this.send(socket, { id: message.id, type: 'error', message: error instanceof Error ? error.message : String(error) })
+      );
+    }, line => logger.warn(`Invalid message from ${peer}: ${line.substring(0, 200)}`));
+  }
+
+  /**
+   * Constant-time token comparison; hashing first makes the lengths equal
+   */
+  static tokenMatches(presented: string | undefined, expected: string): boolean {
+    const digest = (value: string) => crypto.createHash('sha256').update(value).digest();
+    return presented !== undefined && crypto.timingSafeEqual(digest(presented), digest(expected));
+  }
+
+  /**
+   * The first argument of a job that would load coordinator-supplied code or write files on the worker:
+   * plugin or fix arguments to clang-tidy, or plugin arguments in the compile command or in --extra-arg(-before)
+   */
+  static findForbiddenArgument(job: Pick<RemoteJob, 'args' | 'compileEntry'>): string | null {
+    const compileArgs = [...(job.compileEntry?.arguments || [])];
+    for (let i = 0; i < job.args.length; i++) {
+      const arg = job.args[i];
+      if (FORBIDDEN_ARGS.test(arg)) {
+        return arg;
+      }
+      const extra = EXTRA_ARG.exec(arg);
+      if (extra) {
+        // --extra-arg=<flag> or --extra-arg <flag>
+        compileArgs.push(extra[2] === '=' ? arg.substring(arg.indexOf('=') + 1) : job.args[++i] || '');
+      }
+    }
+    return compileArgs.find(arg => FORBIDDEN_COMPILE_ARGS.test(arg)) ?? null;
+  }
+
+  /**
+   * Run one job with paths mapped onto this machine and the output mapped back
+   */
+  private async runJob(job: RemoteJob): Promise<ProcessResult> {
+    const forbidden = WorkerAgent.findForbiddenArgument(job);
+    if (forbidden !== null) {
+      throw new Error(`Argument not allowed on remote workers: ${forbidden}`);
+    }
+
+    const workDir = fs.mkdtempSync(path.join(os.tmpdir(), `ctv-job-${++this.jobCounter}-`));
+    try {
+      let args = job.args.map(arg => this.mapper.toLocal(arg));
+
+      // A private single-entry compile database, so the worker does not need the coordinator's build tree
+      if (job.compileEntry) {
+        const entry = job.compileEntry;
+        fs.writeFileSync(path.join(workDir, 'compile_commands.json'), JSON.stringify([{
+          directory: this.mapper.toLocal(entry.directory),
+          file: this.mapper.toLocal(entry.file),
+          arguments: entry.arguments.map(arg => this.mapper.toLocal(arg))
+        }]));
+        args = ['-p=' + workDir, ...args.filter(arg => !arg.startsWith('-p='))];
+      }
+
+      if (job.config !== undefined) {
+        const configPath = path.join(workDir, '.clang-tidy');
+        fs.writeFileSync(configPath, job.config);
+        args = args.map(arg => arg.startsWith('--config-file=') ? '--config-file=' + configPath : arg);
+      }
+
+      const result = await this.scheduler.submit({
+        command: this.options.clangTidyPath,
+        args,
+        options: { cwd: this.mapper.toLocal(job.cwd) },
+        priority: 'normal'
+      });
+
+      return {
+        ...result,
+        stdout: this.mapper.toRemote(result.stdout),
+        stderr: this.mapper.toRemote(result.stderr)
+      };
+    } finally {
+      fs.rmSync(workDir, { recursive: true, force: true });
+    }
+  }
+
+  private send(socket: net.Socket, message: WorkerMessage): void {
+    sendMessage(socket, message);
+  }
+}
@@ -0,0 +1,79 @@
+// Remote Protocol - Newline-delimited JSON messages between a coordinator and remote workers over TCP
+import { ProcessResult } from '../utils/processUtils';
+import { CompileCommand } from '../core/compiledb/CompileDatabase';
+
+export const REMOTE_PROTOCOL_VERSION = 1;
+export const DEFAULT_WORKER_PORT = 7878;
+
+// One translation unit to analyze. Paths are as seen by the coordinator;
+// the worker maps them onto its own checkout with its --path-map rules.
+export interface RemoteJob {
+  file: string;
+  cwd: string;
+  // clang-tidy arguments without the executable; the worker uses its own clang-tidy
+  args: string[];
+  // Compile command of the TU; written to a private compile database on the worker
+  compileEntry?: CompileCommand;
+  // Contents of the --config-file passed in args, if any
+  config?: string;
+}
+
+// Coordinator -> worker
+export type CoordinatorMessage =
+  | { id: number; type: 'hello'; version: number; token?: string }
+  | { id: number; type: 'job'; job: RemoteJob };
+
+// Worker -> coordinator
+export type WorkerMessage =
+  | { id: number; type: 'hello'; version: number; host: string; slots: number; toolVersion: string }
+  | { id: number; type: 'result'; result: ProcessResult }
+  | { id: number; type: 'error'; message: string };
+
+/**
+ * Parse "host:port" (port defaults to DEFAULT_WORKER_PORT)
+ */
+export function parseAddress(address: string): { host: string; port: number } {
+  const separator = address.lastIndexOf(':');
+  if (separator === -1) {
+    return { host: address, port: DEFAULT_WORKER_PORT };
+  }
+  const port = parseInt(address.substring(separator + 1), 10);
+  if (!(port > 0 && port < 65536)) {
+    throw new Error(`Invalid port in '${address}'`);
+  }
+  return { host: address.substring(0, separator) || '127.0.0.1', port };
+}
+
+/**
+ * Path prefix substitution between the coordinator's and a worker's file system
+ */
+export class PathMapper {
+  private rules: Array<{ from: string; to: string }>;
+
+  /**
+   * @param mappings "coordinatorPrefix=workerPrefix" pairs
+   */
+  constructor(mappings: string[]) {
+    this.rules = mappings.map(mapping => {
+      const separator = mapping.indexOf('=');
+      if (separator <= 0) {
+        throw new Error(`Invalid path mapping '${mapping}', expected FROM=TO`);
+      }
+      return { from: mapping.substring(0, separator), to: mapping.substring(separator + 1) };
+    });
+  }
+
+  /**
+   * Coordinator path (or any string containing one, e.g. -I/path) to worker path
+   */
+  toLocal(value: string): string {
+    return this.rules.reduce((result, rule) => result.split(rule.from).join(rule.to), value);
+  }
+
+  /**
+   * Worker path back to the coordinator's, used on clang-tidy output
+   */
+  toRemote(value: string): string {
+    return this.rules.reduce((result, rule) => result.split(rule.to).join(rule.from), value);
+  }
+}
@@ -8,6 +8,12 @@ export interface RunOptions {
   parallel?: boolean;
   outputFormat?: 'json' | 'text' | 'yaml';
   extraArgs?: string[];
+  // Scheduling class in the shared worker pool
+  priority?: 'interactive' | 'normal' | 'background';
+  // Run only the fast or the slow checks of the configuration
+  checkTier?: 'fast' | 'slow';
+  // Appended to the enabled checks (-checks=); set by the runner for check tiers
+  checkFilter?: string;
 }
 
 // Run Result
@@ -16,6 +22,8 @@ export interface RunResult {
   errorOutput: string;
   exitCode: number;
   duration: number;
+  // Served from a result cache, so duration does not measure an analysis
+  cached?: boolean;
 }
 
 // Diagnostic
@@ -37,11 +45,19 @@ export interface ClangTidyDiagnostic {
   codeLineFull?: string;
   caretLine?: string;
   fixSuggestion?: string;
+  // Build configurations the diagnostic was reported in (multi-configuration policies only)
+  configurations?: string[];
+  // Check tier that reported the diagnostic (tiered runs only)
+  tier?: 'fast' | 'slow';
 }
 
 // Parallel Result
 export interface ParallelResult extends RunResult {
   files: string[];
+  // Configuration label of the compile command analyzed
+  configuration?: string;
+  // Translation unit analyzed on behalf of files (headers); diagnostics outside files are not theirs
+  translationUnit?: string;
 }
 
 // Report Data
@@ -52,6 +68,44 @@ export interface ReportData {
   totalWarnings: number;
   warningsByChecker: Record<string, number>;
   files: Record<string, ClangTidyDiagnostic[]>;
+  // Per-root breakdown for multi-root workspaces
+  roots?: RootSummary[];
+  // Extrapolated totals of a sampled run
+  sampling?: SamplingSummary;
+  // Diagnostics over the caps, counted per file and check but not kept
+  suppressed?: Record<string, Record<string, number>>;
+}
+
+// Extrapolated warning count with its 95% confidence interval
+export interface SampleEstimate {
+  name: string;
+  observed: number;
+  estimate: number;
+  low: number;
+  high: number;
+}
+
+// Estimates of a run over a stratified sample of the translation units
+export interface SamplingSummary {
+  // Requested share of the run, and the estimated share of its cost the sample actually took
+  fraction: number;
+  costShare: number;
+  sampledFiles: number;
+  totalFiles: number;
+  // Found in headers; shared between translation units, so not extrapolated
+  headerDiagnostics: number;
+  total: SampleEstimate;
+  byCheck: SampleEstimate[];
+  byDirectory: SampleEstimate[];
+}
+
+// Report summary of one workspace root
+export interface RootSummary {
+  name: string;
+  path: string;
+  totalFilesChecked: number;
+  filesWithWarnings: number;
+  totalWarnings: number;
 }
 
 // Report Options
@@ -107,8 +161,85 @@ export interface ExtensionConfiguration {
   ignorePatterns: string[];
   excludeDirectories: string[];
   
+  // Result cache configuration
+  cache: {
+    enabled: boolean;
+    directory: string;
+    // Shared backend: http(s) URL or directory (e.g. NFS); empty disables
+    remote: string;
+    // Push new results to the shared backend (usually only CI does)
+    remoteUpload: boolean;
+    remoteToken: string;
+    // Keep results per check, so configuration changes only rerun added or re-parameterized checks
+    checkDelta: boolean;
+  };
+  
+  // Which compile commands of a file are analyzed
+  compileDatabase: {
+    policy: 'canonical' | 'distinct' | 'union';
+    // Further databases (e.g. a Release build directory) analyzed with the union policy
+    additionalPaths: string[];
+    // Strip flags irrelevant to analysis (debug info, optimization, codegen, sanitizers, PCH) before running
+    rewrite: boolean;
+    // Extra rules: "regex" removes matching arguments, "regex => replacement" rewrites them
+    rewriteRules: string[];
+    // Precompile third-party headers shared by translation units with identical flags
+    precompiledHeaders: boolean;
+    // Merge up to this many small translation units with identical flags into one analysis (0 disables)
+    unityBatchSize: number;
+    // Ninja builds: delay translation units whose generated headers are missing, or generate those first
+    generatedHeaders: 'off' | 'delay' | 'generate';
+  };
+  
+  // Tiered analysis: cheap checks first, expensive ones in the background
+  tiers: {
+    enabled: boolean;
+    // Checks (globs) in the slow tier in addition to the built-in ones (clang-analyzer-*, dataflow checks)
+    slowChecks: string[];
+    // Directory of clang-tidy --store-check-profile output; checks taking a large share of check time are slow
+    profileDirectory: string;
+  };
+  
+  // Bounds on the diagnostics kept, so one noisy check cannot swamp parsing and the report (0: unlimited)
+  limits: {
+    maxDiagnosticsPerTranslationUnit: number;
+    maxDiagnosticsPerFileCheck: number;
+  };
+  
+  // Shared analysis daemon configuration
+  daemon: {
+    enabled: boolean;
+    socketPath: string;
+    idleTimeoutMinutes: number;
+  };
+  
+  // Live analysis of files open in the editor
+  live: {
+    // clangd reuses its warm ASTs for the open-files scope and on-save analysis
+    engine: 'clang-tidy' | 'clangd';
+    clangdPath: string;
+    analyzeOnSave: boolean;
+  };
+  
   // Advanced configuration
   extraArgs: string[];
   timeout: number;
   logLevel: 'error' | 'warn' | 'info' | 'debug';
 }
+
+// Settings consumed by the analysis engine.
+// Implemented by ConfigManager inside VS Code and by the command line options of the CLI.
+export interface RunnerSettings {
+  getClangTidyPath(): string;
+  getCompileCommandsPath(): string;
+  getChecks(): string;
+  getHeaderFilter(): string;
+  getExtraArgs(): string[];
+  getParallelJobs(): number;
+  getCacheConfig(): ExtensionConfiguration['cache'];
+  getCompileDatabaseConfig(): ExtensionConfiguration['compileDatabase'];
+  getTierConfig(): ExtensionConfiguration['tiers'];
+  getDiagnosticLimits(): ExtensionConfiguration['limits'];
+  getWorkspaceRoot(): string | null;
+  resolvePath(path: string): string;
+}
@@ -2,8 +2,8 @@
 import * as fs from 'fs';
 import * as path from 'path';
 import * as glob from 'glob';
-import * as vscode from 'vscode';
 import { logger } from './logger';
+import { getVscodeApi } from './vscodeApi';
 
 export class FileUtils {
   /**
@@ -216,12 +216,44 @@ export class FileUtils {
    * Get workspace root directory
    */
   static getWorkspaceRoot(): string | null {
-    if (vscode.workspace.workspaceFolders && vscode.workspace.workspaceFolders.length > 0) {
+    const vscode = getVscodeApi();
+    if (vscode && vscode.workspace.workspaceFolders && vscode.workspace.workspaceFolders.length > 0) {
       return vscode.workspace.workspaceFolders[0].uri.fsPath;
     }
     return null;
   }
 
+  /**
+   * Get all workspace folders (multi-root workspaces have several)
+   */
+  static getWorkspaceRoots(): string[] {
+    const vscode = getVscodeApi();
+    return vscode && vscode.workspace.workspaceFolders
+      ? vscode.workspace.workspaceFolders.map(folder => folder.uri.fsPath)
+      : [];
+  }
+
+  /**
+   * Get the workspace folder containing a file (the innermost one for nested folders)
+   */
+  static getWorkspaceRootFor(filePath: string): string | null {
+    return this.findRoot(filePath, this.getWorkspaceRoots());
+  }
+
+  /**
+   * Get the root containing a file (the innermost one for nested roots)
+   */
+  static findRoot(filePath: string, roots: string[]): string | null {
+    let best: string | null = null;
+    for (const root of roots) {
+      const relative = path.relative(root, filePath);
+      if (!relative.startsWith('..') && !path.isAbsolute(relative) && (!best || root.length > best.length)) {
+        best = root;
+      }
+    }
+    return best;
+  }
+
   /**
    * Parse variables in configuration paths
    */
@@ -1,8 +1,8 @@
 
 // Internationalization Service
-import * as vscode from 'vscode';
 import * as path from 'path';
 import * as fs from 'fs';
+import { getVscodeApi } from './vscodeApi';
 
 /**
  * Internationalization service for loading and managing localized strings
@@ -31,6 +31,13 @@ export class I18nService {
    * Get the user's preferred language from extension settings or VS Code display language
    */
   private getUserLanguage(): string {
+    const vscode = getVscodeApi();
+    if (!vscode) {
+      // CLI and daemon: honor the environment's locale
+      const envLanguage = (process.env.CTV_LANGUAGE || process.env.LANG || '').toLowerCase();
+      return envLanguage.startsWith('zh') ? 'zh-cn' : 'en';
+    }
+    
     // First check extension setting
     const config = vscode.workspace.getConfiguration('clangTidyVisualizer');
     const extensionLanguage = config.get<string>('language', 'auto');
@@ -60,7 +67,7 @@ export class I18nService {
     let extensionPath: string;
     
     // First try to get extension path from VS Code API
-    const extension = vscode.extensions.getExtension('clang-tidy-visualizer');
+    const extension = getVscodeApi()?.extensions.getExtension('clang-tidy-visualizer');
     if (extension && extension.extensionPath) {
       extensionPath = extension.extensionPath;
     } else {
@@ -1,9 +1,10 @@
 // Logging Utility
 
-import * as vscode from 'vscode';
+import type * as vscode from 'vscode';
 import * as fs from 'fs';
 import * as path from 'path';
-import { ExtensionContext } from 'vscode';
+import type { ExtensionContext } from 'vscode';
+import { getVscodeApi } from './vscodeApi';
 
 // Log Levels
 export type LogLevel = 'error' | 'warn' | 'info' | 'debug';
@@ -11,12 +12,15 @@ export type LogLevel = 'error' | 'warn' | 'info' | 'debug';
 // Logger Class
 export class Logger {
   private static instance: Logger | null = null;
-  private outputChannel: vscode.OutputChannel;
+  private vscodeApi: typeof vscode | null;
+  private outputChannel: vscode.OutputChannel | null;
   private logLevel: LogLevel = 'info';
   private logFile: string | null = null;
 
   private constructor() {
-    this.outputChannel = vscode.window.createOutputChannel('Clang-Tidy Visualizer');
+    // Outside the extension host (daemon, CLI) messages go to stderr
+    this.vscodeApi = getVscodeApi();
+    this.outputChannel = this.vscodeApi ? this.vscodeApi.window.createOutputChannel('Clang-Tidy Visualizer') : null;
   }
 
   /**
@@ -49,6 +53,17 @@ export class Logger {
     this.info('Logger initialized');
   }
 
+  /**
+   * Write log messages to a file (used by processes without an output channel)
+   */
+  setLogFile(filePath: string): void {
+    const logDir = path.dirname(filePath);
+    if (!fs.existsSync(logDir)) {
+      fs.mkdirSync(logDir, { recursive: true });
+    }
+    this.logFile = filePath;
+  }
+
   /**
    * Set Log Level
    */
@@ -95,21 +110,21 @@ export class Logger {
    * Show Output Channel
    */
   showOutput(): void {
-    this.outputChannel.show(true);
+    this.outputChannel?.show(true);
   }
 
   /**
    * Hide Output Channel
    */
   hideOutput(): void {
-    this.outputChannel.hide();
+    this.outputChannel?.hide();
   }
 
   /**
    * Clear Output
    */
   clear(): void {
-    this.outputChannel.clear();
+    this.outputChannel?.clear();
   }
 
   /**
@@ -130,8 +145,12 @@ export class Logger {
     // Add error stack if present
     const fullMessage = error ? `${logMessage}\n${error.stack}` : logMessage;
     
-    // Log to output channel
-    this.outputChannel.appendLine(fullMessage);
+    // Log to output channel, or stderr outside the extension host
+    if (this.outputChannel) {
+      this.outputChannel.appendLine(fullMessage);
+    } else if (!this.logFile) {
+      process.stderr.write(fullMessage + '\n');
+    }
     
     // Log to file if enabled
     if (this.logFile) {
@@ -143,8 +162,8 @@ export class Logger {
     }
     
     // Show error messages to user
-    if (level === 'error') {
-      vscode.window.showErrorMessage(`Clang-Tidy Visualizer: ${message}`);
+    if (level === 'error' && this.vscodeApi) {
+      this.vscodeApi.window.showErrorMessage(`Clang-Tidy Visualizer: ${message}`);
     }
   }
 }
@@ -8,6 +8,12 @@ export interface ProcessResult {
   stderr: string;
   exitCode: number;
   duration: number;
+  // Set when the task was cancelled before it finished (e.g. a fail-fast run stopped)
+  cancelled?: boolean;
+  // Signal that ended the process, if one did
+  signal?: string;
+  // Served (wholly or partly) from a result cache; duration is then not the cost of this run
+  cached?: boolean;
 }
 
 export class ProcessUtils {
@@ -39,13 +45,15 @@ export class ProcessUtils {
         stderr += data.toString();
       });
       
-      child.on('close', (exitCode) => {
+      child.on('close', (exitCode, signal) => {
         const duration = Date.now() - startTime;
+        // A process killed by a signal (a crash) has no exit code; report it the way shells do
         resolve({
           stdout,
-          stderr,
-          exitCode: exitCode || 0,
-          duration
+          stderr: signal ? `${stderr}\nTerminated by ${signal}` : stderr,
+          exitCode: signal ? 128 + (os.constants.signals[signal] || 0) : exitCode || 0,
+          duration,
+          signal: signal || undefined
         });
       });
       
@@ -0,0 +1,19 @@
+// VS Code API access for code shared with the daemon and CLI
+import type * as vscode from 'vscode';
+
+let cachedApi: typeof vscode | null | undefined;
+
+/**
+ * Get the VS Code API if running inside the extension host, otherwise null.
+ * Modules used by the daemon and the CLI must go through this instead of importing 'vscode'.
+ */
+export function getVscodeApi(): typeof vscode | null {
+  if (cachedApi === undefined) {
+    try {
+      cachedApi = require('vscode');
+    } catch (error) {
+      cachedApi = null;
+    }
+  }
+  return cachedApi ?? null;
+}
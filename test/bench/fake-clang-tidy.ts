@@ -0,0 +1,157 @@
+// Fake clang-tidy - Stand-in executable taking clang-tidy's arguments that spends modelled time and memory per file
+//
+//   node out/test/bench/fake-clang-tidy.js -checks=* -p=build src/a.cpp
+//
+// The workload model comes from the FAKE_CLANG_TIDY_MODEL environment variable (see workload.ts).
+// --version, -list-checks and --dump-config answer like clang-tidy; every other invocation "analyzes"
+// its sources: it waits out (or burns a core for) their modelled cost, touches their memory, prints
+// realistic findings on their real source lines, and crashes or hangs for the files the model says.
+// Unity sources are recognized by their member markers and cost their members with headers parsed once; like
+// clang-tidy, findings in a unity source are reported at the generated file and its physical lines.
+import * as fs from 'fs';
+import { CHECKS, SyntheticDiagnostic, SyntheticOutput } from './synthetic-output';
+import { Workload } from './workload';
+
+const VERSION = 'LLVM (http://llvm.org/):\n  LLVM version 18.1.8 (fake clang-tidy)\n  Optimized build.\n';
+
+async function main(argv: string[]): Promise<number> {
+  if (argv.includes('--version')) {
+    process.stdout.write(VERSION);
+    return 0;
+  }
+  const checks = checkPatterns(argv);
+  const enabled = CHECKS.filter(([name]) => isEnabled(name, checks));
+  if (argv.includes('-list-checks') || argv.includes('--list-checks')) {
+    process.stdout.write('Enabled checks:\n' + enabled.map(([name]) => `    ${name}\n`).join('') + '\n');
+    return 0;
+  }
+  if (argv.includes('--dump-config') || argv.includes('-dump-config')) {
+    process.stdout.write(`---\nChecks: '${checks.join(',')}'\nHeaderFilterRegex: ''\nCheckOptions:\n` +
+      '  readability-identifier-length.MinimumVariableNameLength: \'3\'\n' +
+      '  readability-function-cognitive-complexity.Threshold: \'25\'\n...\n');
+    return 0;
+  }
+
+  const workload = Workload.fromEnvironment();
+  const sources = argv.filter(arg => !arg.startsWith('-'));
+  let warnings = 0;
+  for (const source of sources) {
+    const content = fs.existsSync(source) ? fs.readFileSync(source, 'utf8') : '';
+    const members = unityMembers(content);
+    const files = members.length > 0 ? members.map(member => member.file) : [source];
+    const cost = workload.unitCost(files);
+    // Memory grows with the unit, like an AST does
+    const memory = Buffer.alloc(Math.round(workload.model.memoryMB * 1048576 * Math.min(cost / workload.model.meanMs, 8)));
+    memory.fill(1);
+
+    if (files.some(file => workload.hangs(file))) {
+      await spend(workload.model.hangMs, workload.model.mode);
+    }
+    await spend(cost, workload.model.mode);
+
+    const diagnostics = members.length > 0
+      ? members.flatMap(member => findings(member.file, workload, enabled).map(diag => ({ ...diag, file: source, line: diag.line + member.line - 1 })))
+      : findings(source, workload, enabled);
+    if (files.some(file => workload.crashes(file))) {
+      // Part of the output makes it out before the crash, like a real one
+      process.stdout.write(SyntheticOutput.toText(diagnostics.slice(0, Math.floor(diagnostics.length / 2))));
+      process.stderr.write(`Stack dump:\n0.\tProgram arguments: clang-tidy ${argv.join(' ')}\n1.\t<eof> parser at end of file\n`);
+      process.kill(process.pid, 'SIGSEGV');
+      await spend(1000, 'sleep');
+    }
+    if (diagnostics.length > 0) {
+      process.stdout.write(SyntheticOutput.toText(diagnostics));
+    }
+    warnings += diagnostics.length;
+  }
+  if (warnings > 0) {
+    process.stderr.write(`${warnings} warnings generated.\n`);
+  }
+  return 0;
+}
+
+/**
+ * Check globs in effect: the configuration file's Checks, then -checks=
+ */
+function checkPatterns(argv: string[]): string[] {
+  const patterns: string[] = [];
+  const configFile = argv.find(arg => arg.startsWith('--config-file='));
+  if (configFile) {
+    const match = /^Checks:\s*['"]?([^'"\n]*)/m.exec(fs.readFileSync(configFile.substring('--config-file='.length), 'utf8'));
+    if (match) {
+      patterns.push(...match[1].split(','));
+    }
+  }
+  argv.filter(arg => arg.startsWith('-checks=') || arg.startsWith('--checks='))
+    .forEach(arg => patterns.push(...arg.substring(arg.indexOf('=') + 1).split(',')));
+  return patterns.map(pattern => pattern.trim()).filter(Boolean);
+}
+
+/**
+ * clang-tidy semantics: the last glob matching a check decides, "-" disables
+ */
+function isEnabled(check: string, patterns: string[]): boolean {
+  let enabled = false;
+  for (const pattern of patterns) {
+    const negative = pattern.startsWith('-');
+    const glob = negative ? pattern.substring(1) : pattern;
+    if (new RegExp('^' + glob.replace(/[.+?^${}()|[\]\\]/g, '\\$&').replace(/\*/g, '.*') + '$').test(check)) {
+      enabled = !negative;
+    }
+  }
+  return enabled;
+}
+
+/**
+ * Members of a unity source and the line each one starts at
+ */
+function unityMembers(content: string): Array<{ file: string; line: number }> {
+  const lines = content.split('\n');
+  return lines.flatMap((text, index) => {
+    const match = /^\/\/ unity member "((?:[^"\\]|\\.)*)"$/.exec(text);
+    return match ? [{ file: match[1].replace(/\\(.)/g, '$1'), line: index + 2 }] : [];
+  });
+}
+
+/**
+ * Findings of a source on its real lines, spread over the enabled checks
+ */
+function findings(file: string, workload: Workload, enabled: Array<[string, string]>): SyntheticDiagnostic[] {
+  if (enabled.length === 0 || !fs.existsSync(file)) {
+    return [];
+  }
+  const lines = fs.readFileSync(file, 'utf8').split('\n');
+  const code = lines.map((_, index) => index).filter(index => lines[index].trim() !== '');
+  if (code.length === 0) {
+    return [];
+  }
+  return Array.from({ length: workload.diagnosticsIn(file) }, (_, index) => {
+    const line = code[Math.floor(workload.uniform(file, `line${index}`) * code.length)];
+    const [check, template] = enabled[Math.floor(workload.uniform(file, `check${index}`) * enabled.length)];
+    return {
+      file,
+      line: line + 1,
+      column: 1 + lines[line].search(/\S/),
+      severity: 'warning' as const,
+      check,
+      message: template.replace('{id}', 'value').replace('{num}', String(index + 2)),
+      code: lines[line]
+    };
+  });
+}
+
+function spend(ms: number, mode: 'sleep' | 'cpu'): Promise<void> {
+  if (mode === 'cpu') {
+    const end = Date.now() + ms;
+    while (Date.now() < end) {
+      // Busy wait
+    }
+    return Promise.resolve();
+  }
+  return new Promise(resolve => setTimeout(resolve, ms));
+}
+
+main(process.argv.slice(2)).then(code => process.exit(code), error => {
+  process.stderr.write(`fake clang-tidy: ${error instanceof Error ? error.message : String(error)}\n`);
+  process.exit(1);
+});
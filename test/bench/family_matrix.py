@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+"""Cost matrix of clang-tidy check families over the test corpus, compared against a stored baseline.
+
+Runs clang-tidy with one check family at a time (bugprone, modernize, performance, readability, google, misc)
+against every test/test_cases category and against a scaled-up corpus (the test cases replicated into --units
+translation units, as in head_to_head.py). Every cell reports the CPU time of its clang-tidy processes (median
+of --runs), the largest process RSS and the distinct findings of the family. A "frontend" row runs only the
+compiler diagnostics, so each family's own cost is its time minus the frontend's.
+
+The matrix is compared with the baseline (--baseline, default test/bench/baselines/family-matrix.json): a cell
+whose family cost grew by more than --threshold times (and --min-delta seconds) is a regression, and the script
+exits with 1. Without a baseline, or with --update-baseline, the matrix becomes the baseline. Baselines are only
+comparable on the machine that recorded them, so record one per machine and rerun after a clang-tidy upgrade.
+
+  python3 test/bench/family_matrix.py --units 200 --jobs 8 --runs 3
+"""
+import argparse
+import concurrent.futures
+import json
+import os
+import platform
+import re
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+from head_to_head import FINDING, REPO, TEST_CASES, generate_project, measure
+
+FAMILIES = ["bugprone", "modernize", "performance", "readability", "google", "misc"]
+FRONTEND = "frontend"
+DEFAULT_BASELINE = os.path.join(REPO, "test", "bench", "baselines", "family-matrix.json")
+
+
+def checks_of(family):
+    return "-*,clang-diagnostic-*" if family == FRONTEND else "-*,%s-*" % family
+
+
+def run_cell(clang_tidy, family, sources, build, header_filter, jobs):
+    """Analyze the sources with one family: CPU seconds summed over the processes, wall seconds, largest RSS and findings"""
+    def analyze(source):
+        command = [clang_tidy, "-checks=" + checks_of(family), "-header-filter=" + header_filter, "-quiet", source]
+        # The test cases have no compile database
+        command += ["-p", build] if build else ["--", "-std=c++17"]
+        return measure(command, os.path.dirname(source))
+
+    start = time.perf_counter()
+    with concurrent.futures.ThreadPoolExecutor(max_workers=jobs) as pool:
+        samples = list(pool.map(analyze, sources))
+    wall = time.perf_counter() - start
+    findings = set()
+    for sample in samples:
+        for match in map(FINDING.match, sample["stdout"].splitlines()):
+            # Headers are reported by every unit including them
+            if match and any(check.startswith(family + "-") or family == FRONTEND for check in match.group(6).split(",")):
+                findings.add(match.groups()[:3] + match.groups()[4:])
+    return {
+        "cpuSec": sum(sample["cpuSec"] for sample in samples),
+        "wallSec": wall,
+        "maxProcessRssMB": max(sample["maxProcessRssMB"] for sample in samples),
+        "findings": len(findings),
+        "failed": sum(1 for sample in samples if sample["exitCode"] not in (0, 1)),
+    }
+
+
+def compare(matrix, baseline, threshold, min_delta):
+    """Cells of the matrix whose family cost grew beyond the threshold, and cells whose yield changed"""
+    regressions = []
+    yield_changes = []
+    for family, row in matrix.items():
+        for category, cell in row.items():
+            before = baseline.get("matrix", {}).get(family, {}).get(category)
+            if not before:
+                continue
+            if cell["costSec"] > before["costSec"] * threshold and cell["costSec"] - before["costSec"] > min_delta:
+                regressions.append({"family": family, "category": category, "costSec": cell["costSec"],
+                                    "baselineCostSec": before["costSec"],
+                                    "ratio": round(cell["costSec"] / before["costSec"], 2) if before["costSec"] > 0 else None})
+            if cell["findings"] != before["findings"]:
+                yield_changes.append({"family": family, "category": category, "findings": cell["findings"],
+                                      "baselineFindings": before["findings"]})
+    return regressions, yield_changes
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--families", default=",".join(FAMILIES), help="check families (default: %s)" % ",".join(FAMILIES))
+    parser.add_argument("--units", type=int, default=200, help="translation units of the scaled corpus, 0 to skip it (default: 200)")
+    parser.add_argument("--modules", type=int, default=8, help="modules of the scaled corpus (default: 8)")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count(), help="parallel clang-tidy processes")
+    parser.add_argument("--runs", type=int, default=3, help="repetitions per cell (default: 3)")
+    parser.add_argument("--clang-tidy", default="clang-tidy")
+    parser.add_argument("--baseline", default=DEFAULT_BASELINE, help="baseline matrix (default: test/bench/baselines/family-matrix.json)")
+    parser.add_argument("--update-baseline", action="store_true", help="store this matrix as the baseline")
+    parser.add_argument("--threshold", type=float, default=1.5, help="family cost ratio over the baseline that is a regression (default: 1.5)")
+    parser.add_argument("--min-delta", type=float, default=0.2, help="smallest cost increase in seconds that is a regression (default: 0.2)")
+    parser.add_argument("--work-dir", help="scaled corpus location (default: a temporary directory)")
+    parser.add_argument("--out", help="write results as JSON here instead of stdout")
+    args = parser.parse_args()
+
+    families = args.families.split(",")
+    unknown = [family for family in families if family not in FAMILIES]
+    if unknown:
+        parser.error("unknown family(s) %s; expected %s" % (", ".join(unknown), ", ".join(FAMILIES)))
+    if not shutil.which(args.clang_tidy):
+        parser.error("%s not found; pass --clang-tidy" % args.clang_tidy)
+
+    # Categories: each test case on its own (test_google_style.cpp is "google_style"), then the scaled corpus
+    categories = {}
+    for name in sorted(os.listdir(TEST_CASES)):
+        if name.startswith("test_") and name.endswith(".cpp"):
+            categories[name[len("test_"):-len(".cpp")]] = ([os.path.join(TEST_CASES, name)], None, "^" + re.escape(TEST_CASES + os.sep))
+    if args.units > 0:
+        work = args.work_dir or tempfile.mkdtemp(prefix="ctv-family-matrix-")
+        project = os.path.join(work, "project")
+        shutil.rmtree(project, ignore_errors=True)
+        generate_project(project, args.units, args.modules)
+        build = os.path.join(project, "build")
+        with open(os.path.join(build, "compile_commands.json"), encoding="utf-8") as f:
+            sources = [entry["file"] for entry in json.load(f)]
+        categories["scaled-%d" % len(sources)] = (sources, build, "^" + re.escape(project + os.sep))
+        print("Generated %d translation units in %s" % (len(sources), project), file=sys.stderr)
+
+    matrix = {}
+    for family in [FRONTEND] + families:
+        for category, (sources, build, header_filter) in categories.items():
+            samples = [run_cell(args.clang_tidy, family, sources, build, header_filter, args.jobs) for _ in range(args.runs)]
+            cell = {
+                "cpuSec": round(statistics.median(sample["cpuSec"] for sample in samples), 3),
+                "wallSec": round(statistics.median(sample["wallSec"] for sample in samples), 3),
+                "maxProcessRssMB": round(max(sample["maxProcessRssMB"] for sample in samples), 1),
+                "findings": samples[-1]["findings"],
+                "failed": samples[-1]["failed"],
+            }
+            matrix.setdefault(family, {})[category] = cell
+            print("%-12s %-16s %8.2fs cpu %8.2fs wall %8.1f MB  %5d findings%s" % (
+                family, category, cell["cpuSec"], cell["wallSec"], cell["maxProcessRssMB"], cell["findings"],
+                "  %d failed" % cell["failed"] if cell["failed"] else ""), file=sys.stderr)
+    # A family's own cost: its time above parsing and the compiler diagnostics alone
+    for family in families:
+        for category, cell in matrix[family].items():
+            cell["costSec"] = round(max(0.0, cell["cpuSec"] - matrix[FRONTEND][category]["cpuSec"]), 3)
+    matrix[FRONTEND] = {category: dict(cell, costSec=cell["cpuSec"]) for category, cell in matrix[FRONTEND].items()}
+
+    version = subprocess.run([args.clang_tidy, "--version"], capture_output=True, text=True).stdout.strip()
+    document = {
+        "benchmark": "family-matrix",
+        "version": 1,
+        "createdAt": time.strftime("%Y-%m-%dT%H:%M:%SZ", time.gmtime()),
+        "environment": {
+            "python": platform.python_version(),
+            "platform": "%s-%s" % (sys.platform, platform.machine()),
+            "cpus": os.cpu_count(),
+            "clangTidy": version.splitlines()[1].strip() if len(version.splitlines()) > 1 else version,
+        },
+        "parameters": {"families": families, "categories": list(categories), "units": args.units,
+                       "modules": args.modules, "jobs": args.jobs, "runs": args.runs},
+        "matrix": matrix,
+    }
+
+    baseline = None
+    if os.path.exists(args.baseline) and not args.update_baseline:
+        with open(args.baseline, encoding="utf-8") as f:
+            baseline = json.load(f)
+    regressions = []
+    if baseline:
+        regressions, yield_changes = compare(matrix, baseline, args.threshold, args.min_delta)
+        document["baseline"] = {"path": args.baseline, "createdAt": baseline.get("createdAt"),
+                                "clangTidy": baseline.get("environment", {}).get("clangTidy"),
+                                "regressions": regressions, "yieldChanges": yield_changes}
+        if baseline.get("environment", {}).get("clangTidy") != document["environment"]["clangTidy"]:
+            print("clang-tidy changed since the baseline: %s -> %s" % (
+                baseline.get("environment", {}).get("clangTidy"), document["environment"]["clangTidy"]), file=sys.stderr)
+        if baseline.get("environment", {}).get("platform") != document["environment"]["platform"] or \
+                baseline.get("environment", {}).get("cpus") != document["environment"]["cpus"]:
+            print("The baseline was recorded on a different machine; its times are not comparable", file=sys.stderr)
+        for regression in regressions:
+            print("REGRESSION %s on %s: %.2fs, baseline %.2fs" % (
+                regression["family"], regression["category"], regression["costSec"], regression["baselineCostSec"]), file=sys.stderr)
+        for change in yield_changes:
+            print("Yield of %s on %s: %d findings, baseline %d" % (
+                change["family"], change["category"], change["findings"], change["baselineFindings"]), file=sys.stderr)
+    else:
+        os.makedirs(os.path.dirname(os.path.abspath(args.baseline)), exist_ok=True)
+        with open(args.baseline, "w", encoding="utf-8") as f:
+            f.write(json.dumps(document, indent=2) + "\n")
+        print("Baseline written to %s" % args.baseline, file=sys.stderr)
+
+    text = json.dumps(document, indent=2) + "\n"
+    if args.out:
+        with open(args.out, "w", encoding="utf-8") as f:
+            f.write(text)
+        print("Results written to %s" % args.out, file=sys.stderr)
+    else:
+        sys.stdout.write(text)
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == "__main__":
+    main()
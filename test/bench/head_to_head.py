@@ -0,0 +1,326 @@
+#!/usr/bin/env python3
+"""Head-to-head benchmark of ctv against LLVM's run-clang-tidy.py.
+
+Generates a synthetic CMake project by replicating test/test_cases/*.cpp into N translation units spread
+over modules with their own headers and a shared one, writes its compile database, and runs both tools
+over it with the same checks, header filter and job count, each from a cold and a warm state:
+
+  ctv             cold: empty result cache; warm: rerun with the cache the cold run filled
+  run-clang-tidy  has no cache, so cold and warm differ only by the OS file cache of the first run
+
+Reported per tool, variant and state (median of --runs): wall time, CPU time of the whole process tree,
+the largest single-process RSS, the peak RSS summed over the process tree (Linux), and the number of
+distinct findings, which should agree between the tools.
+
+  npm run compile && python3 test/bench/head_to_head.py --units 500 --jobs 8 --out head-to-head.json
+"""
+import argparse
+import json
+import os
+import platform
+import re
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+REPO = os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+TEST_CASES = os.path.join(REPO, "test", "test_cases")
+CHECKS = "-*,bugprone-*,modernize-*,performance-*,readability-*,google-*,misc-*"
+# ctv variants: how users run it, without compile command rewriting, and with unity analysis
+VARIANTS = {
+    "default": [],
+    "keep-compile-flags": ["--keep-compile-flags"],
+    "unity8": ["--unity", "8"],
+}
+FINDING = re.compile(r"^(.+?):(\d+):(\d+): (warning|error): (.+) \[([\w.,-]+)\]$")
+
+
+def generate_project(root, units, modules):
+    """Replicate the test cases into `units` sources over `modules` modules, with a CMake build and its compile database"""
+    cases = sorted(name for name in os.listdir(TEST_CASES) if name.endswith(".cpp"))
+    compiler = shutil.which("c++") or shutil.which("clang++") or "/usr/bin/c++"
+    common = os.path.join(root, "common", "include", "common")
+    os.makedirs(common, exist_ok=True)
+    write(os.path.join(common, "config.h"), COMMON_HEADER)
+
+    sources = {}
+    for index in range(units):
+        module = "module%d" % (index % modules)
+        case = cases[index % len(cases)]
+        source = os.path.join(root, "modules", module, "src", "%s_%d.cpp" % (case[:-4], index))
+        with open(os.path.join(TEST_CASES, case), encoding="utf-8") as f:
+            content = f.read()
+        write(source, '#include "common/config.h"\n#include "%s/%s.h"\n%s' % (module, module, content))
+        sources.setdefault(module, []).append(source)
+
+    lists = ["cmake_minimum_required(VERSION 3.10)", "project(CtvBenchmark CXX)", "set(CMAKE_CXX_STANDARD 17)",
+             "set(CMAKE_EXPORT_COMPILE_COMMANDS ON)", ""]
+    entries = []
+    for module, files in sorted(sources.items()):
+        include = os.path.join(root, "modules", module, "include")
+        write(os.path.join(include, module, module + ".h"), MODULE_HEADER.replace("MODULE", module))
+        relative = " ".join(os.path.relpath(f, root).replace(os.sep, "/") for f in files)
+        lists.append("add_library(%s OBJECT %s)" % (module, relative))
+        lists.append("target_include_directories(%s PRIVATE common/include modules/%s/include)" % (module, module))
+        for f in files:
+            obj = "CMakeFiles/%s.dir/%s.o" % (module, os.path.relpath(f, os.path.join(root, "modules", module)).replace(os.sep, "/"))
+            # What CMake writes for a RelWithDebInfo build with Ninja
+            entries.append({
+                "directory": os.path.join(root, "build"),
+                "command": "%s -I%s -I%s -O2 -g -DNDEBUG -std=gnu++17 -Wall -Wextra -MD -MT %s -MF %s.d -o %s -c %s"
+                           % (compiler, os.path.join(root, "common", "include"), include, obj, obj, obj, f),
+                "file": f,
+                "output": obj,
+            })
+    write(os.path.join(root, "CMakeLists.txt"), "\n".join(lists) + "\n")
+    write(os.path.join(root, "build", "compile_commands.json"), json.dumps(entries, indent=2))
+    return len(entries)
+
+
+COMMON_HEADER = """#pragma once
+#include <map>
+#include <string>
+#include <vector>
+
+#define BENCH_BUFFER_SIZE 4096
+
+namespace common {
+struct Options {
+  int size = 0;
+  std::string name;
+  std::map<std::string, std::string> values;
+};
+
+inline int scaled(int value) { return value * 1024; }
+
+inline std::string describe(Options options) {
+  std::string result = options.name;
+  for (auto it = options.values.begin(); it != options.values.end(); ++it) {
+    result += it->first + "=" + it->second;
+  }
+  return result;
+}
+}  // namespace common
+"""
+
+MODULE_HEADER = """#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace MODULE {
+class Registry {
+ public:
+  void add(std::string name) { names.push_back(name); }
+  int count() const { return (int)names.size(); }
+  std::vector<std::string> names;
+};
+
+inline Registry *createRegistry() { return new Registry(); }
+}  // namespace MODULE
+"""
+
+
+def write(path, content):
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, "w", encoding="utf-8") as f:
+        f.write(content)
+
+
+def tree_rss(pid):
+    """RSS in bytes of a process and all its descendants (Linux only)"""
+    total = 0
+    pending = [pid]
+    page = os.sysconf("SC_PAGE_SIZE")
+    while pending:
+        current = pending.pop()
+        try:
+            with open("/proc/%d/statm" % current) as f:
+                total += int(f.read().split()[1]) * page
+            for task in os.listdir("/proc/%d/task" % current):
+                with open("/proc/%d/task/%s/children" % (current, task)) as f:
+                    pending.extend(int(child) for child in f.read().split())
+        except (OSError, ValueError):
+            continue
+    return total
+
+
+def measure(command, cwd):
+    """Run a command; wall and CPU seconds, largest process and peak process tree RSS in MB, exit code and stdout"""
+    with tempfile.TemporaryFile() as output:
+        start = time.perf_counter()
+        process = subprocess.Popen(command, cwd=cwd, stdout=output, stderr=subprocess.DEVNULL)
+        peak = [0]
+        done = threading.Event()
+
+        def sample():
+            while not done.wait(0.05):
+                peak[0] = max(peak[0], tree_rss(process.pid))
+
+        sampler = threading.Thread(target=sample, daemon=True) if sys.platform.startswith("linux") else None
+        if sampler:
+            sampler.start()
+        # wait4 covers the process and every descendant it waited for
+        _, status, usage = os.wait4(process.pid, 0)
+        wall = time.perf_counter() - start
+        done.set()
+        process.returncode = os.waitstatus_to_exitcode(status)
+        output.seek(0)
+        stdout = output.read().decode("utf-8", "replace")
+    # ru_maxrss is in kilobytes on Linux and bytes on macOS
+    max_rss = usage.ru_maxrss / (1048576 if sys.platform == "darwin" else 1024)
+    return {
+        "wallSec": wall,
+        "cpuSec": usage.ru_utime + usage.ru_stime,
+        "maxProcessRssMB": max_rss,
+        "peakTreeRssMB": peak[0] / 1048576 if sampler else None,
+        "exitCode": process.returncode,
+        "stdout": stdout,
+    }
+
+
+def text_findings(stdout):
+    """Distinct findings in clang-tidy text output (headers are reported by every TU including them)"""
+    return len({match.groups()[:3] + match.groups()[4:] for match in map(FINDING.match, stdout.splitlines()) if match})
+
+
+def ctv_findings(out_dir):
+    try:
+        with open(os.path.join(out_dir, "report.json"), encoding="utf-8") as f:
+            return json.load(f).get("totalWarnings")
+    except (OSError, ValueError):
+        return None
+
+
+def find_run_clang_tidy(clang_tidy):
+    for name in ("run-clang-tidy", "run-clang-tidy.py"):
+        found = shutil.which(name)
+        if found:
+            return found
+    resolved = shutil.which(clang_tidy)
+    if resolved:
+        candidate = os.path.join(os.path.dirname(os.path.realpath(resolved)), "..", "share", "clang", "run-clang-tidy.py")
+        if os.path.exists(candidate):
+            return os.path.normpath(candidate)
+    return None
+
+
+def summarize(tool, variant, state, samples, findings):
+    def median(key):
+        values = [sample[key] for sample in samples if sample[key] is not None]
+        return round(statistics.median(values), 3) if values else None
+
+    return {
+        "tool": tool,
+        "variant": variant,
+        "cache": state,
+        "runs": len(samples),
+        "wallSec": {"median": median("wallSec"), "min": round(min(sample["wallSec"] for sample in samples), 3)},
+        "cpuSec": median("cpuSec"),
+        "maxProcessRssMB": median("maxProcessRssMB"),
+        "peakTreeRssMB": median("peakTreeRssMB"),
+        "findings": findings,
+        "exitCodes": sorted({sample["exitCode"] for sample in samples}),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--units", type=int, default=200, help="translation units to generate (default: 200)")
+    parser.add_argument("--modules", type=int, default=8, help="modules (directories with their own header) (default: 8)")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count(), help="parallel clang-tidy processes for both tools")
+    parser.add_argument("--runs", type=int, default=3, help="repetitions per measurement (default: 3)")
+    parser.add_argument("--checks", default=CHECKS)
+    parser.add_argument("--variants", default="default", help="ctv variants: " + ", ".join(VARIANTS) + " (default: default)")
+    parser.add_argument("--clang-tidy", default="clang-tidy")
+    parser.add_argument("--run-clang-tidy", help="run-clang-tidy(.py) script (default: searched in PATH and next to clang-tidy)")
+    parser.add_argument("--ctv", default=os.path.join(REPO, "dist", "cli.js"), help="ctv entry point (default: dist/cli.js)")
+    parser.add_argument("--work-dir", help="project and cache location (default: a temporary directory)")
+    parser.add_argument("--out", help="write results as JSON here instead of stdout")
+    args = parser.parse_args()
+
+    variants = args.variants.split(",")
+    unknown = [variant for variant in variants if variant not in VARIANTS]
+    if unknown:
+        parser.error("unknown variant(s) %s" % ", ".join(unknown))
+    run_clang_tidy = args.run_clang_tidy or find_run_clang_tidy(args.clang_tidy)
+    if not run_clang_tidy:
+        parser.error("run-clang-tidy not found; pass --run-clang-tidy")
+    if not os.path.exists(args.ctv):
+        parser.error("%s not found; run npm run compile first" % args.ctv)
+
+    work = args.work_dir or tempfile.mkdtemp(prefix="ctv-head-to-head-")
+    project = os.path.join(work, "project")
+    shutil.rmtree(project, ignore_errors=True)
+    units = generate_project(project, args.units, args.modules)
+    build = os.path.join(project, "build")
+    header_filter = "^" + re.escape(project + os.sep)
+    print("Generated %d translation units in %s" % (units, project), file=sys.stderr)
+
+    rct_command = [sys.executable, run_clang_tidy] if run_clang_tidy.endswith(".py") else [run_clang_tidy]
+    rct_command += ["-p", build, "-j", str(args.jobs), "-checks=" + args.checks, "-header-filter=" + header_filter,
+                    "-clang-tidy-binary", args.clang_tidy, "-quiet"]
+    samples = {}
+    findings = {}
+
+    def record(key, sample, count):
+        samples.setdefault(key, []).append(sample)
+        findings[key] = count
+        print("%-32s %-5s %8.2fs wall %8.2fs cpu %8.1f MB peak  %s findings" % (
+            key[0] + ("" if key[1] == "-" else " " + key[1]), key[2], sample["wallSec"], sample["cpuSec"],
+            sample["peakTreeRssMB"] or sample["maxProcessRssMB"], count), file=sys.stderr)
+
+    for run in range(args.runs):
+        for state in ("cold", "warm"):
+            sample = measure(rct_command, project)
+            record(("run-clang-tidy", "-", state), sample, text_findings(sample["stdout"]))
+        for variant in variants:
+            cache = os.path.join(work, "cache-%s-%d" % (variant, run))
+            shutil.rmtree(cache, ignore_errors=True)
+            for state in ("cold", "warm"):
+                out_dir = os.path.join(work, "out-%s" % variant)
+                command = ["node", args.ctv, "run", "--root", project, "-p", os.path.join(build, "compile_commands.json"),
+                           "-j", str(args.jobs), "--checks", args.checks, "--header-filter", header_filter,
+                           "--clang-tidy", args.clang_tidy, "--cache", cache, "--out", out_dir, "--format", "json",
+                           "--quiet"] + VARIANTS[variant]
+                sample = measure(command, project)
+                record(("ctv", variant, state), sample, ctv_findings(out_dir))
+
+    results = [summarize(tool, variant, state, runs, findings[(tool, variant, state)])
+               for (tool, variant, state), runs in samples.items()]
+    baseline = {r["cache"]: r["wallSec"]["median"] for r in results if r["tool"] == "run-clang-tidy"}
+    speedup = {"%s/%s" % (r["variant"], r["cache"]): round(baseline[r["cache"]] / r["wallSec"]["median"], 2)
+               for r in results if r["tool"] == "ctv" and r["wallSec"]["median"]}
+    version = subprocess.run([args.clang_tidy, "--version"], capture_output=True, text=True).stdout.strip()
+    document = {
+        "benchmark": "head-to-head",
+        "version": 1,
+        "createdAt": time.strftime("%Y-%m-%dT%H:%M:%SZ", time.gmtime()),
+        "environment": {
+            "node": subprocess.run(["node", "--version"], capture_output=True, text=True).stdout.strip(),
+            "python": platform.python_version(),
+            "platform": "%s-%s" % (sys.platform, platform.machine()),
+            "cpus": os.cpu_count(),
+            "clangTidy": version.splitlines()[1].strip() if len(version.splitlines()) > 1 else version,
+        },
+        "parameters": {"units": units, "modules": args.modules, "jobs": args.jobs, "runs": args.runs,
+                       "checks": args.checks, "variants": variants},
+        "results": results,
+        # run-clang-tidy wall time divided by ctv's, per ctv variant and state
+        "speedup": speedup,
+    }
+    text = json.dumps(document, indent=2) + "\n"
+    if args.out:
+        with open(args.out, "w", encoding="utf-8") as f:
+            f.write(text)
+        print("Results written to %s" % args.out, file=sys.stderr)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == "__main__":
+    main()
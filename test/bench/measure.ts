@@ -0,0 +1,186 @@
+// Benchmark measurement - Timed sections with heap peaks and the GC time falling into them
+import * as os from 'os';
+import * as v8 from 'v8';
+import { PerformanceObserver, performance } from 'perf_hooks';
+
+export interface StageResult {
+  stage: string;
+  size: number;
+  runs: number;
+  wallMs: { median: number; min: number };
+  // Input (or, for rendering, output) bytes per second
+  mbPerSec?: number;
+  // Diagnostics per second
+  opsPerSec: number;
+  heapPeakMB: number;
+  gcMs: number;
+  skipped?: string;
+}
+
+export interface BenchFile {
+  benchmark: string;
+  version: number;
+  createdAt: string;
+  environment: { node: string; platform: string; cpus: number; cpuModel: string; memoryGB: number };
+  parameters: Record<string, unknown>;
+  results: unknown[];
+}
+
+/**
+ * Accumulates the time spent in timed sections of one run, with the heap peak at their ends
+ * and the garbage collections that started inside them
+ */
+export class Timer {
+  private windows: Array<[number, number]> = [];
+  private heapPeak = 0;
+
+  time<T>(section: () => T): T {
+    const start = performance.now();
+    const value = section();
+    this.windows.push([start, performance.now()]);
+    this.heapPeak = Math.max(this.heapPeak, v8.getHeapStatistics().used_heap_size);
+    return value;
+  }
+
+  async timeAsync<T>(section: () => Promise<T>): Promise<T> {
+    const start = performance.now();
+    const value = await section();
+    this.windows.push([start, performance.now()]);
+    this.heapPeak = Math.max(this.heapPeak, v8.getHeapStatistics().used_heap_size);
+    return value;
+  }
+
+  elapsed(): number {
+    return this.windows.reduce((sum, [start, end]) => sum + end - start, 0);
+  }
+
+  peak(): number {
+    return this.heapPeak;
+  }
+
+  gcTime(entries: Array<{ startTime: number; duration: number }>): number {
+    // Windows are in order, so a binary search finds the one an entry could fall into
+    let total = 0;
+    for (const entry of entries) {
+      let low = 0;
+      let high = this.windows.length - 1;
+      while (low <= high) {
+        const middle = (low + high) >> 1;
+        if (this.windows[middle][1] < entry.startTime) {
+          low = middle + 1;
+        } else {
+          high = middle - 1;
+        }
+      }
+      if (low < this.windows.length && this.windows[low][0] <= entry.startTime) {
+        total += entry.duration;
+      }
+    }
+    return total;
+  }
+}
+
+/**
+ * Run a stage `runs` times and summarize it. Each run gets a fresh timer and reports how many
+ * bytes and diagnostics it processed; with --expose-gc the heap is collected between runs.
+ */
+export async function measure(
+  stage: string,
+  size: number,
+  runs: number,
+  run: (timer: Timer) => Promise<{ bytes?: number; ops: number }>
+): Promise<StageResult> {
+  const gcEntries: Array<{ startTime: number; duration: number }> = [];
+  const observer = new PerformanceObserver(list => {
+    list.getEntries().forEach(entry => gcEntries.push({ startTime: entry.startTime, duration: entry.duration }));
+  });
+  observer.observe({ entryTypes: ['gc'] });
+
+  const samples: Array<{ ms: number; bytes?: number; ops: number; peak: number; gcMs: number }> = [];
+  for (let i = 0; i < runs; i++) {
+    collectGarbage();
+    const baseline = v8.getHeapStatistics().used_heap_size;
+    const timer = new Timer();
+    const { bytes, ops } = await run(timer);
+    // GC entries are delivered asynchronously, on a later turn of the event loop
+    await new Promise(resolve => setTimeout(resolve, 20));
+    samples.push({ ms: timer.elapsed(), bytes, ops, peak: Math.max(0, timer.peak() - baseline), gcMs: timer.gcTime(gcEntries) });
+    gcEntries.length = 0;
+  }
+  observer.disconnect();
+
+  const sorted = [...samples].sort((a, b) => a.ms - b.ms);
+  const median = sorted[Math.floor(sorted.length / 2)];
+  return {
+    stage,
+    size,
+    runs,
+    wallMs: { median: round(median.ms), min: round(sorted[0].ms) },
+    mbPerSec: median.bytes !== undefined ? round(median.bytes / 1048576 / (median.ms / 1000)) : undefined,
+    opsPerSec: Math.round(median.ops / (median.ms / 1000)),
+    heapPeakMB: round(Math.max(...samples.map(sample => sample.peak)) / 1048576),
+    gcMs: round(median.gcMs)
+  };
+}
+
+export function skipped(stage: string, size: number, reason: string): StageResult {
+  return { stage, size, runs: 0, wallMs: { median: 0, min: 0 }, opsPerSec: 0, heapPeakMB: 0, gcMs: 0, skipped: reason };
+}
+
+export function collectGarbage(): void {
+  const gc = (global as unknown as { gc?: () => void }).gc;
+  if (gc) {
+    gc();
+  }
+}
+
+export function environment(): BenchFile['environment'] {
+  return {
+    node: process.version,
+    platform: `${process.platform}-${process.arch}`,
+    cpus: os.cpus().length,
+    cpuModel: os.cpus()[0]?.model || '',
+    memoryGB: round(os.totalmem() / 1073741824)
+  };
+}
+
+/**
+ * "10k", "1M" or "2500" as a number
+ */
+export function parseCount(spec: string): number {
+  const match = /^(\d+(?:\.\d+)?)([kKmM]?)$/.exec(spec.trim());
+  if (!match) {
+    throw new Error(`Invalid count '${spec}'`);
+  }
+  const scale = match[2].toLowerCase() === 'k' ? 1e3 : match[2].toLowerCase() === 'm' ? 1e6 : 1;
+  return Math.round(parseFloat(match[1]) * scale);
+}
+
+/**
+ * Minimal "--name value" / "--flag" parser for the benchmark scripts
+ */
+export function benchArgs(argv: string[]): Record<string, string> {
+  const args: Record<string, string> = {};
+  for (let i = 0; i < argv.length; i++) {
+    if (argv[i].startsWith('--')) {
+      const next = argv[i + 1];
+      args[argv[i].substring(2)] = next !== undefined && !next.startsWith('--') ? argv[++i] : 'true';
+    }
+  }
+  return args;
+}
+
+export function round(value: number): number {
+  return Math.round(value * 100) / 100;
+}
+
+/**
+ * Nearest-rank percentile (0-100) of unsorted values; 0 for none
+ */
+export function percentile(values: number[], p: number): number {
+  if (values.length === 0) {
+    return 0;
+  }
+  const sorted = [...values].sort((a, b) => a - b);
+  return sorted[Math.min(sorted.length - 1, Math.max(0, Math.ceil(p / 100 * sorted.length) - 1))];
+}
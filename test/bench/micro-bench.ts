@@ -0,0 +1,151 @@
+// Microbenchmarks - Throughput of parsing, aggregation and report rendering on synthetic clang-tidy output
+//
+//   npm run bench -- --sizes 10k,100k,1M --runs 5 --out bench-results.json
+//
+// Only the parser, aggregation and rendering calls are timed; generating the synthetic output is not.
+// Parse stages stream the output unit by unit, so they scale to 10M diagnostics; aggregation and
+// rendering need every diagnostic in memory at once and are skipped above --max-aggregate / --max-render.
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import { TextParser } from '../../src/core/parser/TextParser';
+import { JsonParser } from '../../src/core/parser/JsonParser';
+import { DiagnosticCaps } from '../../src/core/parser/DiagnosticCaps';
+import { AnalysisEngine } from '../../src/core/engine/AnalysisEngine';
+import { HtmlReporter } from '../../src/core/reporter/HtmlReporter';
+import { ClangTidyDiagnostic } from '../../src/types';
+import { logger } from '../../src/utils/logger';
+import { SyntheticOutput } from './synthetic-output';
+import { BenchFile, StageResult, benchArgs, environment, measure, parseCount, skipped } from './measure';
+
+const STAGES = ['text-parse', 'text-parse-capped', 'json-parse', 'aggregate', 'render-html'];
+
+async function main(): Promise<void> {
+  const args = benchArgs(process.argv.slice(2));
+  const sizes = (args['sizes'] || '10k,100k,1M').split(',').map(parseCount);
+  const stages = args['stages'] ? args['stages'].split(',') : STAGES;
+  const runs = parseInt(args['runs'] || '5', 10);
+  const seed = parseInt(args['seed'] || '1', 10);
+  const maxAggregate = parseCount(args['max-aggregate'] || '250k');
+  const maxRender = parseCount(args['max-render'] || '100k');
+  const unknown = stages.filter(stage => !STAGES.includes(stage));
+  if (unknown.length > 0) {
+    throw new Error(`Unknown stage(s) ${unknown.join(', ')}; expected ${STAGES.join(', ')}`);
+  }
+
+  logger.setLogLevel('error');
+  const root = path.join(os.tmpdir(), `ctv-bench-${seed}`);
+  const synthetic = () => new SyntheticOutput({ root, seed });
+  synthetic().writeSources();
+
+  const results: StageResult[] = [];
+  for (const size of sizes) {
+    for (const stage of stages) {
+      const limit = stage === 'aggregate' ? maxAggregate : stage === 'render-html' ? maxRender : Infinity;
+      const result = size > limit
+        ? skipped(stage, size, `above --max-${stage === 'aggregate' ? 'aggregate' : 'render'} ${limit}`)
+        : await runStage(stage, size, runs, synthetic);
+      results.push(result);
+      printRow(result);
+    }
+  }
+
+  const file: BenchFile = {
+    benchmark: 'micro',
+    version: 1,
+    createdAt: new Date().toISOString(),
+    environment: environment(),
+    parameters: { sizes, stages, runs, seed, maxAggregate, maxRender, exposeGc: typeof (global as unknown as { gc?: unknown }).gc === 'function' },
+    results
+  };
+  if (args['out']) {
+    fs.writeFileSync(args['out'], JSON.stringify(file, null, 2) + '\n');
+    process.stderr.write(`Results written to ${args['out']}\n`);
+  } else {
+    process.stdout.write(JSON.stringify(file, null, 2) + '\n');
+  }
+}
+
+function runStage(stage: string, size: number, runs: number, synthetic: () => SyntheticOutput): Promise<StageResult> {
+  switch (stage) {
+    case 'text-parse':
+    case 'text-parse-capped':
+      return measure(stage, size, runs, async timer => {
+        const parser = new TextParser();
+        const caps = stage === 'text-parse-capped' ? new DiagnosticCaps(10000, 1000) : undefined;
+        let bytes = 0;
+        let ops = 0;
+        for (const unit of synthetic().units(size)) {
+          const text = SyntheticOutput.toText(unit);
+          bytes += Buffer.byteLength(text);
+          if (caps) {
+            caps.startUnit();
+          }
+          timer.time(() => parser.parseClangTidyText(text, caps));
+          ops += unit.length;
+        }
+        return { bytes, ops };
+      });
+    case 'json-parse':
+      return measure(stage, size, runs, async timer => {
+        const parser = new JsonParser();
+        let bytes = 0;
+        let ops = 0;
+        for (const unit of synthetic().units(size)) {
+          const json = SyntheticOutput.toJson(unit);
+          bytes += Buffer.byteLength(json);
+          timer.time(() => parser.parseClangTidyJson(json));
+          ops += unit.length;
+        }
+        return { bytes, ops };
+      });
+    case 'aggregate': {
+      const diagnostics = parseAll(size, synthetic);
+      return measure(stage, size, runs, async timer => {
+        timer.time(() => AnalysisEngine.buildReportData(diagnostics, diagnostics.length));
+        return { ops: diagnostics.length };
+      });
+    }
+    default: {
+      const diagnostics = parseAll(size, synthetic);
+      const reportData = AnalysisEngine.buildReportData(diagnostics, diagnostics.length);
+      const reporter = new HtmlReporter();
+      // Throughput of rendering is reported in bytes of HTML produced
+      return measure(stage, size, runs, async timer => {
+        const html = await timer.timeAsync(() => reporter.generateReport(reportData, { includeCharts: true }));
+        return { bytes: Buffer.byteLength(html), ops: diagnostics.length };
+      });
+    }
+  }
+}
+
+function parseAll(size: number, synthetic: () => SyntheticOutput): ClangTidyDiagnostic[] {
+  const parser = new TextParser();
+  const diagnostics: ClangTidyDiagnostic[] = [];
+  for (const unit of synthetic().units(size)) {
+    for (const diag of parser.parseClangTidyText(SyntheticOutput.toText(unit))) {
+      diagnostics.push(diag);
+    }
+  }
+  return diagnostics;
+}
+
+function printRow(result: StageResult): void {
+  const columns = result.skipped
+    ? [result.stage.padEnd(18), String(result.size).padStart(9), `skipped (${result.skipped})`]
+    : [
+      result.stage.padEnd(18),
+      String(result.size).padStart(9),
+      `${result.wallMs.median.toFixed(1).padStart(10)} ms`,
+      `${(result.mbPerSec !== undefined ? result.mbPerSec.toFixed(1) : '-').padStart(8)} MB/s`,
+      `${String(result.opsPerSec).padStart(10)} diag/s`,
+      `heap ${result.heapPeakMB.toFixed(1).padStart(7)} MB`,
+      `gc ${result.gcMs.toFixed(1).padStart(7)} ms`
+    ];
+  process.stderr.write(columns.join('  ') + '\n');
+}
+
+main().catch(error => {
+  process.stderr.write(`${error instanceof Error ? error.message : String(error)}\n`);
+  process.exit(1);
+});
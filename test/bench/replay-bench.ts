@@ -0,0 +1,110 @@
+// Replay benchmark - Runs a recorded trace through the whole host pipeline without clang-tidy
+//
+//   ctv run --record run.trace.gz src
+//   npm run bench:replay -- --trace run.trace.gz --timing recorded,none --runs 5 --out replay.json
+//
+// The runner, its translation units and the scheduler are rebuilt from the settings in the trace, and
+// every recorded execution is replayed: with "recorded" timing each one takes as long as it did, so the
+// makespan shows the scheduling of the recorded costs; with "none" it returns at once, which leaves the
+// host's own costs (spawning, pipes, parsing, aggregation). Rendering the report is measured separately.
+import * as fs from 'fs';
+import * as path from 'path';
+import { AnalysisEngine } from '../../src/core/engine/AnalysisEngine';
+import { HtmlReporter } from '../../src/core/reporter/HtmlReporter';
+import { ClangTidyRunner } from '../../src/core/runner/ClangTidyRunner';
+import { ReplayTiming, TraceHeader, TraceReplayer } from '../../src/core/runner/RunTrace';
+import { Scheduler } from '../../src/core/runner/Scheduler';
+import { CliOptions, CliSettings } from '../../src/cli/CliSettings';
+import { ReportData } from '../../src/types';
+import { logger } from '../../src/utils/logger';
+import { BenchFile, StageResult, benchArgs, environment, measure } from './measure';
+
+async function main(): Promise<void> {
+  const args = benchArgs(process.argv.slice(2));
+  if (!args['trace']) {
+    throw new Error('Usage: replay-bench --trace <file> [--timing recorded,none] [--runs <n>] [--jobs <n>] [--out <file>]');
+  }
+  const tracePath = path.resolve(args['trace']);
+  const runs = parseInt(args['runs'] || '3', 10);
+  const timings = (args['timing'] || 'recorded,none').split(',') as ReplayTiming[];
+  const { header, records } = TraceReplayer.read(tracePath);
+  const jobs = args['jobs'] ? parseInt(args['jobs'], 10) : header.jobs;
+  const recordedMakespan = records.reduce((end, record) => Math.max(end, record.start + record.duration), 0);
+
+  logger.setLogLevel('error');
+  const results: StageResult[] = [];
+  let reportData: ReportData | null = null;
+  for (const timing of timings) {
+    results.push(await measure(`replay-${timing}`, header.files.length, runs, async timer => {
+      const runner = createRunner(header, jobs);
+      const replayer = TraceReplayer.load(tracePath, Scheduler.getInstance(), timing);
+      runner.setExecutor(replayer);
+      const outcome = await timer.timeAsync(() => new AnalysisEngine(runner).analyze(header.files, header.options));
+      replayer.dispose();
+      reportData = outcome.reportData;
+      return { ops: outcome.diagnostics.length };
+    }));
+    report(results[results.length - 1]);
+  }
+  if (reportData) {
+    const data: ReportData = reportData;
+    const reporter = new HtmlReporter();
+    results.push(await measure('render-html', header.files.length, runs, async timer => {
+      const html = await timer.timeAsync(() => reporter.generateReport(data, { includeCharts: true }));
+      return { bytes: Buffer.byteLength(html), ops: data.diagnostics.length };
+    }));
+    report(results[results.length - 1]);
+  }
+
+  const file: BenchFile = {
+    benchmark: 'replay',
+    version: 1,
+    createdAt: new Date().toISOString(),
+    environment: environment(),
+    parameters: {
+      trace: tracePath,
+      recordedAt: header.createdAt,
+      clangTidyVersion: header.clangTidyVersion,
+      files: header.files.length,
+      executions: records.length,
+      recordedMakespanMs: recordedMakespan,
+      recordedJobs: header.jobs,
+      jobs,
+      runs,
+      timings
+    },
+    results
+  };
+  if (args['out']) {
+    fs.writeFileSync(args['out'], JSON.stringify(file, null, 2) + '\n');
+    process.stderr.write(`Results written to ${args['out']}\n`);
+  } else {
+    process.stdout.write(JSON.stringify(file, null, 2) + '\n');
+  }
+}
+
+/**
+ * Runner configured like the recorded one, so its files resolve into the recorded translation units
+ */
+function createRunner(header: TraceHeader, jobs: number): ClangTidyRunner {
+  const settings = header.settings as unknown as CliOptions;
+  return new ClangTidyRunner(new CliSettings({
+    ...settings,
+    root: header.root,
+    compileCommandsPath: header.compileCommands,
+    jobs,
+    // Cache hits would skip the replay; shared caches are not the host's to touch
+    cacheDirectory: undefined,
+    remoteCache: undefined
+  }));
+}
+
+function report(result: StageResult): void {
+  process.stderr.write(`${result.stage.padEnd(16)} ${String(result.size).padStart(7)} files  ` +
+    `median ${String(result.wallMs.median).padStart(9)} ms  ${String(result.opsPerSec).padStart(10)} diag/s  gc ${result.gcMs} ms\n`);
+}
+
+main().catch(error => {
+  process.stderr.write(`${error instanceof Error ? error.message : String(error)}\n`);
+  process.exit(1);
+});
@@ -0,0 +1,203 @@
+// Scheduler benchmark - Drives ClangTidyRunner through the fake clang-tidy with heavy-tailed workloads
+//
+//   npm run bench:scheduler -- --files 400 --jobs 4,8 --distribution pareto --unity 0,8 --out scheduler.json
+//
+// Each configuration (job count x unity batch size x command rewriting x submission order) analyzes a
+// synthetic project with the real runner, scheduler and parser, while the stub spends the modelled time.
+// The scheduler runs tasks of one priority class first come, first served, so the strategies compared
+// are the orders files are submitted in. Reported per configuration: makespan, its lower bound
+// (the busy time spread over all workers, or the longest unit if that is longer), worker utilization,
+// and the distribution of the time until each file's findings are available.
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import { performance } from 'perf_hooks';
+import { ClangTidyRunner } from '../../src/core/runner/ClangTidyRunner';
+import { CliSettings } from '../../src/cli/CliSettings';
+import { logger } from '../../src/utils/logger';
+import { DEFAULT_MODEL, MODEL_VARIABLE, Workload, WorkloadModel } from './workload';
+import { BenchFile, benchArgs, environment, percentile, round } from './measure';
+
+const STRATEGIES = ['input-order', 'random', 'longest-first', 'shortest-first'];
+// Flags the compile command rewriter strips, after some it keeps
+const COMPILE_FLAGS = '-std=c++17 -O2 -g -ffunction-sections -fdata-sections -fprofile-arcs -ftest-coverage -MD -MF deps.d';
+
+interface SchedulerResult {
+  jobs: number;
+  unity: number;
+  rewrite: boolean;
+  strategy: string;
+  units: number;
+  makespanMs: number;
+  lowerBoundMs: number;
+  utilization: number;
+  latencyMs: { p50: number; p90: number; p99: number; max: number };
+  crashed: number;
+}
+
+async function main(): Promise<void> {
+  const args = benchArgs(process.argv.slice(2));
+  const fileCount = parseInt(args['files'] || '200', 10);
+  const jobsList = (args['jobs'] || String(os.cpus().length)).split(',').map(jobs => parseInt(jobs, 10));
+  const unityList = (args['unity'] || '0').split(',').map(size => parseInt(size, 10));
+  const rewriteList = (args['rewrite'] || 'on').split(',').map(value => value === 'on');
+  const strategies = args['strategies'] ? args['strategies'].split(',') : STRATEGIES;
+  const model: WorkloadModel = {
+    ...DEFAULT_MODEL,
+    seed: parseInt(args['seed'] || String(DEFAULT_MODEL.seed), 10),
+    distribution: (args['distribution'] || DEFAULT_MODEL.distribution) as WorkloadModel['distribution'],
+    meanMs: parseFloat(args['mean-ms'] || String(DEFAULT_MODEL.meanMs)),
+    mode: (args['mode'] || DEFAULT_MODEL.mode) as WorkloadModel['mode'],
+    memoryMB: parseFloat(args['memory-mb'] || String(DEFAULT_MODEL.memoryMB)),
+    crashRate: parseFloat(args['crash-rate'] || '0'),
+    hangRate: parseFloat(args['hang-rate'] || '0'),
+    hangMs: parseFloat(args['hang-ms'] || String(DEFAULT_MODEL.hangMs))
+  };
+  const unknown = strategies.filter(strategy => !STRATEGIES.includes(strategy));
+  if (unknown.length > 0) {
+    throw new Error(`Unknown strategy(s) ${unknown.join(', ')}; expected ${STRATEGIES.join(', ')}`);
+  }
+
+  logger.setLogLevel('error');
+  const root = path.join(os.tmpdir(), `ctv-scheduler-bench-${model.seed}-${fileCount}`);
+  const files = writeProject(root, fileCount);
+  const stub = writeStubLauncher(root);
+  process.env[MODEL_VARIABLE] = JSON.stringify(model);
+  const workload = new Workload(model);
+
+  const results: SchedulerResult[] = [];
+  for (const jobs of jobsList) {
+    for (const unity of unityList) {
+      for (const rewrite of rewriteList) {
+        for (const strategy of strategies) {
+          const result = await runConfiguration(root, stub, order(files, strategy, workload), { jobs, unity, rewrite, strategy });
+          results.push(result);
+          process.stderr.write(`jobs ${String(jobs).padStart(3)}  unity ${String(unity).padStart(2)}  rewrite ${rewrite ? 'on ' : 'off'}  ` +
+            `${strategy.padEnd(14)}  makespan ${String(result.makespanMs).padStart(8)} ms (bound ${result.lowerBoundMs})  ` +
+            `util ${result.utilization.toFixed(2)}  p50 ${result.latencyMs.p50}  p99 ${result.latencyMs.p99}  crashed ${result.crashed}\n`);
+        }
+      }
+    }
+  }
+
+  const file: BenchFile = {
+    benchmark: 'scheduler',
+    version: 1,
+    createdAt: new Date().toISOString(),
+    environment: environment(),
+    parameters: { files: fileCount, jobs: jobsList, unity: unityList, rewrite: rewriteList, strategies, model },
+    results
+  };
+  if (args['out']) {
+    fs.writeFileSync(args['out'], JSON.stringify(file, null, 2) + '\n');
+    process.stderr.write(`Results written to ${args['out']}\n`);
+  } else {
+    process.stdout.write(JSON.stringify(file, null, 2) + '\n');
+  }
+}
+
+async function runConfiguration(
+  root: string,
+  stub: string,
+  files: string[],
+  configuration: Pick<SchedulerResult, 'jobs' | 'unity' | 'rewrite' | 'strategy'>
+): Promise<SchedulerResult> {
+  const runner = new ClangTidyRunner(new CliSettings({
+    root,
+    clangTidyPath: stub,
+    compileCommandsPath: 'compile_commands.json',
+    checks: 'readability-*,modernize-*,bugprone-*,performance-*',
+    headerFilter: '',
+    extraArgs: [],
+    jobs: configuration.jobs,
+    keepCompileFlags: !configuration.rewrite,
+    unityBatchSize: configuration.unity
+  }));
+  const completions: number[] = [];
+  let busy = 0;
+  let longest = 0;
+  let units = 0;
+  let crashed = 0;
+  const start = performance.now();
+  await runner.runParallel(files, {}, undefined, result => {
+    const at = performance.now() - start;
+    // A unity batch makes all of its files available at once
+    result.files.forEach(() => completions.push(at));
+    busy += result.duration;
+    longest = Math.max(longest, result.duration);
+    units++;
+    if (result.exitCode !== 0) {
+      crashed++;
+    }
+  });
+  const makespan = performance.now() - start;
+  return {
+    ...configuration,
+    units,
+    makespanMs: Math.round(makespan),
+    lowerBoundMs: Math.round(Math.max(busy / configuration.jobs, longest)),
+    utilization: round(busy / (makespan * configuration.jobs)),
+    latencyMs: {
+      p50: Math.round(percentile(completions, 50)),
+      p90: Math.round(percentile(completions, 90)),
+      p99: Math.round(percentile(completions, 99)),
+      max: Math.round(percentile(completions, 100))
+    },
+    crashed
+  };
+}
+
+/**
+ * Submission order of a strategy. Cost-based orders use the model's costs, standing in for an exact cost history.
+ */
+function order(files: string[], strategy: string, workload: Workload): string[] {
+  const cost = (file: string) => workload.unitCost([file]);
+  switch (strategy) {
+    case 'random':
+      return [...files].sort((a, b) => workload.uniform(a, 'order') - workload.uniform(b, 'order'));
+    case 'longest-first':
+      return [...files].sort((a, b) => cost(b) - cost(a));
+    case 'shortest-first':
+      return [...files].sort((a, b) => cost(a) - cost(b));
+    default:
+      return files;
+  }
+}
+
+/**
+ * Sources spread over a few directories, sharing one header, with a compile database; the sources are small
+ * and free of unity hazards, so every directory can be batched
+ */
+function writeProject(root: string, count: number): string[] {
+  fs.mkdirSync(path.join(root, 'include'), { recursive: true });
+  fs.writeFileSync(path.join(root, 'include', 'common.h'), '#pragma once\n#include <vector>\n\nint clampValue(int value, int limit);\n');
+  const files: string[] = [];
+  const entries: Array<{ directory: string; command: string; file: string }> = [];
+  for (let i = 0; i < count; i++) {
+    const file = path.join(root, 'src', `module${i % 16}`, `file${i}.cpp`);
+    const body = Array.from({ length: 12 }, (_, line) => `  total += values[${line}] * ${line + 3};`).join('\n');
+    fs.mkdirSync(path.dirname(file), { recursive: true });
+    fs.writeFileSync(file, `#include "common.h"\n\nint compute${i}(const std::vector<int> &values) {\n  int total = 0;\n${body}\n  return clampValue(total, 1024);\n}\n`);
+    files.push(file);
+    entries.push({ directory: root, command: `c++ ${COMPILE_FLAGS} -I${path.join(root, 'include')} -c ${file} -o ${file}.o`, file });
+  }
+  fs.writeFileSync(path.join(root, 'compile_commands.json'), JSON.stringify(entries, null, 2));
+  return files;
+}
+
+/**
+ * Executable starting the stub with this Node.js, so the runner can spawn it like clang-tidy
+ */
+function writeStubLauncher(root: string): string {
+  const stub = path.join(__dirname, 'fake-clang-tidy' + path.extname(__filename));
+  const node = [process.execPath, ...process.execArgv].map(arg => `"${arg}"`).join(' ');
+  const launcher = path.join(root, 'bin', 'clang-tidy');
+  fs.mkdirSync(path.dirname(launcher), { recursive: true });
+  fs.writeFileSync(launcher, `#!/bin/sh\nexec ${node} "${stub}" "$@"\n`, { mode: 0o755 });
+  return launcher;
+}
+
+main().catch(error => {
+  process.stderr.write(`${error instanceof Error ? error.message : String(error)}\n`);
+  process.exit(1);
+});
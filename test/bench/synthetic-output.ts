@@ -0,0 +1,216 @@
+// Synthetic clang-tidy output - Deterministic, production-shaped output of many translation units for benchmarks
+import * as fs from 'fs';
+import * as path from 'path';
+
+// Check names with message templates, most frequent first ({id} and {num} are filled in)
+export const CHECKS: Array<[string, string]> = [
+  ['readability-identifier-length', "variable name '{id}' is too short, expected at least 3 characters"],
+  ['readability-magic-numbers', '{num} is a magic number; consider replacing it with a named constant'],
+  ['modernize-use-trailing-return-type', 'use a trailing return type for this function'],
+  ['readability-braces-around-statements', 'statement should be inside braces'],
+  ['cppcoreguidelines-avoid-magic-numbers', '{num} is a magic number; consider replacing it with a named constant'],
+  ['readability-implicit-bool-conversion', "implicit conversion 'int' -> 'bool'"],
+  ['modernize-use-nullptr', 'use nullptr'],
+  ['google-readability-casting', 'C-style casts are discouraged; use static_cast'],
+  ['misc-include-cleaner', 'no header providing "std::{id}" is directly included'],
+  ['performance-unnecessary-value-param', "the parameter '{id}' is copied for each invocation but only used as a const reference; consider making it a const reference"],
+  ['bugprone-narrowing-conversions', "narrowing conversion from 'long' to signed type 'int' is implementation-defined"],
+  ['misc-unused-parameters', "parameter '{id}' is unused"],
+  ['modernize-use-auto', 'use auto when initializing with a cast to avoid duplicating the type name'],
+  ['readability-function-cognitive-complexity', "function '{id}' has cognitive complexity of {num} (threshold 25)"],
+  ['cppcoreguidelines-pro-type-reinterpret-cast', 'do not use reinterpret_cast'],
+  ['hicpp-signed-bitwise', 'use of a signed integer operand with a binary bitwise operator'],
+  ['bugprone-easily-swappable-parameters', "2 adjacent parameters of '{id}' of similar type ('int') are easily swapped by mistake"],
+  ['readability-else-after-return', "do not use 'else' after 'return'"],
+  ['modernize-loop-convert', 'use range-based for loop instead'],
+  ['performance-for-range-copy', "loop variable is copied but only used as const reference; consider making it a const reference"],
+  ['clang-analyzer-core.NullDereference', "Dereference of null pointer (loaded from variable '{id}')"],
+  ['bugprone-use-after-move', "'{id}' used after it was moved"],
+  ['clang-diagnostic-unused-variable', "unused variable '{id}'"]
+];
+const IDENTIFIERS = ['i', 'x', 'it', 'buf', 'ctx', 'value', 'result', 'node', 'vector', 'string', 'parseHeader', 'onResult'];
+const CODE = [
+  '    for (int i = 0; i < count; i++) {',
+  '    auto *node = (Node*)malloc(sizeof(Node));',
+  '    if (value) return process(value, 42);',
+  '    std::string result = buildName(prefix, id);',
+  '  int compute(int a, int b) {',
+  '    total += items[i] * 1024;'
+];
+// Lines per generated source; clang-tidy pads line numbers to five columns
+const SOURCE_LINES = 400;
+// Share of diagnostics in headers, which every TU including them reports again
+const HEADER_SHARE = 0.2;
+
+export interface SyntheticOptions {
+  // Directory the generated sources live in
+  root: string;
+  seed?: number;
+  // Distinct main sources; translation units beyond this reuse them
+  sources?: number;
+  headers?: number;
+  // Mean diagnostics per translation unit (Pareto distributed, so a few units are very noisy)
+  meanPerUnit?: number;
+}
+
+export interface SyntheticDiagnostic {
+  file: string;
+  line: number;
+  column: number;
+  severity: 'warning' | 'error';
+  check: string;
+  message: string;
+  code: string;
+  fix?: string;
+  note?: string;
+}
+
+export class SyntheticOutput {
+  private random: () => number;
+  private sources: string[];
+  private headers: string[];
+  private meanPerUnit: number;
+  private checkWeights: number[];
+
+  constructor(private options: SyntheticOptions) {
+    this.random = SyntheticOutput.mulberry32(options.seed ?? 1);
+    this.meanPerUnit = options.meanPerUnit ?? 100;
+    // Directories and files are skewed too: a few modules hold most of the code
+    this.sources = Array.from({ length: options.sources ?? 500 }, (_, index) =>
+      path.join(options.root, 'src', `module${this.skewed(24)}`, `part${index % 7}`, `file${index}.cpp`));
+    this.headers = Array.from({ length: options.headers ?? 60 }, (_, index) =>
+      path.join(options.root, 'include', `module${index % 24}`, `header${index}.h`));
+    this.checkWeights = CHECKS.map((_, index) => 1 / Math.pow(index + 1, 1.1));
+  }
+
+  /**
+   * Write the sources and headers the diagnostics point at, so parsers can read their lines
+   */
+  writeSources(): void {
+    for (const file of [...this.sources, ...this.headers]) {
+      if (fs.existsSync(file)) {
+        continue;
+      }
+      fs.mkdirSync(path.dirname(file), { recursive: true });
+      const lines = Array.from({ length: SOURCE_LINES }, (_, index) => CODE[index % CODE.length]);
+      fs.writeFileSync(file, lines.join('\n') + '\n');
+    }
+  }
+
+  /**
+   * Diagnostics of translation units until `total` diagnostics have been produced.
+   * Unit sizes follow a Pareto distribution (alpha 1.5) with the configured mean.
+   */
+  *units(total: number): Generator<SyntheticDiagnostic[]> {
+    let produced = 0;
+    let index = 0;
+    while (produced < total) {
+      const size = Math.min(total - produced, this.unitSize());
+      yield this.unit(index++, size);
+      produced += size;
+    }
+  }
+
+  /**
+   * clang-tidy text output of a unit (stdout of one run)
+   */
+  static toText(diagnostics: SyntheticDiagnostic[]): string {
+    const lines: string[] = [];
+    for (const diag of diagnostics) {
+      lines.push(`${diag.file}:${diag.line}:${diag.column}: ${diag.severity}: ${diag.message} [${diag.check}]`);
+      lines.push(`${String(diag.line).padStart(5)} | ${diag.code}`);
+      lines.push(`      | ${' '.repeat(Math.max(0, diag.column - 1))}^~~~`);
+      if (diag.fix) {
+        lines.push(`      | ${' '.repeat(Math.max(0, diag.column - 1))}${diag.fix}`);
+      }
+      if (diag.note) {
+        lines.push(`${diag.file}:${diag.line + 1}:5: note: ${diag.note}`);
+        lines.push(`${String(diag.line + 1).padStart(5)} | ${diag.code}`);
+        lines.push('      |     ^');
+      }
+    }
+    return lines.join('\n') + '\n';
+  }
+
+  /**
+   * The same unit as -export-fixes data, in the JSON form JsonParser reads
+   */
+  static toJson(diagnostics: SyntheticDiagnostic[]): string {
+    return JSON.stringify([{
+      MainSourceFile: diagnostics[0]?.file || '',
+      Diagnostics: diagnostics.map(diag => ({
+        DiagnosticName: diag.check,
+        DiagnosticMessage: {
+          Message: diag.message,
+          FilePath: diag.file,
+          FileOffset: diag.line * 40 + diag.column,
+          Line: diag.line,
+          Column: diag.column,
+          Replacements: diag.fix ? [{ FilePath: diag.file, Offset: diag.line * 40 + diag.column, Length: 4, ReplacementText: diag.fix }] : []
+        },
+        Level: diag.severity === 'error' ? 'Error' : 'Warning'
+      }))
+    }]);
+  }
+
+  private unit(index: number, size: number): SyntheticDiagnostic[] {
+    const source = this.sources[index % this.sources.length];
+    const diagnostics: SyntheticDiagnostic[] = [];
+    for (let i = 0; i < size; i++) {
+      const inHeader = this.random() < HEADER_SHARE;
+      // Header diagnostics sit at fixed positions, so every unit including the header repeats them
+      const file = inHeader ? this.headers[this.skewed(this.headers.length)] : source;
+      const line = inHeader ? 1 + this.skewed(SOURCE_LINES) : 1 + Math.floor(this.random() * SOURCE_LINES);
+      const checkIndex = inHeader ? line % CHECKS.length : this.weighted(this.checkWeights);
+      const error = this.random() < 0.005;
+      const [check, template] = error ? ['clang-diagnostic-error', "use of undeclared identifier '{id}'"] : CHECKS[checkIndex];
+      diagnostics.push({
+        file,
+        line,
+        column: inHeader ? 5 : 1 + Math.floor(this.random() * 40),
+        severity: error ? 'error' : 'warning',
+        check,
+        message: template
+          .replace('{id}', IDENTIFIERS[Math.floor(this.random() * IDENTIFIERS.length)])
+          .replace('{num}', String(Math.floor(this.random() * 4096))),
+        code: CODE[(line - 1) % CODE.length],
+        fix: this.random() < 0.3 ? 'static_cast<int>( )' : undefined,
+        note: this.random() < 0.1 ? 'expanded from macro \'CHECK\'' : undefined
+      });
+    }
+    return diagnostics;
+  }
+
+  private unitSize(): number {
+    const alpha = 1.5;
+    const minimum = this.meanPerUnit * (alpha - 1) / alpha;
+    return Math.max(1, Math.min(200 * this.meanPerUnit, Math.round(minimum / Math.pow(1 - this.random(), 1 / alpha))));
+  }
+
+  private skewed(count: number): number {
+    return Math.min(count - 1, Math.floor(Math.pow(this.random(), 2) * count));
+  }
+
+  private weighted(weights: number[]): number {
+    const total = weights.reduce((sum, weight) => sum + weight, 0);
+    let target = this.random() * total;
+    for (let i = 0; i < weights.length; i++) {
+      target -= weights[i];
+      if (target <= 0) {
+        return i;
+      }
+    }
+    return weights.length - 1;
+  }
+
+  private static mulberry32(seed: number): () => number {
+    let state = seed >>> 0;
+    return () => {
+      state = (state + 0x6D2B79F5) >>> 0;
+      let t = state;
+      t = Math.imul(t ^ (t >>> 15), t | 1);
+      t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+      return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+    };
+  }
+}
@@ -0,0 +1,112 @@
+// Workload model - Deterministic per-file analysis costs, memory, findings and failures for the fake clang-tidy
+import * as crypto from 'crypto';
+import * as path from 'path';
+
+export interface WorkloadModel {
+  seed: number;
+  // Per-file cost distribution; lognormal and pareto are heavy-tailed like real translation units
+  distribution: 'lognormal' | 'pareto' | 'uniform';
+  meanMs: number;
+  // Share of a unit's cost spent parsing headers, paid once per unity batch
+  headerShare: number;
+  // sleep: wait out the cost; cpu: burn a core for it
+  mode: 'sleep' | 'cpu';
+  // Mean memory touched per unit, scaled with its cost
+  memoryMB: number;
+  diagnosticsPerUnit: number;
+  crashRate: number;
+  hangRate: number;
+  // How long a hanging unit stalls before it gives up
+  hangMs: number;
+}
+
+export const DEFAULT_MODEL: WorkloadModel = {
+  seed: 1,
+  distribution: 'lognormal',
+  meanMs: 200,
+  headerShare: 0.6,
+  mode: 'sleep',
+  memoryMB: 64,
+  diagnosticsPerUnit: 20,
+  crashRate: 0,
+  hangRate: 0,
+  hangMs: 30000
+};
+
+// Environment variable the harness passes the model to the stub in (JSON)
+export const MODEL_VARIABLE = 'FAKE_CLANG_TIDY_MODEL';
+
+// Longest cost relative to the mean, so one draw cannot stall a benchmark indefinitely
+const MAX_COST_FACTOR = 100;
+
+export class Workload {
+  constructor(public readonly model: WorkloadModel = DEFAULT_MODEL) {}
+
+  static fromEnvironment(): Workload {
+    const json = process.env[MODEL_VARIABLE];
+    return new Workload({ ...DEFAULT_MODEL, ...(json ? JSON.parse(json) : {}) });
+  }
+
+  /**
+   * Cost of analyzing a source on its own, split into header parsing and the source itself
+   */
+  costOf(file: string): { headerMs: number; bodyMs: number } {
+    const total = this.sample(this.uniform(file, 'cost'), this.uniform(file, 'cost2'));
+    return { headerMs: total * this.model.headerShare, bodyMs: total * (1 - this.model.headerShare) };
+  }
+
+  /**
+   * Cost of a translation unit made of several sources (a unity batch): headers are parsed once
+   */
+  unitCost(members: string[]): number {
+    const costs = members.map(member => this.costOf(member));
+    return Math.max(...costs.map(cost => cost.headerMs)) + costs.reduce((sum, cost) => sum + cost.bodyMs, 0);
+  }
+
+  crashes(file: string): boolean {
+    return this.uniform(file, 'crash') < this.model.crashRate;
+  }
+
+  hangs(file: string): boolean {
+    return this.uniform(file, 'hang') < this.model.hangRate;
+  }
+
+  /**
+   * Number of findings in a source, proportional to its cost
+   */
+  diagnosticsIn(file: string): number {
+    const { headerMs, bodyMs } = this.costOf(file);
+    return Math.round(this.model.diagnosticsPerUnit * (headerMs + bodyMs) / this.model.meanMs);
+  }
+
+  /**
+   * Uniform value in (0, 1) derived from the file and the seed, the same in the stub and the harness.
+   * Only the last two path components count, so costs do not depend on where the project lives.
+   */
+  uniform(file: string, purpose: string): number {
+    const name = path.basename(path.dirname(file)) + '/' + path.basename(file);
+    const digest = crypto.createHash('sha256').update(`${this.model.seed}\0${purpose}\0${name}`).digest();
+    return (digest.readUInt32LE(0) + 1) / 4294967297;
+  }
+
+  private sample(u: number, v: number): number {
+    const mean = this.model.meanMs;
+    let value: number;
+    switch (this.model.distribution) {
+      case 'pareto': {
+        const alpha = 1.3;
+        value = mean * (alpha - 1) / alpha / Math.pow(u, 1 / alpha);
+        break;
+      }
+      case 'uniform':
+        value = 2 * mean * u;
+        break;
+      default: {
+        const sigma = 1.2;
+        const normal = Math.sqrt(-2 * Math.log(u)) * Math.cos(2 * Math.PI * v);
+        value = Math.exp(Math.log(mean) - sigma * sigma / 2 + sigma * normal);
+      }
+    }
+    return Math.min(value, MAX_COST_FACTOR * mean);
+  }
+}
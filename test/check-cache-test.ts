@@ -0,0 +1,122 @@
+// Test script to verify CheckResultCache fingerprints check options and splits output by check
+import { CheckResultCache } from '../src/core/cache/CheckResultCache';
+
+// clang-tidy 17+ dumps CheckOptions as a mapping
+const mappingConfig = `---
+Checks: 'bugprone-*,readability-*'
+HeaderFilterRegex: 'src/.*'
+CheckOptions:
+  bugprone-argument-comment.StrictMode: 'false'
+  readability-identifier-naming.ClassCase: CamelCase
+  readability-identifier-naming.ClassPrefix: ''
+  StrictMode: 'true'
+SystemHeaders: false
+...
+`;
+
+// Older versions dump a list of key/value pairs
+const keyValueConfig = `---
+Checks: 'bugprone-*,readability-*'
+HeaderFilterRegex: 'src/.*'
+CheckOptions:
+  - key: bugprone-argument-comment.StrictMode
+    value: 'false'
+  - key: readability-identifier-naming.ClassCase
+    value: CamelCase
+  - key: readability-identifier-naming.ClassPrefix
+    value: ''
+  - key: StrictMode
+    value: 'true'
+SystemHeaders: false
+...
+`;
+
+const output = `/src/a.cpp:3:5: warning: the value returned by this function should not be disregarded [bugprone-unused-return-value,cert-err33-c]
+    3 |     fgets(buffer, 10, file);
+      |     ^~~~~~~~~~~~~~~~~~~~~~~
+/src/a.cpp:8:7: warning: invalid case style for class 'widget' [readability-identifier-naming]
+    8 | class widget {};
+      |       ^~~~~~
+      |       Widget
+/src/a.cpp:12:3: warning: 'x' used after it was moved [bugprone-use-after-move]
+   12 |   x.size();
+      |   ^
+/src/a.cpp:11:3: note: move occurred here
+   11 |   take(std::move(x));
+      |   ^
+/src/a.cpp:20:1: error: unknown type name 'foo' [clang-diagnostic-error]
+   20 | foo bar;
+      | ^
+/src/a.cpp:22:9: warning: unused variable 'y' [-Wunused-variable]
+   22 |     int y;
+      |         ^
+`;
+
+let failures = 0;
+
+function check(description: string, condition: boolean): void {
+    console.log(`${condition ? '✓' : '✗'} ${description}`);
+    if (!condition) {
+        failures++;
+    }
+}
+
+function runTest(): void {
+    console.log('Testing CheckResultCache...');
+    const enabled = ['bugprone-argument-comment', 'readability-identifier-naming', 'bugprone-use-after-move'];
+
+    const mapping = CheckResultCache.checkSet(enabled, mappingConfig);
+    const keyValue = CheckResultCache.checkSet(enabled, keyValueConfig);
+    check('mapping and key/value dumps give the same fingerprints', JSON.stringify(mapping) === JSON.stringify(keyValue));
+
+    const changedOption = CheckResultCache.checkSet(enabled, mappingConfig.replace('ClassCase: CamelCase', 'ClassCase: lower_case'));
+    check('changing an option changes the fingerprint of its check',
+        changedOption.checks['readability-identifier-naming'] !== mapping.checks['readability-identifier-naming']);
+    check('changing an option keeps the fingerprints of other checks',
+        changedOption.checks['bugprone-argument-comment'] === mapping.checks['bugprone-argument-comment'] &&
+        changedOption.checks['bugprone-use-after-move'] === mapping.checks['bugprone-use-after-move']);
+    check('changing an option keeps the global fingerprint', changedOption.global === mapping.global);
+
+    const changedGlobalOption = CheckResultCache.checkSet(enabled, mappingConfig.replace("  StrictMode: 'true'", "  StrictMode: 'false'"));
+    check('options without a check prefix change the global fingerprint only',
+        changedGlobalOption.global !== mapping.global &&
+        JSON.stringify(changedGlobalOption.checks) === JSON.stringify(mapping.checks));
+
+    const changedFilter = CheckResultCache.checkSet(enabled, mappingConfig.replace("'src/.*'", "'.*'"));
+    check('top-level settings change the global fingerprint', changedFilter.global !== mapping.global);
+
+    const changedChecks = CheckResultCache.checkSet(enabled, mappingConfig.replace("'bugprone-*,readability-*'", "'bugprone-*'"));
+    check('the Checks line is not part of the global fingerprint', changedChecks.global === mapping.global);
+
+    const blocks = CheckResultCache.splitOutput(output);
+    const alias = blocks.get('bugprone-unused-return-value') || [];
+    check('an alias block is listed under every check it names',
+        alias.length === 1 && JSON.stringify(blocks.get('cert-err33-c')) === JSON.stringify(alias));
+    check('source and fix lines stay with their diagnostic',
+        (blocks.get('readability-identifier-naming') || [''])[0].split('\n').length === 4);
+    const moved = (blocks.get('bugprone-use-after-move') || [''])[0];
+    check('notes belong to the diagnostic they follow', moved.includes('note: move occurred here') && moved.includes('take(std::move(x))'));
+    const compiler = blocks.get('clang-diagnostic') || [];
+    check('compiler errors and warnings are compiler blocks',
+        compiler.length === 2 && compiler[0].includes("unknown type name 'foo'") && compiler[1].includes("unused variable 'y'"));
+    check('every line of the output is kept', Array.from(blocks.entries())
+        .filter(([owner]) => owner !== 'cert-err33-c')
+        .reduce((total, [, list]) => total + list.reduce((sum, block) => sum + block.split('\n').filter(line => line).length, 0), 0) ===
+        output.split('\n').filter(line => line).length);
+
+    // A config change reruns only the changed check, narrowed without the compiler warnings
+    const cache = new CheckResultCache();
+    cache.record('unit', mapping, enabled, { stdout: output, stderr: '', exitCode: 1, duration: 100 });
+    const narrowed = output.split('\n').slice(3, 7).join('\n') + '\n';
+    const rerun = cache.record('unit', changedOption, ['readability-identifier-naming'], { stdout: narrowed, stderr: '', exitCode: 0, duration: 40 });
+    check('compiler warnings of the full run survive a narrowed rerun',
+        rerun.stdout.includes("unused variable 'y'") && rerun.stdout.includes("unknown type name 'foo'"));
+    const hit = cache.lookup('unit', changedOption).result;
+    check('the cache keeps them too', !!hit && hit.stdout.includes("unused variable 'y'") && hit.stdout.includes('x.size()'));
+
+    console.log(`\n${failures === 0 ? 'All checks passed' : `${failures} checks failed`}`);
+    process.exit(failures === 0 ? 0 : 1);
+}
+
+// Run the test
+runTest();
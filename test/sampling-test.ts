@@ -0,0 +1,85 @@
+// Test script to verify Sampling extrapolates a stratified sample to the expected totals
+import { SamplePlan, Sampling } from '../src/core/engine/Sampling';
+import { ClangTidyDiagnostic } from '../src/types';
+
+// Two strata: src/a samples 2 of 4 files, src/b all 3 of its files
+const plan: SamplePlan = {
+    root: '/r',
+    fraction: 0.5,
+    sampledCost: 5,
+    totalCost: 7,
+    strata: [
+        { name: 'src/a', files: ['/r/src/a/1.cpp', '/r/src/a/2.cpp', '/r/src/a/3.cpp', '/r/src/a/4.cpp'], sampled: ['/r/src/a/1.cpp', '/r/src/a/2.cpp'] },
+        { name: 'src/b', files: ['/r/src/b/1.cpp', '/r/src/b/2.cpp', '/r/src/b/3.cpp'], sampled: ['/r/src/b/1.cpp', '/r/src/b/2.cpp', '/r/src/b/3.cpp'] }
+    ]
+};
+
+function diagnostics(filePath: string, checkName: string, count: number): ClangTidyDiagnostic[] {
+    return Array.from({ length: count }, (_, index) => ({
+        filePath,
+        line: index + 1,
+        column: 1,
+        severity: 'warning',
+        checkName,
+        message: 'message'
+    } as ClangTidyDiagnostic));
+}
+
+let failures = 0;
+
+function check(description: string, condition: boolean): void {
+    console.log(`${condition ? '✓' : '✗'} ${description}`);
+    if (!condition) {
+        failures++;
+    }
+}
+
+function runTest(): void {
+    console.log('Testing Sampling.estimate...');
+
+    const summary = Sampling.estimate(plan, [
+        ...diagnostics('/r/src/a/1.cpp', 'bugprone-x', 2),
+        ...diagnostics('/r/src/a/2.cpp', 'bugprone-x', 3),
+        ...diagnostics('/r/src/a/2.cpp', 'readability-y', 1),
+        ...diagnostics('/r/src/b/1.cpp', 'bugprone-x', 1),
+        ...diagnostics('/r/src/b/2.cpp', 'bugprone-x', 1),
+        ...diagnostics('/r/src/b/3.cpp', 'readability-y', 1),
+        ...diagnostics('/r/include/a.h', 'bugprone-x', 4)
+    ]);
+    console.log(`  total: ${JSON.stringify(summary.total)}`);
+
+    // src/a: values 2 and 4, mean 3, s² 2, estimate 4 * 3 = 12, variance 4² * (1 - 2/4) * 2 / 2 = 8
+    // src/b: fully sampled, estimate 3 with no variance
+    // total 15 ± 1.96 * √8 = 15 ± 5.54, never below the 9 observed
+    check('the total is the sum of the stratum expansions', summary.total.observed === 9 && summary.total.estimate === 15);
+    check('the confidence interval comes from the sampled strata only', summary.total.low === 9 && summary.total.high === 21);
+
+    const a = summary.byDirectory.find(row => row.name === 'src/a');
+    const b = summary.byDirectory.find(row => row.name === 'src/b');
+    check('a partly sampled directory is extrapolated', !!a && a.observed === 6 && a.estimate === 12 && a.low === 6 && a.high === 18);
+    check('a fully sampled directory is exact', !!b && b.observed === 3 && b.estimate === 3 && b.low === 3 && b.high === 3);
+
+    // bugprone-x: src/a values 2 and 3 (mean 2.5, s² 0.5, estimate 10, variance 2), src/b exact 2; 12 ± 2.77
+    const bugprone = summary.byCheck.find(row => row.name === 'bugprone-x');
+    check('checks are extrapolated on their own', !!bugprone && bugprone.observed === 7 && bugprone.estimate === 12 &&
+        bugprone.low === 9 && bugprone.high === 15);
+
+    check('header findings are counted but not extrapolated', summary.headerDiagnostics === 4);
+    check('file counts come from the plan', summary.sampledFiles === 5 && summary.totalFiles === 7);
+    check('the cost share is the sampled share of the estimated cost', Math.abs(summary.costShare - 5 / 7) < 1e-9);
+
+    // 40 directories of 5 files and one of 800: the 80 forced files come out of a 10% budget of 100
+    const files = [
+        ...Array.from({ length: 200 }, (_, index) => `/r/m${index % 40}/x/${index}.cpp`),
+        ...Array.from({ length: 800 }, (_, index) => `/r/big/x/${index}.cpp`)
+    ];
+    const selected = Sampling.select(files, '/r', 0.1, () => 1);
+    check('minimum stratum sizes are part of the budget', Sampling.files(selected).length === 100 &&
+        selected.strata.find(stratum => stratum.name === 'big/x')!.sampled.length === 20);
+
+    console.log(`\n${failures === 0 ? 'All checks passed' : `${failures} checks failed`}`);
+    process.exit(failures === 0 ? 0 : 1);
+}
+
+// Run the test
+runTest();
@@ -0,0 +1,87 @@
+// Test script to verify UnityBuilder keeps sources that cannot share a translation unit apart
+import { UnityBuilder } from '../src/core/compiledb/UnityBuilder';
+
+const plainSource = `#include "widget.h"
+#include <string>
+
+namespace ui {
+
+static int instances = 0;
+static const std::string kDefaultName = "widget";
+static std::vector<int> sizes{1, 2, 3};
+static char buffer[64];
+
+static void track(Widget *widget) {
+  instances++;
+}
+
+class Registry {
+  static int count;
+  static Registry &instance();
+};
+
+static_assert(sizeof(int) == 4, "int is 32 bits");
+
+Widget::Widget() { track(this); }
+
+}  // namespace ui
+`;
+
+const anonymousNamespace = `#include "parser.h"
+
+namespace {
+int depth = 0;
+}  // namespace
+
+int parse() { return depth; }
+`;
+
+const usingDirective = `#include <vector>
+using namespace std;
+
+vector<int> values;
+`;
+
+const macroDefinition = `#include "config.h"
+#define MAX_ITEMS 16
+
+int items[MAX_ITEMS];
+`;
+
+const namedNamespace = `namespace detail {
+int helper() { return 1; }
+}
+using std::string;
+`;
+
+let failures = 0;
+
+function check(description: string, condition: boolean): void {
+    console.log(`${condition ? '✓' : '✗'} ${description}`);
+    if (!condition) {
+        failures++;
+    }
+}
+
+function runTest(): void {
+    console.log('Testing UnityBuilder...');
+
+    check('a plain source has no hazard', UnityBuilder.findHazard(plainSource) === null);
+    check('an anonymous namespace is a hazard', UnityBuilder.findHazard(anonymousNamespace) === 'anonymous namespace');
+    check('a using-directive is a hazard', UnityBuilder.findHazard(usingDirective) === 'using-directive');
+    check('a macro definition is a hazard', UnityBuilder.findHazard(macroDefinition) === 'macro definition');
+    check('named namespaces and using-declarations are no hazard', UnityBuilder.findHazard(namedNamespace) === null);
+
+    const names = UnityBuilder.staticNames(plainSource);
+    console.log(`  static names: ${names.join(', ')}`);
+    check('static variables, arrays and functions are found',
+        JSON.stringify(names) === JSON.stringify(['instances', 'kDefaultName', 'sizes', 'buffer', 'track']));
+    check('static class members and static_assert are not file-scope statics',
+        !names.includes('count') && !names.includes('instance') && !names.includes('static_assert'));
+
+    console.log(`\n${failures === 0 ? 'All checks passed' : `${failures} checks failed`}`);
+    process.exit(failures === 0 ? 0 : 1);
+}
+
+// Run the test
+runTest();